@@ -33,12 +33,27 @@
  *                                       I N C L U D E S
  *
  **************************************************************************************************/
+/*Needed for memfd_create, the seals of the anonymous shared memory segment, and sched_getcpu*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /*_GNU_SOURCE*/
+
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 
 #include "flouka.h"
+#include "flouka_inline.h"
+#include "flouka_shm.h"
+#include "flouka_index.h"
 
 /***************************************************************************************************
  *
@@ -52,6 +67,71 @@
 #define FLOUKA_COUNTER_MAXIMUM_VALUE      (0xFFFFFFFFLU)
 #define FLOUKA_COUNTER_MINIMUM_VALUE      (0x0LU)
 
+/*These macros are the reasons for which the inline functions have to call the library functions.*/
+#define FLOUKA_SLOW_PATH_SHARDED          (0x00000001LU)
+#define FLOUKA_SLOW_PATH_ATOMIC           (0x00000002LU)
+#define FLOUKA_SLOW_PATH_DEFERRED         (0x00000004LU)
+#define FLOUKA_SLOW_PATH_PLACED           (0x00000008LU)
+
+/*This macro marks a slot of a deferred table that is not used by any counter yet.*/
+#define FLOUKA_DEFERRED_SLOT_EMPTY        (0xFFFFFFFFLU)
+
+/*These macros identify the file the counters are persisted to, the version is changed whenever the
+  layout of the file is changed.*/
+#define FLOUKA_PERSISTENT_MAGIC           (0x464C4B50LU)
+#define FLOUKA_PERSISTENT_VERSION         (1)
+
+/*These macros are the parameters of the FNV-1a hash used for the keys of the persisted counters.*/
+#define FLOUKA_KEY_OFFSET_BASIS           (0x811C9DC5LU)
+#define FLOUKA_KEY_PRIME                  (0x01000193LU)
+
+/*These macros are the multipliers of the finalizer of MurmurHash3 (fmix64) used to hash the sparse
+  IDs of the counters.*/
+#define FLOUKA_SPARSE_HASH_MULTIPLIER1    (0xFF51AFD7ED558CCDLLU)
+#define FLOUKA_SPARSE_HASH_MULTIPLIER2    (0xC4CEB9FE1A85EC53LLU)
+
+/*These macros are the size of a chunk of the string store (a longer string gets a chunk of its
+  own), and the initial number of buckets of its hash table (a power of two, doubled whenever
+  there are more strings than buckets).*/
+#ifndef FLOUKA_STRING_CHUNK_SIZE
+#define FLOUKA_STRING_CHUNK_SIZE          (4096)
+#endif /*FLOUKA_STRING_CHUNK_SIZE*/
+#define FLOUKA_STRING_BUCKETS_COUNT       (64)
+
+/*Size of the huge pages the arena is rounded up to (the default huge page size of the common
+  64-bit platforms).*/
+#ifndef FLOUKA_HUGE_PAGE_SIZE
+#define FLOUKA_HUGE_PAGE_SIZE             (0x200000LU)
+#endif /*FLOUKA_HUGE_PAGE_SIZE*/
+
+/*These macros are used to find the NUMA nodes, and the node of every CPU, from the files of the
+  system, a list (ex. "0-3,8-11") is expected to fit in FLOUKA_NUMA_LIST_SIZE characters.*/
+#define FLOUKA_NUMA_ONLINE_NODES_PATH     "/sys/devices/system/node/online"
+#define FLOUKA_NUMA_NODE_CPUS_PATH        "/sys/devices/system/node/node%lu/cpulist"
+#define FLOUKA_NUMA_LIST_SIZE             (1024)
+#define FLOUKA_NUMA_PATH_SIZE             (64)
+
+/*These macros are the memory policy (of mbind) the shard of every node is bound to, the node is
+  preferred (the memory of the other nodes is used when it is full), and the pages already touched
+  are moved to it, the nodes beyond FLOUKA_NUMA_MAXIMUM_NODES are not bound.*/
+#define FLOUKA_NUMA_MPOL_PREFERRED        (1)
+#define FLOUKA_NUMA_MPOL_MF_MOVE          (1 << 1)
+#define FLOUKA_NUMA_MAXIMUM_NODES         (1024)
+
+/*The anonymous shared memory segment cannot be resized, and (on the kernels that support it) it
+  cannot be mapped for writing again, so that the readers it is passed to can only read it.*/
+#define FLOUKA_SHARED_MEMORY_SEALS        (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+#ifdef F_SEAL_FUTURE_WRITE
+#define FLOUKA_SHARED_MEMORY_WRITE_SEAL   (F_SEAL_FUTURE_WRITE)
+#else
+#define FLOUKA_SHARED_MEMORY_WRITE_SEAL   (0)
+#endif /*F_SEAL_FUTURE_WRITE*/
+
+/*The anonymous shared memory segment is opened again through this path (read only), so that the
+  descriptor passed to the readers never allows writing, with or without the write seal.*/
+#define FLOUKA_SHARED_MEMORY_REOPEN_PATH  "/proc/self/fd/%d"
+#define FLOUKA_SHARED_MEMORY_PATH_SIZE    (64)
+
 
 /**************************************************************************************************/
 #define FLOUKA_ENCODE_PARAMETER(dest_Ptr, param)                                                   \
@@ -151,8 +231,12 @@ typedef struct flouka_StatisticsCounterInfo
     const char* counterName_Ptr;
     /*String representing the counter description*/
     const char* counterDescription_Ptr;
+    /*The family whose instances use this counter (see flouka_assignFamily), FLOUKA_UNASSIGNED_ID if
+      the counter is not reserved by a family*/
+    uint32 familyID;
 #ifdef DEBUG
-    /*Indicates whether the counter has been assigned or not*/
+    /*Indicates whether the counter has been assigned or not (for the counters of a family, whether
+      the instance using it is added)*/
     bool isAssigned;
 #endif /*DEBUG*/
 } flouka_StatisticsCounterInfo_s;
@@ -195,6 +279,231 @@ typedef struct flouka_StatisticsInformation
     flouka_StatisticsCounterInfo_s* counterInfoList_Ptr;
 } flouka_StatisticsInformation_s;
 
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_DeferredSlot_s
+ *
+ * Structure Description:
+ * This structure holds the updates of one counter that are accumulated by a thread in its deferred
+ * table, the part of them not yet added to the shared counters is the difference between the total
+ * and the flushed sum (modulo the counter size).
+ **************************************************************************************************/
+typedef struct flouka_DeferredSlot
+{
+    /*Holds the ID of the counter using the slot, FLOUKA_DEFERRED_SLOT_EMPTY if not used yet*/
+    uint32 counterID;
+    /*Holds the sum of all the updates accumulated in the slot (decrements are added as two's
+      complement), it is never reset, and it is only written by the owner thread*/
+    uint32 total;
+    /*Holds the value of the total when the slot was last moved to the shared counters, it is only
+      written while the busy flag of the table is held*/
+    uint32 flushed;
+} flouka_DeferredSlot_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_DeferredBuffer_s
+ *
+ * Structure Description:
+ * This structure represents the deferred table of one thread, the table is direct mapped (the slot
+ * of a counter is its ID modulo the table size), and when two counters map to the same slot the
+ * old one is added to the shared counters before the slot is given to the new one.
+ *
+ * Only the owner thread changes the counter ID and the total of a slot, while the flushed sum is
+ * advanced by whoever moves the slot to the shared counters, the busy flag is held while moving
+ * the slots so that a delta is never added to a counter that no longer owns the slot.
+ **************************************************************************************************/
+typedef struct flouka_DeferredBuffer
+{
+    /*Points to the deferred table of the next thread*/
+    struct flouka_DeferredBuffer* next_Ptr;
+    /*Identifies the owner thread (the address of its thread local token)*/
+    const void* owner_Ptr;
+    /*Set while the deltas of the table are being moved to the shared counters*/
+    uint8 isBusy;
+    /*Points to the list of slots, it is cache line aligned and follows this structure in memory*/
+    flouka_DeferredSlot_s* slotList_Ptr;
+} flouka_DeferredBuffer_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_NodeUpdates_s
+ *
+ * Structure Description:
+ * This structure holds the number of updates one thread did on every NUMA node, only the owner
+ * thread changes it (without a read-modify-write), and the numbers of all the threads are summed
+ * by flouka_getNodeUpdates.
+ **************************************************************************************************/
+typedef struct flouka_NodeUpdates
+{
+    /*Points to the numbers of the next thread*/
+    struct flouka_NodeUpdates* next_Ptr;
+    /*Identifies the owner thread (the address of its thread local token)*/
+    const void* owner_Ptr;
+    /*Points to the number of updates of every node, it is cache line aligned and follows this
+      structure in memory*/
+    uint32* updatesList_Ptr;
+} flouka_NodeUpdates_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_RetiredList_s
+ *
+ * Structure Description:
+ * This structure keeps an information list that was replaced by a bigger one when the object grew,
+ * or a cache that was dropped by a schema change, the updates read the information lists without
+ * the lock (ex. the DEBUG checks of the counters), and the caches are returned to the callers
+ * (ex. the statistics server), so the replaced lists are only released when the object is
+ * destroyed.
+ **************************************************************************************************/
+typedef struct flouka_RetiredList
+{
+    /*Points to the list retired before this one*/
+    struct flouka_RetiredList* next_Ptr;
+    /*Points to the replaced list*/
+    void* list_Ptr;
+} flouka_RetiredList_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_Snapshot_s
+ *
+ * Structure Description:
+ * This structure holds one of the two buffers the snapshots of the statistics are taken into.
+ **************************************************************************************************/
+typedef struct flouka_Snapshot
+{
+    /*Points to the copy of the counters, it is allocated when the first snapshot is taken into it*/
+    uint32* counterValuesList_Ptr;
+    /*Holds the number of counters the copy can hold, it is allocated again if the object grows*/
+    uint32 countersCount;
+    /*Describes the copy of the counters*/
+    flouka_snapshotInfo_s info;
+} flouka_Snapshot_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_PersistentHeader_s
+ *
+ * Structure Description:
+ * This structure is found at the start of the file the counters are persisted to, it is followed
+ * by the key of every counter ID (zero if the ID was never assigned), and then by the counters
+ * shards laid out exactly as in memory (both lists start at a cache line boundary).
+ *
+ * The file is used as is on the next initialization only if it was created with the same layout
+ * (all the fields below), otherwise it is cleared, and the value of every counter is kept only if
+ * it is assigned the same key (sub group, unit, name, and location) as the one persisted with it.
+ **************************************************************************************************/
+typedef struct flouka_PersistentHeader
+{
+    /*Holds FLOUKA_PERSISTENT_MAGIC*/
+    uint32 magic;
+    /*Holds FLOUKA_PERSISTENT_VERSION*/
+    uint32 version;
+    /*Holds the size of the whole file in bytes*/
+    uint32 fileSize;
+    /*Holds the number of counters*/
+    uint32 totalCountersCount;
+    /*Holds the number of shards*/
+    uint32 shardsCount;
+    /*Holds the distance (in counters) between two consecutive shards*/
+    uint32 shardStride;
+    /*Holds the offset of the list of keys from the start of the file*/
+    uint32 keysOffset;
+    /*Holds the offset of the first shard from the start of the file*/
+    uint32 countersOffset;
+} flouka_PersistentHeader_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_SparseCounter_s
+ *
+ * Structure Description:
+ * This structure maps the sparse ID of a counter (see flouka_assignSparseCounter) to its counter ID,
+ * it is an entry of the open addressing table built by flouka_freezeSparseCounters.
+ **************************************************************************************************/
+typedef struct flouka_SparseCounter
+{
+    /*Holds the sparse ID given by the user*/
+    uint64 sparseID;
+    /*Holds the counter ID given to the sparse ID, FLOUKA_UNASSIGNED_ID if the entry is empty*/
+    uint32 counterID;
+} flouka_SparseCounter_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_InternedString_s
+ *
+ * Structure Description:
+ * This structure is the header of a string of the string store (see StringStore_intern), the
+ * string itself (null terminated) follows it in memory, every distinct string is stored once, so
+ * that two interned strings are equal only if their pointers are equal.
+ **************************************************************************************************/
+typedef struct flouka_InternedString
+{
+    /*Points to the next string of the same bucket of the hash table*/
+    struct flouka_InternedString* next_Ptr;
+    /*Holds the hash of the string*/
+    uint32 hash;
+    /*Holds the length of the string, without the terminating null*/
+    uint32 length;
+    /*Holds the offset of the string in the string table of the indexed information being built,
+      FLOUKA_UNASSIGNED_ID if it is not used by it*/
+    uint32 tableOffset;
+} flouka_InternedString_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_StringChunk_s
+ *
+ * Structure Description:
+ * This structure is the header of a chunk of the string store, the interned strings are packed
+ * after it, and a chunk is never moved or released before the object is destroyed.
+ **************************************************************************************************/
+typedef struct flouka_StringChunk
+{
+    /*Points to the previous chunk*/
+    struct flouka_StringChunk* next_Ptr;
+    /*Holds the size of the chunk in bytes, including this header*/
+    uint32 size;
+    /*Holds the number of bytes used, including this header*/
+    uint32 usedSize;
+} flouka_StringChunk_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_CounterFamily_s
+ *
+ * Structure Description:
+ * This structure holds a counter family (see flouka_assignFamily), the members are described once,
+ * and every instance of the family takes a slot of the range of counters reserved for the family,
+ * which is the members counters of the instance, the free slots are kept in a stack so that the
+ * slot of a removed instance is the first to be reused.
+ **************************************************************************************************/
+typedef struct flouka_CounterFamily
+{
+    /*The group of the family, FLOUKA_UNASSIGNED_ID if the family is not assigned*/
+    uint32 groupID;
+    /*String representing the family name*/
+    const char* familyName_Ptr;
+    /*String representing the family description*/
+    const char* familyDescription_Ptr;
+    /*Holds the first counter ID of the range reserved for the family*/
+    uint32 firstCounterID;
+    /*Holds the number of counters of every instance*/
+    uint32 membersCount;
+    /*Holds the number of instances (slots) of the family*/
+    uint32 instancesCount;
+    /*Points to the description of every member, the counter ID of a member is its index*/
+    flouka_StatisticsCounterInfo_s* memberInfoList_Ptr;
+    /*Points to the copy of the label of every slot, NULL if the slot is free*/
+    char** labelList_Ptr;
+    /*Points to the stack of the free slots*/
+    uint32* freeSlotList_Ptr;
+    /*Holds the number of the free slots*/
+    uint32 freeSlotsCount;
+} flouka_CounterFamily_s;
+
 /***************************************************************************************************
  * Structure Name:
  * flouka_s
@@ -205,27 +514,201 @@ typedef struct flouka_StatisticsInformation
  **************************************************************************************************/
 struct flouka
 {
+    /*Holds the list of counters (the first shard when the counters are sharded), it must be the
+      first member, so that the inline functions of flouka_inline.h can access it*/
+    flouka_fastPath_s fastPath;
     /*Holds the meta data related to the statistics counters*/
     flouka_StatisticsInformation_s information;
+    /*Points to the function that will be used to allocate the deferred tables of the threads*/
+    AllocFuncPtr allocationFunction_Ptr;
     /*Points to the function that will be used to release the allocated memory*/
     DeallocFuncPtr deallocationFunction_Ptr;
-    /*Used to protect the object from multiple access during group/counter assignment only*/
+    /*Used to protect the object from multiple access during group/counter assignment, and when a
+      thread creates its deferred table*/
     LockFuncPtr lockFunction_Ptr;
-    /*Used to protect the object from multiple access during group/counter assignment only*/
+    /*Used to protect the object from multiple access during group/counter assignment, and when a
+      thread creates its deferred table*/
     UnlockFuncPtr unlockFunction_Ptr;
-    /*points to the list of counters*/
-    uint32* counterValuesList_Ptr;
+    /*Points to the memory returned by the allocation function for the counters, the list of
+      counters is aligned to the cache line inside it*/
+    void* counterValuesAllocation_Ptr;
+    /*Holds the number of private copies (shards) of the counters list*/
+    uint32 shardsCount;
+    /*Holds the number of shards the threads are spread over, it is the number of shards unless the
+      snapshots are consistent, in which case the shards are split in two halves (one per epoch)*/
+    uint32 epochShardsCount;
+    /*Holds the epoch of the updates, the updates go to the half of the shards of the current
+      epoch (its lowest bit), every consistent snapshot advances it*/
+    uint32 snapshotEpoch;
+    /*Points to the number of updates in progress in every epoch, for every shard of a half (on a
+      cache line of its own), NULL unless the snapshots are consistent*/
+    uint32* epochWritersList_Ptr;
+    /*Holds the distance (in counters) between two consecutive shards, it is cache line aligned so
+      that no two shards share a cache line*/
+    uint32 shardStride;
+    /*Maps every counter ID to the location of its value inside a shard, NULL if the counters are
+      laid out by their IDs (no placement options), unassigned counters map to the last location*/
+    uint32* counterSlotList_Ptr;
+    /*Holds the next free location of the cold counters, they are packed from the start of a shard*/
+    uint32 nextColdSlot;
+    /*Holds the last cache line given to a hot counter or an owner, lines are taken from the end
+      of a shard towards the cold counters*/
+    uint32 lastPlacedLine;
+    /*Holds the number of cache lines that are reserved for the cold counters*/
+    uint32 coldLinesCount;
+    /*Holds the number of owners that counters can be assigned to*/
+    uint32 ownersCount;
+    /*Holds the next free location in the current cache line of every owner, zero if none*/
+    uint32* ownerNextSlotList_Ptr;
+    /*Returns the shard of the calling thread, NULL means round robin assignment per thread*/
+    ShardIndexFuncPtr shardIndexFunction_Ptr;
+    /*Indicates whether the counters are updated using atomic operations*/
+    bool isAtomic;
+    /*Holds the number of slots of every deferred table, zero if the updates are not deferred*/
+    uint32 deferredSlotsCount;
+    /*Points to the list of the deferred tables of all the threads that updated the counters*/
+    flouka_DeferredBuffer_s* deferredBufferList_Ptr;
+    /*Identifies this object among all the objects created by the process, it is used to tell a
+      destroyed object from a new one allocated at the same address*/
+    uint32 instanceSerial;
+    /*Points to the buffer returned by flouka_getStatistics, it is the list of counters itself unless
+      the counters are sharded, in which case the shards are summed into it*/
+    uint32* statisticsBuffer_Ptr;
+    /*Points to the serialized information (with its length header), NULL until it is requested
+      after the last group/sub group/counter assignment*/
+    uint8* informationCache_Ptr;
+    /*Holds the size of the serialized information in bytes, including the length header*/
+    uint32 informationCacheSize;
+    /*Points to the indexed information (see flouka_index.h), NULL until it is requested after the
+      last group/sub group/counter assignment*/
+    uint8* indexCache_Ptr;
+    /*Holds the size of the indexed information in bytes*/
+    uint32 indexCacheSize;
+    /*Points to the counters of every group and sub group (see MembershipIndex_build), NULL until it
+      is requested after the last group/sub group/counter assignment*/
+    uint32* membershipIndex_Ptr;
+    /*Incremented by one on every group/sub group/counter assignment*/
+    uint32 schemaGeneration;
+    /*Points to the shared memory segment the counters are exported to, NULL if not exported*/
+    flouka_sharedMemoryHeader_s* sharedMemory_Ptr;
+    /*Holds the name of the shared memory segment, it is removed when the object is destroyed*/
+    const char* sharedMemoryName_Ptr;
+    /*TRUE if the shared memory segment has no name (memfd)*/
+    bool isSharedMemoryAnonymous;
+    /*Holds a read only descriptor of the shared memory segment, -1 if there is none*/
+    int32 sharedMemoryDescriptor;
+    /*Points to the mapped file the counters are persisted to, NULL if they are not persisted*/
+    flouka_PersistentHeader_s* persistentHeader_Ptr;
+    /*Holds the two buffers used alternately by flouka_getSnapshot*/
+    flouka_Snapshot_s snapshotList[2];
+    /*Holds the number of snapshots taken so far*/
+    uint32 snapshotsCount;
     /*Holds the total number of supported groups*/
     uint32 totalGroupsCount;
     /*Holds the total number of supported sub groups*/
     uint32 totalSubGroupsCount;
     /*Holds the total number of supported counters*/
     uint32 totalCountersCount;
+    /*Holds the number of groups, sub groups and counters the information lists can hold, they are
+      allocated again (under the lock of the object) when the object grows beyond them*/
+    uint32 groupsCapacity;
+    uint32 subGroupsCapacity;
+    uint32 countersCapacity;
+    /*Points to the lists replaced when the object grew, they are released by flouka_destroy*/
+    flouka_RetiredList_s* retiredListList_Ptr;
+    /*Holds the number of counters the object may grow to (see flouka_grow)*/
+    uint32 maximumCountersCount;
+    /*Points to the memory reserved for the counters when the object may grow, NULL otherwise, the
+      counters list is the start of it*/
+    void* counterValuesReservation_Ptr;
+    /*Holds the size of the reserved memory in bytes*/
+    size_t counterValuesReservationSize;
+    /*Holds the number of counters (of every shard) whose reserved memory is committed*/
+    uint32 committedCountersCount;
+    /*Holds the number of counters in one segment (a page) of the reserved memory, the memory is
+      committed one segment at a time*/
+    uint32 segmentCountersCount;
+    /*Points to the arena the object, its information lists, and its counters are allocated from
+      (see the isArenaAllocated option), NULL if they are allocated by the allocation function*/
+    uint8* arena_Ptr;
+    /*Holds the size of the arena in bytes*/
+    size_t arenaSize;
+    /*Points to the node of every CPU (indexed by the CPU number) in the NUMA mode, NULL otherwise,
+      the shard of a thread is the node of the CPU it runs on*/
+    uint32* cpuNodeList_Ptr;
+    /*Holds the number of CPUs in the list*/
+    uint32 cpusCount;
+    /*Points to the list of the numbers of updates of every node, one per thread that updated the
+      counters in the NUMA mode*/
+    flouka_NodeUpdates_s* nodeUpdatesList_Ptr;
+    /*Identifies the owner thread (the address of its thread local token) of every private shard,
+      all the shards but the last one are private when they are given in round robin fashion (no
+      shard function), NULL otherwise*/
+    const void** shardOwnerList_Ptr;
+    /*Holds the number of private shards claimed (it may exceed the number of private shards)*/
+    uint32 shardOwnersCount;
+    /*Points to the counters assigned by their sparse IDs (in the order of their assignment) until
+      they are frozen, NULL after that*/
+    flouka_SparseCounter_s* sparseCounterList_Ptr;
+    /*Holds the number of counters in the list, and the number of counters it can hold*/
+    uint32 sparseCountersCount;
+    uint32 sparseCountersCapacity;
+    /*Holds the next counter ID to try for a sparse ID, the IDs below it are all taken*/
+    uint32 nextSparseCounterID;
+    /*Points to the open addressing table of the sparse IDs (a power of two entries, at most half
+      full), NULL until the sparse IDs are frozen, it never changes after that*/
+    flouka_SparseCounter_s* sparseTable_Ptr;
+    /*Holds the number of entries of the table minus one*/
+    uint32 sparseTableMask;
+    /*Points to the list of counter families (indexed by the family ID)*/
+    flouka_CounterFamily_s* familyList_Ptr;
+    /*Holds the number of families (the highest assigned family ID plus one), and the number of
+      families the list can hold*/
+    uint32 familiesCount;
+    uint32 familiesCapacity;
+    /*Points to the last chunk of the string store, the names, units and descriptions given by the
+      user are interned in it (see StringStore_intern)*/
+    flouka_StringChunk_s* stringChunkList_Ptr;
+    /*Points to the hash table of the interned strings (the first string of every bucket)*/
+    flouka_InternedString_s** stringBucketList_Ptr;
+    /*Holds the number of buckets of the hash table minus one*/
+    uint32 stringBucketsMask;
+    /*Holds the number of interned strings*/
+    uint32 stringsCount;
+    /*Points to the interned empty string, it describes the IDs that are not assigned yet*/
+    const char* emptyString_Ptr;
 #ifdef DEBUG
     uint32 initializationPattern;
 #endif /**/
 };
 
+/***************************************************************************************************
+ *
+ *                                      V A R I A B L E S
+ *
+ **************************************************************************************************/
+
+/*Holds the serial given to the last created object*/
+STATIC uint32 g_flouka_lastInstanceSerial = 0;
+
+/*Its address identifies the calling thread as the owner of a deferred table*/
+STATIC __thread uint8 g_flouka_threadToken = 0;
+
+/*Caches the deferred table of the calling thread for the last object it updated*/
+STATIC __thread flouka_s* g_flouka_cachedDeferredOwner_Ptr = NULL;
+STATIC __thread uint32 g_flouka_cachedDeferredSerial = 0;
+STATIC __thread flouka_DeferredBuffer_s* g_flouka_cachedDeferredBuffer_Ptr = NULL;
+
+/*Caches the numbers of updates of the calling thread for the last object it updated (NUMA mode)*/
+STATIC __thread flouka_s* g_flouka_cachedNodeUpdatesOwner_Ptr = NULL;
+STATIC __thread uint32 g_flouka_cachedNodeUpdatesSerial = 0;
+STATIC __thread flouka_NodeUpdates_s* g_flouka_cachedNodeUpdates_Ptr = NULL;
+
+/*Caches the shard of the calling thread for the last object it updated (round robin shards)*/
+STATIC __thread flouka_s* g_flouka_cachedThreadShardOwner_Ptr = NULL;
+STATIC __thread uint32 g_flouka_cachedThreadShardSerial = 0;
+STATIC __thread uint32 g_flouka_cachedThreadShardIndex = 0;
+
 /***************************************************************************************************
  *
  *                      I N T E R N A L   F U N C T I O N   D E F I N I T I O N S
@@ -343,11 +826,11 @@ uint32 StatisticsCounterInfo_getSerializedSize(flouka_StatisticsCounterInfo_s* c
     return (serializedSize);
 }
 
-void StatisticsInformation_serialize(flouka_StatisticsInformation_s* statisticsInfo_Ptr,
-                                     uint8* serializationBuffer_Ptr,
-                                     uint32 maxGroupsCount,
-                                     uint32 maxSubGroupsCount,
-                                     uint32 maxCountersCount)
+uint8* StatisticsInformation_serialize(flouka_StatisticsInformation_s* statisticsInfo_Ptr,
+                                       uint8* serializationBuffer_Ptr,
+                                       uint32 maxGroupsCount,
+                                       uint32 maxSubGroupsCount,
+                                       uint32 maxCountersCount)
 {
 
     uint32 i;
@@ -374,6 +857,8 @@ void StatisticsInformation_serialize(flouka_StatisticsInformation_s* statisticsI
                         = StatisticsCounterInfo_serialize(&(statisticsInfo_Ptr->counterInfoList_Ptr[i]),
                                                           serializationBuffer_Ptr);
     }
+
+    return (serializationBuffer_Ptr);
 }
 
 uint32 StatisticsInformation_getSerializedSize(flouka_StatisticsInformation_s* statisticsInfo_Ptr,
@@ -408,227 +893,4180 @@ uint32 StatisticsInformation_getSerializedSize(flouka_StatisticsInformation_s* s
     return (serializedSize);
 }
 
-/***************************************************************************************************
- *
- *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
- *
- **************************************************************************************************/
-
-flouka_status_e flouka_init(flouka_s** flouka_Pointer_Ptr,
-                            uint32 totalGroupsCount,
-                            uint32 totalSubGroupsCount,
-                            uint32 totalCountersCount,
-                            AllocFuncPtr allocationFunction_Ptr,
-                            DeallocFuncPtr deallocationFunction_Ptr,
-                            LockFuncPtr lockFunction_Ptr,
-                            UnlockFuncPtr unlockFunction_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+STATIC uint8* CounterFamily_serialize(flouka_CounterFamily_s* family_Ptr,
+                                      uint32 familyID,
+                                      uint8* serializationBuffer_Ptr)
 {
     uint32 i;
-    flouka_s* flouka_Ptr;
-    flouka_status_e status;
-
-    status = FLOUKA_STATUS_SUCCESS;
-    /*
-     * Assertions done in this function:
-     * =================================
-     * 1. Validate the flouka_Ptr (Must be NULL).
-     * 2. Validate the number of groups (non-zero).
-     * 3. Validate the number of sub groups (non-zero).
-     * 4. Validate the number of counters (non-zero).
-     * 5. Validate the allocation function pointer (not NULL).
-     * 6. Validate the deallocation function pointer (not NULL).
-     * 7. Validate the lock function pointer (not NULL).
-     * 8. Validate the unlock function pointer (not NULL).
-     */
-    ASSERT((NULL == *flouka_Pointer_Ptr),
-                    "FLOUKA:  *flouka_Ptr pointer is not NULL, it is expected to initialize a NULL pointer",
-                    fileName,
-                    lineNumber);
-    ASSERT((totalGroupsCount> 0),
-                    "FLOUKA:  Total number of groups cannot be zero",
-                    fileName,
-                    lineNumber);
-    ASSERT((totalSubGroupsCount> 0),
-                    "FLOUKA:  Total number of sub groups cannot be zero",
-                    fileName,
-                    lineNumber);
-    ASSERT((totalCountersCount> 0),
-                    "FLOUKA:  Total number of counters cannot be zero",
-                    fileName,
-                    lineNumber);
-    ASSERT((NULL != allocationFunction_Ptr),
-                    "FLOUKA:  allocation function cannot be NULL",
-                    fileName,
-                    lineNumber);
-    ASSERT((NULL != deallocationFunction_Ptr),
-                    "FLOUKA:  deallocation function cannot be NULL",
-                    fileName,
-                    lineNumber);
-    ASSERT((NULL != lockFunction_Ptr),
-                    "FLOUKA:  lock function cannot be NULL",
-                    fileName,
-                    lineNumber);
-    ASSERT((NULL != unlockFunction_Ptr),
-                    "FLOUKA:  unlock function cannot be NULL",
-                    fileName,
-                    lineNumber);
+    uint32 firstCounterID;
+    uint32 addedInstancesCount;
 
     /*
      * Steps done in this function:
      * ============================
-     * 1. Allocate the space needed for the statistics collector object using the given function.
-     * 2. Allocate memory for the internal members.
-     * 3. Save the passed parameters (e.g. totalGroupsCount).
-     * 4. Initialize all groups and counter to not-assigned.
-     *
-     * Note 1:
-     * flouka_Ptr is a double pointer, so that this function can change what it points to, the
-     * reason for this is to hide the details of the internal memory needed from the caller.
-     *
-     * Note 2:
-     * allocationFunction_Ptr was not saved to the object, because it is only used during the
-     * initialization (inside this function), and never used afterwards, unlike the
-     * deallocationFunction_Ptr which is needed during the destroy function.
+     * 1. Encode familyID, groupID, firstCounterID, membersCount, instancesCount, familyName_Ptr
+     *    and familyDescription_Ptr.
+     * 2. Encode the unit, the name and the description of every member.
+     * 3. Encode the number of the added instances, and the first counter ID and the label of every
+     *    added instance (the counter of a member is the first counter ID plus the member index).
+     * 4. Return the new serializationBuffer_Ptr, after advancing it by the size of bytes encoded.
      */
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, familyID);
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, family_Ptr->groupID);
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, family_Ptr->firstCounterID);
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, family_Ptr->membersCount);
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, family_Ptr->instancesCount);
+    FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->familyName_Ptr);
+    FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->familyDescription_Ptr);
 
-    flouka_Ptr = (flouka_s*) allocationFunction_Ptr(sizeof(*flouka_Ptr));
-    flouka_Ptr->information.groupInfoList_Ptr
-                    = (flouka_StatisticsGroupInfo_s*) allocationFunction_Ptr(totalGroupsCount
-                                    * sizeof(*flouka_Ptr->information.groupInfoList_Ptr));
-    flouka_Ptr->information.subgroupInfoList_Ptr
-                    = (flouka_StatisticsSubGroupInfo_s*) allocationFunction_Ptr(totalSubGroupsCount
-                                    * sizeof(*flouka_Ptr->information.subgroupInfoList_Ptr));
-    flouka_Ptr->information.counterInfoList_Ptr
-                    = (flouka_StatisticsCounterInfo_s*) allocationFunction_Ptr(totalCountersCount
-                                    * sizeof(*flouka_Ptr->information.counterInfoList_Ptr));
-    flouka_Ptr->information.sizes.assignedGroupsCount = 0;
-    flouka_Ptr->information.sizes.assignedSubGroupsCount = 0;
-    flouka_Ptr->information.sizes.assignedCountersCount = 0;
-
-    flouka_Ptr->counterValuesList_Ptr = (uint32*) allocationFunction_Ptr(totalCountersCount
-                    * sizeof(*flouka_Ptr->counterValuesList_Ptr));
-    flouka_Ptr->deallocationFunction_Ptr = deallocationFunction_Ptr;
-    flouka_Ptr->lockFunction_Ptr = lockFunction_Ptr;
-    flouka_Ptr->unlockFunction_Ptr = unlockFunction_Ptr;
-    flouka_Ptr->totalGroupsCount = totalGroupsCount;
-    flouka_Ptr->totalSubGroupsCount = totalSubGroupsCount;
-    flouka_Ptr->totalCountersCount = totalCountersCount;
-
-    for(i = 0; i < totalGroupsCount; i++)
+    for(i = 0; i < family_Ptr->membersCount; i++)
     {
-#ifdef DEBUG
-        flouka_Ptr->information.groupInfoList_Ptr[i].isAssigned = FALSE;
-#endif /*DEBUG*/
-        flouka_Ptr->information.groupInfoList_Ptr[i].groupName_Ptr = "";
-        flouka_Ptr->information.groupInfoList_Ptr[i].groupDescription_Ptr = "";
-    } /*for*/
+        FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->memberInfoList_Ptr[i].unit_Ptr);
+        FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->memberInfoList_Ptr[i].counterName_Ptr);
+        FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->memberInfoList_Ptr[i].counterDescription_Ptr);
+    }
 
-    for(i = 0; i < totalSubGroupsCount; i++)
+    addedInstancesCount = family_Ptr->instancesCount - family_Ptr->freeSlotsCount;
+    FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, addedInstancesCount);
+    for(i = 0; i < family_Ptr->instancesCount; i++)
     {
-#ifdef DEBUG
-        flouka_Ptr->information.subgroupInfoList_Ptr[i].isAssigned = FALSE;
-#endif /*DEBUG*/
-        flouka_Ptr->information.subgroupInfoList_Ptr[i].subgroupName_Ptr = "";
-        flouka_Ptr->information.subgroupInfoList_Ptr[i].subgroupDescription_Ptr = "";
-    } /*for*/
+        if(NULL == family_Ptr->labelList_Ptr[i])
+        {
+            continue;
+        }
+        firstCounterID = family_Ptr->firstCounterID + (i * family_Ptr->membersCount);
+        FLOUKA_ENCODE_PARAMETER(serializationBuffer_Ptr, firstCounterID);
+        FLOUKA_ENCODE_STRING (serializationBuffer_Ptr, family_Ptr->labelList_Ptr[i]);
+    }
+
+    return (serializationBuffer_Ptr);
+}
+
+STATIC uint32 CounterFamily_getSerializedSize(flouka_CounterFamily_s* family_Ptr)
+{
+    uint32 i;
+    uint32 serializedSize = 0;
 
-    for(i = 0; i < totalCountersCount; i++)
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Calculate the number of bytes needed to serialize family_Ptr (see CounterFamily_serialize).
+     */
+    serializedSize += sizeof(uint32);
+    serializedSize += sizeof(family_Ptr->groupID);
+    serializedSize += sizeof(family_Ptr->firstCounterID);
+    serializedSize += sizeof(family_Ptr->membersCount);
+    serializedSize += sizeof(family_Ptr->instancesCount);
+    serializedSize += (strlen(family_Ptr->familyName_Ptr) + 1);
+    serializedSize += (strlen(family_Ptr->familyDescription_Ptr) + 1);
+    for(i = 0; i < family_Ptr->membersCount; i++)
     {
-#ifdef DEBUG
-        flouka_Ptr->information.counterInfoList_Ptr[i].isAssigned = FALSE;
-#endif /*DEBUG*/
-        flouka_Ptr->information.counterInfoList_Ptr[i].unit_Ptr = "";
-        flouka_Ptr->information.counterInfoList_Ptr[i].counterName_Ptr = "";
-        flouka_Ptr->information.counterInfoList_Ptr[i].counterDescription_Ptr = "";
-    } /*for*/
-#ifdef DEBUG
-    flouka_Ptr->initializationPattern = FLOUKA_INITIALIZATION_PATTEREN;
-#endif /*DEBUG*/
-    *flouka_Pointer_Ptr = flouka_Ptr;
-    return status;
+        serializedSize += (strlen(family_Ptr->memberInfoList_Ptr[i].unit_Ptr) + 1);
+        serializedSize += (strlen(family_Ptr->memberInfoList_Ptr[i].counterName_Ptr) + 1);
+        serializedSize += (strlen(family_Ptr->memberInfoList_Ptr[i].counterDescription_Ptr) + 1);
+    }
+    serializedSize += sizeof(family_Ptr->instancesCount);
+    for(i = 0; i < family_Ptr->instancesCount; i++)
+    {
+        if(NULL != family_Ptr->labelList_Ptr[i])
+        {
+            serializedSize += sizeof(family_Ptr->firstCounterID);
+            serializedSize += (strlen(family_Ptr->labelList_Ptr[i]) + 1);
+        }
+    }
+    return (serializedSize);
 }
 
-void flouka_destroy(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+STATIC void CounterFamily_clear(flouka_CounterFamily_s* family_Ptr,
+                               const char* emptyString_Ptr)
 {
-    DeallocFuncPtr deallocationFunctionPointer;
     /*
-     * Assertions done in this function:
-     * =================================
-     * 1. Validate the flouka_Ptr (not null).
-     * 2. Validate the flouka_Ptr (already initialized).
+     * Steps done in this function:
+     * ============================
+     * 1. Mark the family as not assigned, it has empty strings, no members and no instances.
      */
-    ASSERT((NULL != flouka_Ptr),
-                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
-                    fileName,
-                    lineNumber);
-    ASSERT((FLOUKA_INITIALIZATION_PATTEREN != flouka_Ptr->initializationPattern),
-                    "FLOUKA:  Invalid statistics counter pointer passed (either not initialized pointer, or incorrect, non-null pointer)",
-                    fileName,
-                    lineNumber);
+    family_Ptr->groupID = FLOUKA_UNASSIGNED_ID;
+    family_Ptr->familyName_Ptr = emptyString_Ptr;
+    family_Ptr->familyDescription_Ptr = emptyString_Ptr;
+    family_Ptr->firstCounterID = 0;
+    family_Ptr->membersCount = 0;
+    family_Ptr->instancesCount = 0;
+    family_Ptr->memberInfoList_Ptr = NULL;
+    family_Ptr->labelList_Ptr = NULL;
+    family_Ptr->freeSlotList_Ptr = NULL;
+    family_Ptr->freeSlotsCount = 0;
+}
+
+STATIC INLINE uint32 SparseTable_hash(uint64 sparseID)
+{
     /*
      * Steps done in this function:
      * ============================
-     * 1. Get the pointer to the deallocation function.
-     * 2. Deallocate all the internal member.
-     * 3. Deallocate the flouka_Ptr itself.
-     * 4. Set the flouka_Ptr to NULL to prevent invalid access.
+     * 1. Mix the bits of the sparse ID (fmix64), so that IDs differing in any bits (ex. the hashes
+     *    of module and counter names, or IDs counting up in the high bits) spread over the table.
      */
-    deallocationFunctionPointer = flouka_Ptr->deallocationFunction_Ptr;
-    deallocationFunctionPointer(flouka_Ptr->information.groupInfoList_Ptr);
-    deallocationFunctionPointer(flouka_Ptr->information.subgroupInfoList_Ptr);
-    deallocationFunctionPointer(flouka_Ptr->information.counterInfoList_Ptr);
-    deallocationFunctionPointer(flouka_Ptr->counterValuesList_Ptr);
-    deallocationFunctionPointer((void*) flouka_Ptr);
-    flouka_Ptr = NULL;
+    sparseID ^= sparseID >> 33;
+    sparseID *= FLOUKA_SPARSE_HASH_MULTIPLIER1;
+    sparseID ^= sparseID >> 33;
+    sparseID *= FLOUKA_SPARSE_HASH_MULTIPLIER2;
+    sparseID ^= sparseID >> 33;
+    return ((uint32) sparseID);
 }
 
-void flouka_assignGroup(flouka_s* flouka_Ptr,
-                        uint32 groupID,
-                        const char* groupName_Ptr,
-                        const char* groupDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+STATIC void StatisticsInformation_buildCache(flouka_s* flouka_Ptr)
 {
+    uint32 i;
+    uint8* cache_Ptr;
+
     /*
-     * Assertions done in this function:
-     * =================================
-     * 1. Validate the flouka_Ptr (not NULL).
-     * 2. Validate the total number of assigned groups (less than maximum).
-     * 3. Validate the given group ID (less than maximum).
-     * 4. Validate the group assignment status (not assigned).
-     * 5. Validate the groupName_Ptr (not NULL).
-     * 6. Validate the groupName_Ptr (non empty string ("")).
-     * 7. Validate the groupDescription_Ptr (not NULL).
-     * 8. Validate the groupDescription_Ptr (non empty string ("")).
+     * Steps done in this function:
+     * ============================
+     * 1. Do nothing if the information is already serialized.
+     * 2. Allocate the cache, and encode the length header followed by the information, and then
+     *    the number of families followed by every family (the counters of the families are not
+     *    assigned counters, every family is described once, see CounterFamily_serialize).
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
      */
-    ASSERT((NULL != flouka_Ptr),
-                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+    if(NULL != flouka_Ptr->informationCache_Ptr)
+    {
+        return;
+    }
+
+    flouka_Ptr->informationCacheSize = StatisticsInformation_getSerializedSize(&(flouka_Ptr->information),
+                                                                               flouka_Ptr->totalGroupsCount,
+                                                                               flouka_Ptr->totalSubGroupsCount,
+                                                                               flouka_Ptr->totalCountersCount)
+                    + sizeof(flouka_Ptr->informationCacheSize) + sizeof(flouka_Ptr->familiesCount);
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        flouka_Ptr->informationCacheSize += CounterFamily_getSerializedSize(&(flouka_Ptr->familyList_Ptr[i]));
+    }
+    cache_Ptr = (uint8*) flouka_Ptr->allocationFunction_Ptr(flouka_Ptr->informationCacheSize);
+    flouka_Ptr->informationCache_Ptr = cache_Ptr;
+
+    FLOUKA_ENCODE_PARAMETER(cache_Ptr, flouka_Ptr->informationCacheSize);
+
+    cache_Ptr = StatisticsInformation_serialize(&(flouka_Ptr->information),
+                                                cache_Ptr,
+                                                flouka_Ptr->totalGroupsCount,
+                                                flouka_Ptr->totalSubGroupsCount,
+                                                flouka_Ptr->totalCountersCount);
+
+    FLOUKA_ENCODE_PARAMETER(cache_Ptr, flouka_Ptr->familiesCount);
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        cache_Ptr = CounterFamily_serialize(&(flouka_Ptr->familyList_Ptr[i]), i, cache_Ptr);
+    }
+}
+
+STATIC void StatisticsInformation_retire(flouka_s* flouka_Ptr,
+                                         void* list_Ptr)
+{
+    flouka_RetiredList_s* retiredList_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Link the given list to the retired lists of the object, instead of releasing it, a thread
+     *    may still be reading it without the lock, it is released by flouka_destroy.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    retiredList_Ptr = (flouka_RetiredList_s*) flouka_Ptr->allocationFunction_Ptr(sizeof(*retiredList_Ptr));
+    retiredList_Ptr->list_Ptr = list_Ptr;
+    retiredList_Ptr->next_Ptr = flouka_Ptr->retiredListList_Ptr;
+    flouka_Ptr->retiredListList_Ptr = retiredList_Ptr;
+}
+
+STATIC void StatisticsInformation_invalidateCache(flouka_s* flouka_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Advance the schema generation.
+     * 2. Drop the serialized information, the indexed information and the membership index, they
+     *    are built again when they are next requested, they are retired instead of released (see
+     *    StatisticsInformation_retire), since they are returned to the callers without copying
+     *    them (they are only built when requested, so at most one of each is retired per schema
+     *    change).
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    flouka_Ptr->schemaGeneration++;
+    if(NULL != flouka_Ptr->informationCache_Ptr)
+    {
+        StatisticsInformation_retire(flouka_Ptr, flouka_Ptr->informationCache_Ptr);
+        flouka_Ptr->informationCache_Ptr = NULL;
+    }
+    if(NULL != flouka_Ptr->indexCache_Ptr)
+    {
+        StatisticsInformation_retire(flouka_Ptr, flouka_Ptr->indexCache_Ptr);
+        flouka_Ptr->indexCache_Ptr = NULL;
+    }
+    if(NULL != flouka_Ptr->membershipIndex_Ptr)
+    {
+        StatisticsInformation_retire(flouka_Ptr, flouka_Ptr->membershipIndex_Ptr);
+        flouka_Ptr->membershipIndex_Ptr = NULL;
+    }
+}
+
+STATIC void StatisticsInformation_clear(flouka_s* flouka_Ptr,
+                                        uint32 firstGroupID,
+                                        uint32 firstSubGroupID,
+                                        uint32 firstCounterID,
+                                        uint32 totalCountersCount)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Mark the groups, sub groups and counters from the given IDs up to the totals as not
+     *    assigned, they have empty strings (the interned one), and their parents are
+     *    FLOUKA_UNASSIGNED_ID, so that the information can be read before they are assigned.
+     *
+     * Note:
+     * The total of the counters is passed, since flouka_grow publishes it only after they are
+     * cleared.
+     */
+    for(i = firstGroupID; i < flouka_Ptr->totalGroupsCount; i++)
+    {
+#ifdef DEBUG
+        flouka_Ptr->information.groupInfoList_Ptr[i].isAssigned = FALSE;
+#endif /*DEBUG*/
+        flouka_Ptr->information.groupInfoList_Ptr[i].groupID = i;
+        flouka_Ptr->information.groupInfoList_Ptr[i].groupName_Ptr = flouka_Ptr->emptyString_Ptr;
+        flouka_Ptr->information.groupInfoList_Ptr[i].groupDescription_Ptr = flouka_Ptr->emptyString_Ptr;
+    } /*for*/
+
+    for(i = firstSubGroupID; i < flouka_Ptr->totalSubGroupsCount; i++)
+    {
+#ifdef DEBUG
+        flouka_Ptr->information.subgroupInfoList_Ptr[i].isAssigned = FALSE;
+#endif /*DEBUG*/
+        flouka_Ptr->information.subgroupInfoList_Ptr[i].subgroupID = i;
+        flouka_Ptr->information.subgroupInfoList_Ptr[i].groupID = FLOUKA_UNASSIGNED_ID;
+        flouka_Ptr->information.subgroupInfoList_Ptr[i].subgroupName_Ptr = flouka_Ptr->emptyString_Ptr;
+        flouka_Ptr->information.subgroupInfoList_Ptr[i].subgroupDescription_Ptr = flouka_Ptr->emptyString_Ptr;
+    } /*for*/
+
+    for(i = firstCounterID; i < totalCountersCount; i++)
+    {
+#ifdef DEBUG
+        flouka_Ptr->information.counterInfoList_Ptr[i].isAssigned = FALSE;
+#endif /*DEBUG*/
+        flouka_Ptr->information.counterInfoList_Ptr[i].counterID = i;
+        flouka_Ptr->information.counterInfoList_Ptr[i].subgroupID = FLOUKA_UNASSIGNED_ID;
+        flouka_Ptr->information.counterInfoList_Ptr[i].unit_Ptr = flouka_Ptr->emptyString_Ptr;
+        flouka_Ptr->information.counterInfoList_Ptr[i].counterName_Ptr = flouka_Ptr->emptyString_Ptr;
+        flouka_Ptr->information.counterInfoList_Ptr[i].counterDescription_Ptr = flouka_Ptr->emptyString_Ptr;
+        flouka_Ptr->information.counterInfoList_Ptr[i].familyID = FLOUKA_UNASSIGNED_ID;
+    } /*for*/
+}
+
+STATIC INLINE size_t Arena_roundUp(size_t size)
+{
+    return ((size + FLOUKA_CACHE_LINE_SIZE - 1) & ~((size_t) FLOUKA_CACHE_LINE_SIZE - 1));
+}
+
+STATIC uint8* Arena_create(size_t arenaSize,
+                           flouka_hugePages_e hugePages)
+{
+    int flags;
+    void* arena_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Map the arena, with the reserved huge pages if requested (the mapping fails if there are
+     *    not enough of them, instead of failing when the memory is first written).
+     * 2. Advise the kernel to back the arena with transparent huge pages if requested (the advice
+     *    is ignored by the kernels that do not support it).
+     * 3. Write the whole arena, so that all its memory is taken at the initialization (the memory
+     *    footprint of the object does not change after that).
+     * 4. Return NULL if the arena cannot be mapped.
+     */
+    flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if(FLOUKA_HUGE_PAGES_RESERVED == hugePages)
+    {
+        flags |= MAP_HUGETLB;
+    }
+    arena_Ptr = mmap(NULL, arenaSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if(MAP_FAILED == arena_Ptr)
+    {
+        return (NULL);
+    }
+#ifdef MADV_HUGEPAGE
+    if(FLOUKA_HUGE_PAGES_TRANSPARENT == hugePages)
+    {
+        madvise(arena_Ptr, arenaSize, MADV_HUGEPAGE);
+    }
+#endif /*MADV_HUGEPAGE*/
+    memset(arena_Ptr, 0, arenaSize);
+
+    return ((uint8*) arena_Ptr);
+}
+
+STATIC void* Arena_allocate(uint8** arenaNext_Ptr,
+                            AllocFuncPtr allocationFunction_Ptr,
+                            size_t size)
+{
+    void* allocation_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate the memory with the allocation function if there is no arena.
+     * 2. Otherwise take it from the next free byte of the arena (which is sized for all the
+     *    allocations of the initialization), keeping the next allocation cache line aligned.
+     */
+    if(NULL == *arenaNext_Ptr)
+    {
+        return (allocationFunction_Ptr(size));
+    }
+    allocation_Ptr = *arenaNext_Ptr;
+    *arenaNext_Ptr += Arena_roundUp(size);
+    return (allocation_Ptr);
+}
+
+STATIC void Arena_deallocate(flouka_s* flouka_Ptr,
+                             void* allocation_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Release the memory with the deallocation function, unless it is taken from the arena (it
+     *    is then released with the arena).
+     */
+    if((NULL != flouka_Ptr->arena_Ptr) && ((uint8*) allocation_Ptr >= flouka_Ptr->arena_Ptr)
+       && ((uint8*) allocation_Ptr < (flouka_Ptr->arena_Ptr + flouka_Ptr->arenaSize)))
+    {
+        return;
+    }
+    flouka_Ptr->deallocationFunction_Ptr(allocation_Ptr);
+}
+
+STATIC void* StatisticsInformation_growList(flouka_s* flouka_Ptr,
+                                            void* list_Ptr,
+                                            size_t entrySize,
+                                            uint32 entriesCount,
+                                            uint32* capacity_Ptr)
+{
+    void* newList_Ptr;
+    uint32 newCapacity;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the list as is if it can hold the given number of entries.
+     * 2. Otherwise allocate a list of double the capacity (or the given number of entries if more),
+     *    and copy the entries to it, so that growing the object one counter at a time does not copy
+     *    the lists every time.
+     * 3. Retire the old list (if any) instead of releasing it (see StatisticsInformation_retire),
+     *    the retired lists add up to no more than the current one, since the capacity is doubled
+     *    every time.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    if(entriesCount <= *capacity_Ptr)
+    {
+        return (list_Ptr);
+    }
+    newCapacity = ((2 * *capacity_Ptr) > entriesCount) ? (2 * *capacity_Ptr) : entriesCount;
+    newList_Ptr = flouka_Ptr->allocationFunction_Ptr(newCapacity * entrySize);
+    if(NULL != list_Ptr)
+    {
+        memcpy(newList_Ptr, list_Ptr, *capacity_Ptr * entrySize);
+        StatisticsInformation_retire(flouka_Ptr, list_Ptr);
+    }
+    *capacity_Ptr = newCapacity;
+    return (newList_Ptr);
+}
+
+STATIC INLINE flouka_InternedString_s* StringStore_getEntry_Ptr(const char* string_Ptr)
+{
+    /*The header of an interned string is just before the string*/
+    return (((flouka_InternedString_s*) string_Ptr) - 1);
+}
+
+STATIC INLINE void IndexedInformation_putUint32(uint8* buffer_Ptr,
+                                                uint32 value)
+{
+    /*The integers of the indexed information are always little-endian 32-bit integers*/
+    buffer_Ptr[0] = (uint8) value;
+    buffer_Ptr[1] = (uint8) (value >> 8);
+    buffer_Ptr[2] = (uint8) (value >> 16);
+    buffer_Ptr[3] = (uint8) (value >> 24);
+}
+
+STATIC INLINE uint8* IndexedInformation_putString(uint8* record_Ptr,
+                                                  uint8* stringTable_Ptr,
+                                                  uint32* stringTableSize_Ptr,
+                                                  const char* string_Ptr)
+{
+    uint32 stringSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Append the string to the string table, and write its offset to the record.
+     * 2. Return the record pointer after advancing it by the size of the offset.
+     */
+    stringSize = strlen(string_Ptr) + 1;
+    memcpy(stringTable_Ptr + *stringTableSize_Ptr, string_Ptr, stringSize);
+    IndexedInformation_putUint32(record_Ptr, *stringTableSize_Ptr);
+    *stringTableSize_Ptr += stringSize;
+
+    return (record_Ptr + FLOUKA_INDEX_FIELD_SIZE);
+}
+
+STATIC INLINE void IndexedInformation_reserveString(uint32* stringTableSize_Ptr,
+                                                    const char* string_Ptr)
+{
+    flouka_InternedString_s* entry_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Give the interned string the next offset of the string table, unless it already has one
+     *    (every distinct string is stored once, and shared by all the records using it).
+     */
+    entry_Ptr = StringStore_getEntry_Ptr(string_Ptr);
+    if(FLOUKA_UNASSIGNED_ID == entry_Ptr->tableOffset)
+    {
+        entry_Ptr->tableOffset = *stringTableSize_Ptr;
+        *stringTableSize_Ptr += entry_Ptr->length + 1;
+    }
+}
+
+STATIC INLINE uint8* IndexedInformation_putInternedString(uint8* record_Ptr,
+                                                          const char* string_Ptr)
+{
+    /*The interned string is already copied to the offset reserved for it*/
+    IndexedInformation_putUint32(record_Ptr, StringStore_getEntry_Ptr(string_Ptr)->tableOffset);
+    return (record_Ptr + FLOUKA_INDEX_FIELD_SIZE);
+}
+
+STATIC void IndexedInformation_putTable(uint8* index_Ptr,
+                                        uint32 table,
+                                        uint32 count,
+                                        uint32 recordsOffset,
+                                        uint32 recordSize)
+{
+    IndexedInformation_putUint32(index_Ptr + table + FLOUKA_INDEX_TABLE_COUNT, count);
+    IndexedInformation_putUint32(index_Ptr + table + FLOUKA_INDEX_TABLE_RECORDS_OFFSET, recordsOffset);
+    IndexedInformation_putUint32(index_Ptr + table + FLOUKA_INDEX_TABLE_RECORD_SIZE, recordSize);
+}
+
+STATIC void IndexedInformation_build(flouka_s* flouka_Ptr)
+{
+    uint32 i;
+    uint32 j;
+    uint32 stringTableSize;
+    uint32 internedStringsSize;
+    uint32 subGroupRecordsOffset;
+    uint32 counterRecordsOffset;
+    uint32 familyRecordsOffset;
+    uint32 memberRecordsOffset;
+    uint32 instanceRecordsOffset;
+    uint32 stringTableOffset;
+    uint32 membersCount;
+    uint32 instancesCount;
+    uint8* index_Ptr;
+    uint8* record_Ptr;
+    uint8* stringTable_Ptr;
+    uint8* memberRecord_Ptr;
+    uint8* instanceRecord_Ptr;
+    flouka_StatisticsInformation_s* information_Ptr;
+    flouka_CounterFamily_s* family_Ptr;
+    flouka_InternedString_s* entry_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Do nothing if the indexed information is already built.
+     * 2. Reserve an offset of the string table for every distinct (interned) string used by the
+     *    records, followed by the labels of the instances (they are not interned, a label is
+     *    released with its instance).
+     * 3. Compute the offsets of the records and the string table.
+     * 4. Allocate the indexed information, write the header, and copy every reserved string to
+     *    its offset.
+     * 5. Write the record of every group, sub group and counter (ordered by their IDs).
+     * 6. Write the record of every family, followed in their tables by the records of its members
+     *    and of all its slots (the free slots have empty labels), while appending the labels to
+     *    the string table.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    if(NULL != flouka_Ptr->indexCache_Ptr)
+    {
+        return;
+    }
+
+    for(i = 0; i <= flouka_Ptr->stringBucketsMask; i++)
+    {
+        for(entry_Ptr = flouka_Ptr->stringBucketList_Ptr[i]; NULL != entry_Ptr; entry_Ptr = entry_Ptr->next_Ptr)
+        {
+            entry_Ptr->tableOffset = FLOUKA_UNASSIGNED_ID;
+        }
+    }
+
+    information_Ptr = &(flouka_Ptr->information);
+    stringTableSize = 0;
+    IndexedInformation_reserveString(&stringTableSize, flouka_Ptr->emptyString_Ptr);
+    for(i = 0; i < flouka_Ptr->totalGroupsCount; i++)
+    {
+        IndexedInformation_reserveString(&stringTableSize, information_Ptr->groupInfoList_Ptr[i].groupName_Ptr);
+        IndexedInformation_reserveString(&stringTableSize, information_Ptr->groupInfoList_Ptr[i].groupDescription_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->totalSubGroupsCount; i++)
+    {
+        IndexedInformation_reserveString(&stringTableSize, information_Ptr->subgroupInfoList_Ptr[i].subgroupName_Ptr);
+        IndexedInformation_reserveString(&stringTableSize,
+                                         information_Ptr->subgroupInfoList_Ptr[i].subgroupDescription_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->totalCountersCount; i++)
+    {
+        IndexedInformation_reserveString(&stringTableSize, information_Ptr->counterInfoList_Ptr[i].unit_Ptr);
+        IndexedInformation_reserveString(&stringTableSize, information_Ptr->counterInfoList_Ptr[i].counterName_Ptr);
+        IndexedInformation_reserveString(&stringTableSize,
+                                         information_Ptr->counterInfoList_Ptr[i].counterDescription_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        family_Ptr = &(flouka_Ptr->familyList_Ptr[i]);
+        IndexedInformation_reserveString(&stringTableSize, family_Ptr->familyName_Ptr);
+        IndexedInformation_reserveString(&stringTableSize, family_Ptr->familyDescription_Ptr);
+        for(j = 0; j < family_Ptr->membersCount; j++)
+        {
+            IndexedInformation_reserveString(&stringTableSize, family_Ptr->memberInfoList_Ptr[j].unit_Ptr);
+            IndexedInformation_reserveString(&stringTableSize, family_Ptr->memberInfoList_Ptr[j].counterName_Ptr);
+            IndexedInformation_reserveString(&stringTableSize,
+                                             family_Ptr->memberInfoList_Ptr[j].counterDescription_Ptr);
+        }
+    }
+    internedStringsSize = stringTableSize;
+
+    membersCount = 0;
+    instancesCount = 0;
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        family_Ptr = &(flouka_Ptr->familyList_Ptr[i]);
+        for(j = 0; j < family_Ptr->instancesCount; j++)
+        {
+            if(NULL != family_Ptr->labelList_Ptr[j])
+            {
+                stringTableSize += strlen(family_Ptr->labelList_Ptr[j]) + 1;
+            }
+        }
+        membersCount += family_Ptr->membersCount;
+        instancesCount += family_Ptr->instancesCount;
+    }
+
+    subGroupRecordsOffset = FLOUKA_INDEX_HEADER_SIZE
+                    + (flouka_Ptr->totalGroupsCount * FLOUKA_INDEX_GROUP_RECORD_SIZE);
+    counterRecordsOffset = subGroupRecordsOffset
+                    + (flouka_Ptr->totalSubGroupsCount * FLOUKA_INDEX_SUB_GROUP_RECORD_SIZE);
+    familyRecordsOffset = counterRecordsOffset
+                    + (flouka_Ptr->totalCountersCount * FLOUKA_INDEX_COUNTER_RECORD_SIZE);
+    memberRecordsOffset = familyRecordsOffset
+                    + (flouka_Ptr->familiesCount * FLOUKA_INDEX_FAMILY_RECORD_SIZE);
+    instanceRecordsOffset = memberRecordsOffset + (membersCount * FLOUKA_INDEX_MEMBER_RECORD_SIZE);
+    stringTableOffset = instanceRecordsOffset + (instancesCount * FLOUKA_INDEX_INSTANCE_RECORD_SIZE);
+    flouka_Ptr->indexCacheSize = stringTableOffset + stringTableSize;
+
+    index_Ptr = (uint8*) flouka_Ptr->allocationFunction_Ptr(flouka_Ptr->indexCacheSize);
+    flouka_Ptr->indexCache_Ptr = index_Ptr;
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_MAGIC, FLOUKA_INDEX_MAGIC);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_VERSION, FLOUKA_INDEX_VERSION);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_HEADER_SIZE, FLOUKA_INDEX_HEADER_SIZE);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_TOTAL_SIZE, flouka_Ptr->indexCacheSize);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_SCHEMA_GENERATION,
+                                 flouka_Ptr->schemaGeneration);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_GROUPS,
+                                flouka_Ptr->totalGroupsCount,
+                                FLOUKA_INDEX_HEADER_SIZE,
+                                FLOUKA_INDEX_GROUP_RECORD_SIZE);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_SUB_GROUPS,
+                                flouka_Ptr->totalSubGroupsCount,
+                                subGroupRecordsOffset,
+                                FLOUKA_INDEX_SUB_GROUP_RECORD_SIZE);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_COUNTERS,
+                                flouka_Ptr->totalCountersCount,
+                                counterRecordsOffset,
+                                FLOUKA_INDEX_COUNTER_RECORD_SIZE);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_FAMILIES,
+                                flouka_Ptr->familiesCount,
+                                familyRecordsOffset,
+                                FLOUKA_INDEX_FAMILY_RECORD_SIZE);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_MEMBERS,
+                                membersCount,
+                                memberRecordsOffset,
+                                FLOUKA_INDEX_MEMBER_RECORD_SIZE);
+    IndexedInformation_putTable(index_Ptr,
+                                FLOUKA_INDEX_TABLE_INSTANCES,
+                                instancesCount,
+                                instanceRecordsOffset,
+                                FLOUKA_INDEX_INSTANCE_RECORD_SIZE);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_STRING_TABLE_OFFSET, stringTableOffset);
+    IndexedInformation_putUint32(index_Ptr + FLOUKA_INDEX_HEADER_STRING_TABLE_SIZE, stringTableSize);
+
+    stringTable_Ptr = index_Ptr + stringTableOffset;
+    for(i = 0; i <= flouka_Ptr->stringBucketsMask; i++)
+    {
+        for(entry_Ptr = flouka_Ptr->stringBucketList_Ptr[i]; NULL != entry_Ptr; entry_Ptr = entry_Ptr->next_Ptr)
+        {
+            if(FLOUKA_UNASSIGNED_ID != entry_Ptr->tableOffset)
+            {
+                memcpy(stringTable_Ptr + entry_Ptr->tableOffset, (const char*) (entry_Ptr + 1), entry_Ptr->length + 1);
+            }
+        }
+    }
+
+    record_Ptr = index_Ptr + FLOUKA_INDEX_HEADER_SIZE;
+    for(i = 0; i < flouka_Ptr->totalGroupsCount; i++)
+    {
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr,
+                                                          information_Ptr->groupInfoList_Ptr[i].groupName_Ptr);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr,
+                                                          information_Ptr->groupInfoList_Ptr[i].groupDescription_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->totalSubGroupsCount; i++)
+    {
+        IndexedInformation_putUint32(record_Ptr, information_Ptr->subgroupInfoList_Ptr[i].groupID);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr + FLOUKA_INDEX_FIELD_SIZE,
+                                                          information_Ptr->subgroupInfoList_Ptr[i].subgroupName_Ptr);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr,
+                                                          information_Ptr->subgroupInfoList_Ptr[i].subgroupDescription_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->totalCountersCount; i++)
+    {
+        IndexedInformation_putUint32(record_Ptr, information_Ptr->counterInfoList_Ptr[i].subgroupID);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr + FLOUKA_INDEX_FIELD_SIZE,
+                                                          information_Ptr->counterInfoList_Ptr[i].unit_Ptr);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr,
+                                                          information_Ptr->counterInfoList_Ptr[i].counterName_Ptr);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr,
+                                                          information_Ptr->counterInfoList_Ptr[i].counterDescription_Ptr);
+    }
+
+    memberRecord_Ptr = index_Ptr + memberRecordsOffset;
+    instanceRecord_Ptr = index_Ptr + instanceRecordsOffset;
+    stringTableSize = internedStringsSize;
+    membersCount = 0;
+    instancesCount = 0;
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        family_Ptr = &(flouka_Ptr->familyList_Ptr[i]);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_GROUP_ID, family_Ptr->groupID);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_FIRST_COUNTER_ID, family_Ptr->firstCounterID);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_MEMBERS_COUNT, family_Ptr->membersCount);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_INSTANCES_COUNT, family_Ptr->instancesCount);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_FIRST_MEMBER, membersCount);
+        IndexedInformation_putUint32(record_Ptr + FLOUKA_INDEX_FAMILY_FIRST_INSTANCE, instancesCount);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr + FLOUKA_INDEX_FAMILY_NAME,
+                                                          family_Ptr->familyName_Ptr);
+        record_Ptr = IndexedInformation_putInternedString(record_Ptr, family_Ptr->familyDescription_Ptr);
+        for(j = 0; j < family_Ptr->membersCount; j++)
+        {
+            IndexedInformation_putUint32(memberRecord_Ptr, i);
+            memberRecord_Ptr = IndexedInformation_putInternedString(memberRecord_Ptr + FLOUKA_INDEX_FIELD_SIZE,
+                                                                    family_Ptr->memberInfoList_Ptr[j].unit_Ptr);
+            memberRecord_Ptr = IndexedInformation_putInternedString(memberRecord_Ptr,
+                                                                    family_Ptr->memberInfoList_Ptr[j].counterName_Ptr);
+            memberRecord_Ptr = IndexedInformation_putInternedString(memberRecord_Ptr,
+                                                                    family_Ptr->memberInfoList_Ptr[j].counterDescription_Ptr);
+        }
+        for(j = 0; j < family_Ptr->instancesCount; j++)
+        {
+            IndexedInformation_putUint32(instanceRecord_Ptr, i);
+            IndexedInformation_putUint32(instanceRecord_Ptr + FLOUKA_INDEX_FIELD_SIZE,
+                                         family_Ptr->firstCounterID + (j * family_Ptr->membersCount));
+            if(NULL == family_Ptr->labelList_Ptr[j])
+            {
+                instanceRecord_Ptr = IndexedInformation_putInternedString(instanceRecord_Ptr
+                                                                          + (2 * FLOUKA_INDEX_FIELD_SIZE),
+                                                                          flouka_Ptr->emptyString_Ptr);
+            }
+            else
+            {
+                instanceRecord_Ptr = IndexedInformation_putString(instanceRecord_Ptr + (2 * FLOUKA_INDEX_FIELD_SIZE),
+                                                                  stringTable_Ptr,
+                                                                  &stringTableSize,
+                                                                  family_Ptr->labelList_Ptr[j]);
+            }
+        }
+        membersCount += family_Ptr->membersCount;
+        instancesCount += family_Ptr->instancesCount;
+    }
+}
+
+STATIC void MembershipIndex_build(flouka_s* flouka_Ptr)
+{
+    uint32 i;
+    uint32 groupID;
+    uint32 subgroupID;
+    uint32 countersCount;
+    uint32 indexSize;
+    uint32* groupStartList_Ptr;
+    uint32* groupEndList_Ptr;
+    uint32* subgroupStartList_Ptr;
+    uint32* subgroupEndList_Ptr;
+    uint32* counterIDList_Ptr;
+    flouka_StatisticsInformation_s* information_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Do nothing if the membership index is already built.
+     * 2. Allocate the index, which is the list of the counter IDs ordered by their group, then by
+     *    their sub group, and then by their IDs, so that the counters of any group or sub group
+     *    are one range of the list, preceded by the start and the end of the range of every group
+     *    and every sub group.
+     * 3. Count the counters of every sub group and every group.
+     * 4. Place the range of every group after the previous group, and the range of every sub group
+     *    after the previous sub group of the same group.
+     * 5. Fill the counter IDs into the ranges of their sub groups.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the unassigned sub groups and counters
+     * belong to no group (the ranges of the unassigned sub groups are empty).
+     */
+    if(NULL != flouka_Ptr->membershipIndex_Ptr)
+    {
+        return;
+    }
+
+    information_Ptr = &(flouka_Ptr->information);
+    indexSize = ((2 * flouka_Ptr->totalGroupsCount) + (2 * flouka_Ptr->totalSubGroupsCount)
+                    + flouka_Ptr->totalCountersCount) * sizeof(*flouka_Ptr->membershipIndex_Ptr);
+    flouka_Ptr->membershipIndex_Ptr = (uint32*) flouka_Ptr->allocationFunction_Ptr(indexSize);
+    groupStartList_Ptr = flouka_Ptr->membershipIndex_Ptr;
+    groupEndList_Ptr = groupStartList_Ptr + flouka_Ptr->totalGroupsCount;
+    subgroupStartList_Ptr = groupEndList_Ptr + flouka_Ptr->totalGroupsCount;
+    subgroupEndList_Ptr = subgroupStartList_Ptr + flouka_Ptr->totalSubGroupsCount;
+    counterIDList_Ptr = subgroupEndList_Ptr + flouka_Ptr->totalSubGroupsCount;
+
+    memset(groupEndList_Ptr, 0, flouka_Ptr->totalGroupsCount * sizeof(*groupEndList_Ptr));
+    memset(subgroupEndList_Ptr, 0, flouka_Ptr->totalSubGroupsCount * sizeof(*subgroupEndList_Ptr));
+    for(i = 0; i < flouka_Ptr->totalCountersCount; i++)
+    {
+        if(FLOUKA_UNASSIGNED_ID != information_Ptr->counterInfoList_Ptr[i].subgroupID)
+        {
+            subgroupEndList_Ptr[information_Ptr->counterInfoList_Ptr[i].subgroupID]++;
+        }
+    }
+    for(i = 0; i < flouka_Ptr->totalSubGroupsCount; i++)
+    {
+        if(FLOUKA_UNASSIGNED_ID != information_Ptr->subgroupInfoList_Ptr[i].groupID)
+        {
+            groupEndList_Ptr[information_Ptr->subgroupInfoList_Ptr[i].groupID] += subgroupEndList_Ptr[i];
+        }
+    }
+
+    countersCount = 0;
+    for(i = 0; i < flouka_Ptr->totalGroupsCount; i++)
+    {
+        groupStartList_Ptr[i] = countersCount;
+        countersCount += groupEndList_Ptr[i];
+        groupEndList_Ptr[i] = groupStartList_Ptr[i];
+    }
+    for(i = 0; i < flouka_Ptr->totalSubGroupsCount; i++)
+    {
+        groupID = information_Ptr->subgroupInfoList_Ptr[i].groupID;
+        if(FLOUKA_UNASSIGNED_ID == groupID)
+        {
+            subgroupStartList_Ptr[i] = 0;
+            subgroupEndList_Ptr[i] = 0;
+            continue;
+        }
+        subgroupStartList_Ptr[i] = groupEndList_Ptr[groupID];
+        groupEndList_Ptr[groupID] += subgroupEndList_Ptr[i];
+        subgroupEndList_Ptr[i] = subgroupStartList_Ptr[i];
+    }
+
+    for(i = 0; i < flouka_Ptr->totalCountersCount; i++)
+    {
+        subgroupID = information_Ptr->counterInfoList_Ptr[i].subgroupID;
+        if(FLOUKA_UNASSIGNED_ID == subgroupID)
+        {
+            continue;
+        }
+        counterIDList_Ptr[subgroupEndList_Ptr[subgroupID]] = i;
+        subgroupEndList_Ptr[subgroupID]++;
+    }
+}
+
+STATIC INLINE uint32* MembershipIndex_getCounterIDList_Ptr(flouka_s* flouka_Ptr)
+{
+    return (flouka_Ptr->membershipIndex_Ptr + (2 * flouka_Ptr->totalGroupsCount)
+                    + (2 * flouka_Ptr->totalSubGroupsCount));
+}
+
+STATIC flouka_sharedMemoryHeader_s* SharedMemory_create(const char* sharedMemoryName_Ptr,
+                                                        bool isAnonymous,
+                                                        uint32 totalCountersCount,
+                                                        uint32 informationCapacity,
+                                                        int32* descriptor_Ptr)
+{
+    int32 fileDescriptor;
+    uint32 countersOffset;
+    uint32 informationOffset;
+    uint32 segmentSize;
+    flouka_sharedMemoryHeader_s* header_Ptr;
+    char path[FLOUKA_SHARED_MEMORY_PATH_SIZE];
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Compute the layout, every area starts at a cache line boundary, and the counters area is
+     *    rounded up to a whole number of cache lines (the same size as an unsharded counters list).
+     * 2. Create the segment (replacing any segment left by a previous run, unless it is anonymous)
+     *    and map it, the new segment is filled with zeros.
+     * 3. Keep a read only descriptor of the segment to be passed to the readers, the anonymous
+     *    segment is sealed (falling back to the size seals on the older kernels), and opened again
+     *    read only through its path in /proc, the descriptor is -1 (the segment is never passed to
+     *    the readers) if it cannot be opened read only.
+     * 4. Fill in the header, the magic is written last so that the readers do not use the segment
+     *    before it is ready.
+     */
+    countersOffset = ((sizeof(*header_Ptr) + FLOUKA_CACHE_LINE_SIZE - 1) / FLOUKA_CACHE_LINE_SIZE)
+                    * FLOUKA_CACHE_LINE_SIZE;
+    informationOffset = countersOffset
+                    + ((((totalCountersCount * sizeof(uint32)) + FLOUKA_CACHE_LINE_SIZE - 1)
+                                    / FLOUKA_CACHE_LINE_SIZE) * FLOUKA_CACHE_LINE_SIZE);
+    segmentSize = informationOffset + informationCapacity;
+
+    if(TRUE == isAnonymous)
+    {
+        fileDescriptor = memfd_create(sharedMemoryName_Ptr, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    }
+    else
+    {
+        fileDescriptor = shm_open(sharedMemoryName_Ptr, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    }
+    if(fileDescriptor < 0)
+    {
+        return (NULL);
+    }
+    if(0 != ftruncate(fileDescriptor, (off_t) segmentSize))
+    {
+        close(fileDescriptor);
+        if(FALSE == isAnonymous)
+        {
+            shm_unlink(sharedMemoryName_Ptr);
+        }
+        return (NULL);
+    }
+    header_Ptr = (flouka_sharedMemoryHeader_s*) mmap(NULL,
+                                                     segmentSize,
+                                                     PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED,
+                                                     fileDescriptor,
+                                                     0);
+    if(MAP_FAILED == (void*) header_Ptr)
+    {
+        close(fileDescriptor);
+        if(FALSE == isAnonymous)
+        {
+            shm_unlink(sharedMemoryName_Ptr);
+        }
+        return (NULL);
+    }
+
+    if(TRUE == isAnonymous)
+    {
+        if(0 != fcntl(fileDescriptor,
+                      F_ADD_SEALS,
+                      FLOUKA_SHARED_MEMORY_SEALS | FLOUKA_SHARED_MEMORY_WRITE_SEAL))
+        {
+            fcntl(fileDescriptor, F_ADD_SEALS, FLOUKA_SHARED_MEMORY_SEALS);
+        }
+        snprintf(path, sizeof(path), FLOUKA_SHARED_MEMORY_REOPEN_PATH, (int) fileDescriptor);
+        *descriptor_Ptr = open(path, O_RDONLY | O_CLOEXEC);
+        close(fileDescriptor);
+    }
+    else
+    {
+        close(fileDescriptor);
+        *descriptor_Ptr = shm_open(sharedMemoryName_Ptr, O_RDONLY, 0);
+    }
+
+    header_Ptr->version = FLOUKA_SHARED_MEMORY_VERSION;
+    header_Ptr->headerSize = sizeof(*header_Ptr);
+    header_Ptr->segmentSize = segmentSize;
+    header_Ptr->changeSequence = 0;
+    header_Ptr->schemaGeneration = 0;
+    header_Ptr->totalCountersCount = totalCountersCount;
+    header_Ptr->countersOffset = countersOffset;
+    header_Ptr->isLive = FALSE;
+    header_Ptr->informationOffset = informationOffset;
+    header_Ptr->informationCapacity = informationCapacity;
+    header_Ptr->informationSize = 0;
+    __atomic_store_n(&(header_Ptr->magic), FLOUKA_SHARED_MEMORY_MAGIC, __ATOMIC_RELEASE);
+
+    return (header_Ptr);
+}
+
+STATIC INLINE uint32* SharedMemory_getCounters_Ptr(flouka_sharedMemoryHeader_s* header_Ptr)
+{
+    return ((uint32*) ((uint8*) header_Ptr + header_Ptr->countersOffset));
+}
+
+STATIC flouka_PersistentHeader_s* PersistentStorage_open(const char* persistenceFileName_Ptr,
+                                                         uint32 totalCountersCount,
+                                                         uint32 shardsCount,
+                                                         uint32 shardStride)
+{
+    int32 fileDescriptor;
+    struct stat fileStatus;
+    flouka_PersistentHeader_s header;
+    flouka_PersistentHeader_s fileHeader;
+    flouka_PersistentHeader_s* header_Ptr;
+    bool isValid;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Compute the layout of the file, the lists start at a cache line boundary.
+     * 2. Open (or create) the file, and check that it has the same layout by reading its header.
+     * 3. Clear the file if it has a different layout (or it is new), and set it to the needed size.
+     * 4. Map the file, and write the header if the file was cleared.
+     */
+    memset(&header, 0, sizeof(header));
+    header.magic = FLOUKA_PERSISTENT_MAGIC;
+    header.version = FLOUKA_PERSISTENT_VERSION;
+    header.totalCountersCount = totalCountersCount;
+    header.shardsCount = shardsCount;
+    header.shardStride = shardStride;
+    header.keysOffset = ((sizeof(header) + FLOUKA_CACHE_LINE_SIZE - 1) / FLOUKA_CACHE_LINE_SIZE)
+                    * FLOUKA_CACHE_LINE_SIZE;
+    header.countersOffset = header.keysOffset
+                    + ((((totalCountersCount * sizeof(uint32)) + FLOUKA_CACHE_LINE_SIZE - 1)
+                                    / FLOUKA_CACHE_LINE_SIZE) * FLOUKA_CACHE_LINE_SIZE);
+    header.fileSize = header.countersOffset + (shardsCount * shardStride * sizeof(uint32));
+
+    fileDescriptor = open(persistenceFileName_Ptr, O_CREAT | O_RDWR, 0644);
+    if(fileDescriptor < 0)
+    {
+        return (NULL);
+    }
+
+    isValid = FALSE;
+    if((0 == fstat(fileDescriptor, &fileStatus)) && ((uint32) fileStatus.st_size == header.fileSize))
+    {
+        isValid = (sizeof(fileHeader) == pread(fileDescriptor, &fileHeader, sizeof(fileHeader), 0))
+                        && (0 == memcmp(&fileHeader, &header, sizeof(header)));
+    }
+    if((FALSE == isValid)
+       && ((0 != ftruncate(fileDescriptor, 0)) || (0 != ftruncate(fileDescriptor, (off_t) header.fileSize))))
+    {
+        close(fileDescriptor);
+        return (NULL);
+    }
+
+    header_Ptr = (flouka_PersistentHeader_s*) mmap(NULL,
+                                                   header.fileSize,
+                                                   PROT_READ | PROT_WRITE,
+                                                   MAP_SHARED,
+                                                   fileDescriptor,
+                                                   0);
+    close(fileDescriptor);
+    if(MAP_FAILED == (void*) header_Ptr)
+    {
+        return (NULL);
+    }
+
+    if(FALSE == isValid)
+    {
+        *header_Ptr = header;
+    }
+    return (header_Ptr);
+}
+
+STATIC INLINE uint32* PersistentStorage_getKeys_Ptr(flouka_PersistentHeader_s* header_Ptr)
+{
+    return ((uint32*) ((uint8*) header_Ptr + header_Ptr->keysOffset));
+}
+
+STATIC INLINE uint32* PersistentStorage_getCounters_Ptr(flouka_PersistentHeader_s* header_Ptr)
+{
+    return ((uint32*) ((uint8*) header_Ptr + header_Ptr->countersOffset));
+}
+
+STATIC INLINE uint32 PersistentStorage_hashValue(uint32 hash,
+                                                 uint32 value)
+{
+    uint32 i;
+
+    for(i = 0; i < sizeof(value); i++)
+    {
+        hash = ((hash ^ (value & 0xFF)) * FLOUKA_KEY_PRIME) & 0xFFFFFFFFLU;
+        value >>= 8;
+    }
+    return (hash);
+}
+
+STATIC INLINE uint32 PersistentStorage_hashString(uint32 hash,
+                                                  const char* string_Ptr)
+{
+    /*The terminating null is hashed too, so that "ab", "c" and "a", "bc" have different hashes*/
+    do
+    {
+        hash = ((hash ^ (uint8) *string_Ptr) * FLOUKA_KEY_PRIME) & 0xFFFFFFFFLU;
+    } while('\0' != *(string_Ptr++));
+    return (hash);
+}
+
+STATIC void StringStore_growBuckets(flouka_s* flouka_Ptr,
+                                    uint32 stringsCount)
+{
+    uint32 i;
+    uint32 bucketsCount;
+    flouka_InternedString_s* entry_Ptr;
+    flouka_InternedString_s* nextEntry_Ptr;
+    flouka_InternedString_s** bucketList_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate a hash table of double the buckets, or more if needed to hold the given number of
+     *    strings with one string per bucket on average.
+     * 2. Move every string to its bucket in the new table (the hashes are kept with the strings).
+     * 3. Release the old table.
+     */
+    bucketsCount = 2 * (flouka_Ptr->stringBucketsMask + 1);
+    while(bucketsCount < stringsCount)
+    {
+        bucketsCount *= 2;
+    }
+    bucketList_Ptr = (flouka_InternedString_s**) flouka_Ptr->allocationFunction_Ptr(bucketsCount
+                    * sizeof(*bucketList_Ptr));
+    memset(bucketList_Ptr, 0, bucketsCount * sizeof(*bucketList_Ptr));
+
+    for(i = 0; i <= flouka_Ptr->stringBucketsMask; i++)
+    {
+        for(entry_Ptr = flouka_Ptr->stringBucketList_Ptr[i]; NULL != entry_Ptr; entry_Ptr = nextEntry_Ptr)
+        {
+            nextEntry_Ptr = entry_Ptr->next_Ptr;
+            entry_Ptr->next_Ptr = bucketList_Ptr[entry_Ptr->hash & (bucketsCount - 1)];
+            bucketList_Ptr[entry_Ptr->hash & (bucketsCount - 1)] = entry_Ptr;
+        }
+    }
+
+    flouka_Ptr->deallocationFunction_Ptr(flouka_Ptr->stringBucketList_Ptr);
+    flouka_Ptr->stringBucketList_Ptr = bucketList_Ptr;
+    flouka_Ptr->stringBucketsMask = bucketsCount - 1;
+}
+
+STATIC const char* StringStore_intern(flouka_s* flouka_Ptr,
+                                      const char* string_Ptr)
+{
+    uint32 hash;
+    uint32 length;
+    uint32 entrySize;
+    uint32 chunkSize;
+    flouka_InternedString_s* entry_Ptr;
+    flouka_StringChunk_s* chunk_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the interned copy of the string if it is already interned.
+     * 2. Otherwise copy the string after its header to the last chunk of the store (a new chunk
+     *    is allocated if it does not fit, the headers are kept aligned to a pointer).
+     * 3. Add the copy to the hash table, and double the buckets if there are more strings than
+     *    buckets.
+     * 4. Return the copy, it stays valid (and never moves) until the object is destroyed, so that
+     *    the string given by the caller may be released (or reused) after the call.
+     *
+     * Note:
+     * The lock of the object must be held by the caller (except at the initialization).
+     */
+    hash = PersistentStorage_hashString(FLOUKA_KEY_OFFSET_BASIS, string_Ptr);
+    length = strlen(string_Ptr);
+    for(entry_Ptr = flouka_Ptr->stringBucketList_Ptr[hash & flouka_Ptr->stringBucketsMask];
+        NULL != entry_Ptr;
+        entry_Ptr = entry_Ptr->next_Ptr)
+    {
+        if((hash == entry_Ptr->hash) && (length == entry_Ptr->length)
+           && (0 == memcmp((const char*) (entry_Ptr + 1), string_Ptr, length)))
+        {
+            return ((const char*) (entry_Ptr + 1));
+        }
+    }
+
+    entrySize = (sizeof(*entry_Ptr) + length + 1 + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    chunk_Ptr = flouka_Ptr->stringChunkList_Ptr;
+    if((NULL == chunk_Ptr) || ((chunk_Ptr->usedSize + entrySize) > chunk_Ptr->size))
+    {
+        chunkSize = sizeof(*chunk_Ptr) + entrySize;
+        if(chunkSize < FLOUKA_STRING_CHUNK_SIZE)
+        {
+            chunkSize = FLOUKA_STRING_CHUNK_SIZE;
+        }
+        chunk_Ptr = (flouka_StringChunk_s*) flouka_Ptr->allocationFunction_Ptr(chunkSize);
+        chunk_Ptr->next_Ptr = flouka_Ptr->stringChunkList_Ptr;
+        chunk_Ptr->size = chunkSize;
+        chunk_Ptr->usedSize = (sizeof(*chunk_Ptr) + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+        flouka_Ptr->stringChunkList_Ptr = chunk_Ptr;
+    }
+    entry_Ptr = (flouka_InternedString_s*) ((uint8*) chunk_Ptr + chunk_Ptr->usedSize);
+    chunk_Ptr->usedSize += entrySize;
+    entry_Ptr->hash = hash;
+    entry_Ptr->length = length;
+    entry_Ptr->tableOffset = FLOUKA_UNASSIGNED_ID;
+    memcpy((char*) (entry_Ptr + 1), string_Ptr, length + 1);
+
+    entry_Ptr->next_Ptr = flouka_Ptr->stringBucketList_Ptr[hash & flouka_Ptr->stringBucketsMask];
+    flouka_Ptr->stringBucketList_Ptr[hash & flouka_Ptr->stringBucketsMask] = entry_Ptr;
+    flouka_Ptr->stringsCount++;
+    if(flouka_Ptr->stringsCount > (flouka_Ptr->stringBucketsMask + 1))
+    {
+        StringStore_growBuckets(flouka_Ptr, flouka_Ptr->stringsCount);
+    }
+
+    return ((const char*) (entry_Ptr + 1));
+}
+
+STATIC void StringStore_reserve(flouka_s* flouka_Ptr,
+                                uint32 newStringsCount)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Grow the hash table once to hold the given number of new strings, instead of doubling it
+     *    again and again while a long list of strings is interned.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    if((flouka_Ptr->stringsCount + newStringsCount) > (flouka_Ptr->stringBucketsMask + 1))
+    {
+        StringStore_growBuckets(flouka_Ptr, flouka_Ptr->stringsCount + newStringsCount);
+    }
+}
+
+STATIC void StringStore_destroy(flouka_s* flouka_Ptr)
+{
+    flouka_StringChunk_s* chunk_Ptr;
+    flouka_StringChunk_s* nextChunk_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Release every chunk of the store, and the hash table.
+     */
+    for(chunk_Ptr = flouka_Ptr->stringChunkList_Ptr; NULL != chunk_Ptr; chunk_Ptr = nextChunk_Ptr)
+    {
+        nextChunk_Ptr = chunk_Ptr->next_Ptr;
+        flouka_Ptr->deallocationFunction_Ptr(chunk_Ptr);
+    }
+    flouka_Ptr->deallocationFunction_Ptr(flouka_Ptr->stringBucketList_Ptr);
+}
+
+STATIC flouka_NodeUpdates_s* NodeUpdates_create(flouka_s* flouka_Ptr)
+{
+    uint8* allocation_Ptr;
+    flouka_NodeUpdates_s* nodeUpdates_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate the structure and the numbers of updates at once, the numbers start at a cache
+     *    line of their own, and are padded to a whole cache line, so that the numbers of two threads
+     *    never share a cache line.
+     * 2. Clear the numbers of updates.
+     * 3. Link the structure to the list of the object, the lock of the object is taken since the
+     *    allocation function and the list may be used by other threads at the same time.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    allocation_Ptr = (uint8*) flouka_Ptr->allocationFunction_Ptr(sizeof(*nodeUpdates_Ptr)
+                    + (2 * FLOUKA_CACHE_LINE_SIZE)
+                    + (flouka_Ptr->epochShardsCount * sizeof(*nodeUpdates_Ptr->updatesList_Ptr)));
+    nodeUpdates_Ptr = (flouka_NodeUpdates_s*) allocation_Ptr;
+    nodeUpdates_Ptr->updatesList_Ptr
+                    = (uint32*) (((size_t) (allocation_Ptr + sizeof(*nodeUpdates_Ptr))
+                                    + FLOUKA_CACHE_LINE_SIZE - 1)
+                                    & ~((size_t) FLOUKA_CACHE_LINE_SIZE - 1));
+    memset(nodeUpdates_Ptr->updatesList_Ptr,
+           0,
+           flouka_Ptr->epochShardsCount * sizeof(*nodeUpdates_Ptr->updatesList_Ptr));
+    nodeUpdates_Ptr->owner_Ptr = &g_flouka_threadToken;
+    nodeUpdates_Ptr->next_Ptr = flouka_Ptr->nodeUpdatesList_Ptr;
+    __atomic_store_n(&(flouka_Ptr->nodeUpdatesList_Ptr), nodeUpdates_Ptr, __ATOMIC_RELEASE);
+
+    flouka_Ptr->unlockFunction_Ptr();
+
+    return (nodeUpdates_Ptr);
+}
+
+STATIC INLINE void NodeUpdates_count(flouka_s* flouka_Ptr,
+                                     uint32 nodeIndex)
+{
+    flouka_NodeUpdates_s* nodeUpdates_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Get the numbers of updates of the calling thread, the cached ones if the calling thread
+     *    updated the same object last time, otherwise search the list of the object for them, and
+     *    create them if the calling thread has none yet (as the deferred tables).
+     * 2. Count the update on the given node, the number is only changed by the calling thread, so
+     *    a relaxed load and store are enough (no read-modify-write), and the readers never see a
+     *    torn value.
+     */
+    if((flouka_Ptr == g_flouka_cachedNodeUpdatesOwner_Ptr)
+                    && (flouka_Ptr->instanceSerial == g_flouka_cachedNodeUpdatesSerial))
+    {
+        nodeUpdates_Ptr = g_flouka_cachedNodeUpdates_Ptr;
+    }
+    else
+    {
+        nodeUpdates_Ptr = __atomic_load_n(&(flouka_Ptr->nodeUpdatesList_Ptr), __ATOMIC_ACQUIRE);
+        while((NULL != nodeUpdates_Ptr) && (&g_flouka_threadToken != nodeUpdates_Ptr->owner_Ptr))
+        {
+            nodeUpdates_Ptr = nodeUpdates_Ptr->next_Ptr;
+        }
+        if(NULL == nodeUpdates_Ptr)
+        {
+            nodeUpdates_Ptr = NodeUpdates_create(flouka_Ptr);
+        }
+        g_flouka_cachedNodeUpdatesOwner_Ptr = flouka_Ptr;
+        g_flouka_cachedNodeUpdatesSerial = flouka_Ptr->instanceSerial;
+        g_flouka_cachedNodeUpdates_Ptr = nodeUpdates_Ptr;
+    }
+
+    __atomic_store_n(&(nodeUpdates_Ptr->updatesList_Ptr[nodeIndex]),
+                     __atomic_load_n(&(nodeUpdates_Ptr->updatesList_Ptr[nodeIndex]), __ATOMIC_RELAXED) + 1,
+                     __ATOMIC_RELAXED);
+}
+
+STATIC uint32 CounterStorage_claimShard(flouka_s* flouka_Ptr)
+{
+    uint32 shardIndex;
+    uint32 claimedCount;
+    uint32 privateCount;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the private shard of the calling thread if it claimed one already.
+     * 2. Otherwise, claim the next private shard (if any is left), and store the calling thread as
+     *    its owner.
+     * 3. If all the private shards are claimed, return the last shard, which is shared by all the
+     *    threads beyond the private shards (see CounterStorage_isShardAtomic).
+     *
+     * Note:
+     * The shards are claimed by an atomic addition, never under the lock of the object, since the
+     * shard may be looked up while the lock is held (ex. by CounterStorage_exchange).
+     */
+    privateCount = flouka_Ptr->epochShardsCount - 1;
+    claimedCount = __atomic_load_n(&(flouka_Ptr->shardOwnersCount), __ATOMIC_ACQUIRE);
+    for(shardIndex = 0; (shardIndex < claimedCount) && (shardIndex < privateCount); shardIndex++)
+    {
+        if(&g_flouka_threadToken == __atomic_load_n(&(flouka_Ptr->shardOwnerList_Ptr[shardIndex]), __ATOMIC_ACQUIRE))
+        {
+            return (shardIndex);
+        }
+    }
+
+    if(claimedCount < privateCount)
+    {
+        shardIndex = __atomic_fetch_add(&(flouka_Ptr->shardOwnersCount), 1, __ATOMIC_ACQ_REL);
+        if(shardIndex < privateCount)
+        {
+            __atomic_store_n(&(flouka_Ptr->shardOwnerList_Ptr[shardIndex]), &g_flouka_threadToken, __ATOMIC_RELEASE);
+            return (shardIndex);
+        }
+    }
+
+    return (privateCount);
+}
+
+STATIC INLINE bool CounterStorage_isShardAtomic(flouka_s* flouka_Ptr,
+                                                uint32 shardIndex)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return TRUE if the updates of the given shard must be atomic, which is the case in the
+     *    atomic mode, and for the last shard when the shards are given in round robin fashion,
+     *    since all the threads beyond the other shards share it.
+     *
+     * Note:
+     * The last shard is atomic from the start, even while it has a single thread, so that a
+     * thread joining it later never races a plain update of the first one.
+     */
+    return ((TRUE == flouka_Ptr->isAtomic)
+            || ((NULL == flouka_Ptr->shardIndexFunction_Ptr)
+                && (1 != flouka_Ptr->epochShardsCount)
+                && ((flouka_Ptr->epochShardsCount - 1) == shardIndex)));
+}
+
+STATIC INLINE uint32 CounterStorage_getShardIndex(flouka_s* flouka_Ptr)
+{
+    int cpu;
+    uint32 nodeIndex;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. If the counters are not sharded, return the first (and only) shard.
+     * 2. In the NUMA mode, return the node of the CPU the calling thread runs on (the first node if
+     *    the CPU is unknown), and count the update in the numbers of the calling thread.
+     * 3. If the user supplied a shard function, use it.
+     * 4. Otherwise, return the shard of the calling thread, the cached one if the calling thread
+     *    updated the same object last time, otherwise look it up in the object, or claim one (see
+     *    CounterStorage_claimShard).
+     *
+     * Note:
+     * When the snapshots are consistent, the returned index is inside the half of an epoch (see
+     * CounterStorage_beginUpdate).
+     */
+    if(1 == flouka_Ptr->epochShardsCount)
+    {
+        return (0);
+    }
+
+    if(NULL != flouka_Ptr->cpuNodeList_Ptr)
+    {
+        cpu = sched_getcpu();
+        nodeIndex = ((cpu >= 0) && ((uint32) cpu < flouka_Ptr->cpusCount)) ? flouka_Ptr->cpuNodeList_Ptr[cpu] : 0;
+        NodeUpdates_count(flouka_Ptr, nodeIndex);
+        return (nodeIndex);
+    }
+
+    if(NULL != flouka_Ptr->shardIndexFunction_Ptr)
+    {
+        return (flouka_Ptr->shardIndexFunction_Ptr() % flouka_Ptr->epochShardsCount);
+    }
+
+    if((flouka_Ptr != g_flouka_cachedThreadShardOwner_Ptr)
+                    || (flouka_Ptr->instanceSerial != g_flouka_cachedThreadShardSerial))
+    {
+        g_flouka_cachedThreadShardIndex = CounterStorage_claimShard(flouka_Ptr);
+        g_flouka_cachedThreadShardOwner_Ptr = flouka_Ptr;
+        g_flouka_cachedThreadShardSerial = flouka_Ptr->instanceSerial;
+    }
+
+    return (g_flouka_cachedThreadShardIndex);
+}
+
+STATIC INLINE uint32 CounterStorage_getSlot(flouka_s* flouka_Ptr,
+                                            uint32 counterID)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the location of the counter value inside a shard, which is the counter ID itself
+     *    unless the counters are placed by hints.
+     */
+    if(NULL == flouka_Ptr->counterSlotList_Ptr)
+    {
+        return (counterID);
+    }
+    return (flouka_Ptr->counterSlotList_Ptr[counterID]);
+}
+
+STATIC INLINE uint32* CounterStorage_beginUpdate(flouka_s* flouka_Ptr,
+                                                  uint32** writersCountPointer_Ptr,
+                                                  bool* isAtomic_Ptr)
+{
+    uint32 shardIndex;
+    uint32 epoch;
+    uint32* writersCount_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the start of the shard of the calling thread.
+     * 2. When the snapshots are consistent, announce the update in the writers count of the shard
+     *    in the current epoch, and check the epoch again, if a snapshot advanced it meanwhile,
+     *    withdraw and retry in the new epoch, then return the shard of the thread in the half of
+     *    the epoch.
+     *
+     * Note:
+     * The writers count (NULL unless the snapshots are consistent) is returned to be passed to
+     * CounterStorage_endUpdate once the update is done, a snapshot waits for the writers of the
+     * epoch it closes, so the update is either fully inside the snapshot or fully outside it.
+     *
+     * Whether the update of the shard must be atomic is returned too (see
+     * CounterStorage_isShardAtomic).
+     */
+    shardIndex = CounterStorage_getShardIndex(flouka_Ptr);
+    *isAtomic_Ptr = CounterStorage_isShardAtomic(flouka_Ptr, shardIndex);
+    if(NULL == flouka_Ptr->epochWritersList_Ptr)
+    {
+        *writersCountPointer_Ptr = NULL;
+        return (&(flouka_Ptr->fastPath.counterValuesList_Ptr[shardIndex * flouka_Ptr->shardStride]));
+    }
+
+    for(;;)
+    {
+        epoch = __atomic_load_n(&(flouka_Ptr->snapshotEpoch), __ATOMIC_SEQ_CST);
+        writersCount_Ptr = &(flouka_Ptr->epochWritersList_Ptr[(shardIndex * (FLOUKA_CACHE_LINE_SIZE / sizeof(uint32)))
+                        + (epoch & 1)]);
+        __atomic_fetch_add(writersCount_Ptr, 1, __ATOMIC_SEQ_CST);
+        if(epoch == __atomic_load_n(&(flouka_Ptr->snapshotEpoch), __ATOMIC_SEQ_CST))
+        {
+            break;
+        }
+        __atomic_fetch_sub(writersCount_Ptr, 1, __ATOMIC_RELEASE);
+    }
+    *writersCountPointer_Ptr = writersCount_Ptr;
+    return (&(flouka_Ptr->fastPath.counterValuesList_Ptr[(((epoch & 1) * flouka_Ptr->epochShardsCount) + shardIndex)
+                    * flouka_Ptr->shardStride]));
+}
+
+STATIC INLINE void CounterStorage_endUpdate(uint32* writersCount_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Withdraw the update from the writers count of its epoch (if counted), releasing the
+     *    written values to the snapshot waiting for it.
+     */
+    if(NULL != writersCount_Ptr)
+    {
+        __atomic_fetch_sub(writersCount_Ptr, 1, __ATOMIC_RELEASE);
+    }
+}
+
+STATIC INLINE void DeferredBuffer_lock(flouka_DeferredBuffer_s* buffer_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Spin until the busy flag of the table is taken, it is only held while moving the deltas.
+     */
+    while(__atomic_test_and_set(&(buffer_Ptr->isBusy), __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+STATIC INLINE void DeferredBuffer_unlock(flouka_DeferredBuffer_s* buffer_Ptr)
+{
+    __atomic_clear(&(buffer_Ptr->isBusy), __ATOMIC_RELEASE);
+}
+
+STATIC INLINE void DeferredBuffer_moveSlot(flouka_s* flouka_Ptr,
+                                           uint32* shard_Ptr,
+                                           flouka_DeferredSlot_s* slot_Ptr)
+{
+    uint32 total;
+    uint32 delta;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Take the part of the total of the slot that was not flushed yet, and remember the total as
+     *    flushed, the owner may be adding to the total concurrently, but it never resets it (no
+     *    read-modify-write is needed on either side), so whatever is added after the total is read
+     *    is moved by the next flush.
+     * 2. Add it to the counter in the given shard, which is the shard of the flushing thread (ex.
+     *    the copy on the node of the thread when the counters are sharded by the NUMA nodes).
+     *
+     * Note:
+     * The busy flag of the table must be held by the caller.
+     */
+    total = __atomic_load_n(&(slot_Ptr->total), __ATOMIC_RELAXED);
+    delta = total - slot_Ptr->flushed;
+    slot_Ptr->flushed = total;
+    if(0 != delta)
+    {
+        __atomic_fetch_add(&(shard_Ptr[CounterStorage_getSlot(flouka_Ptr, slot_Ptr->counterID)]),
+                           delta,
+                           __ATOMIC_RELAXED);
+    }
+}
+
+STATIC void DeferredBuffer_flush(flouka_s* flouka_Ptr,
+                                 flouka_DeferredBuffer_s* buffer_Ptr,
+                                 uint32* shard_Ptr)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Move the delta of every used slot to the given shard, the slots keep their counters so
+     *    that the next updates of the same counters do not need to claim the slots again (the
+     *    deferred mode is always atomic, so any shard may be given).
+     */
+    DeferredBuffer_lock(buffer_Ptr);
+    for(i = 0; i < flouka_Ptr->deferredSlotsCount; i++)
+    {
+        if(FLOUKA_DEFERRED_SLOT_EMPTY != buffer_Ptr->slotList_Ptr[i].counterID)
+        {
+            DeferredBuffer_moveSlot(flouka_Ptr, shard_Ptr, &(buffer_Ptr->slotList_Ptr[i]));
+        }
+    }
+    DeferredBuffer_unlock(buffer_Ptr);
+}
+
+STATIC flouka_DeferredBuffer_s* DeferredBuffer_create(flouka_s* flouka_Ptr)
+{
+    uint32 i;
+    uint8* allocation_Ptr;
+    flouka_DeferredBuffer_s* buffer_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate the table structure and its slots at once, the slots start at a cache line of
+     *    their own, so that the tables of two threads never share a cache line.
+     * 2. Mark all the slots as not used.
+     * 3. Link the table to the list of tables of the object, the lock of the object is taken since
+     *    the allocation function and the list may be used by other threads at the same time.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    allocation_Ptr = (uint8*) flouka_Ptr->allocationFunction_Ptr(sizeof(*buffer_Ptr)
+                    + FLOUKA_CACHE_LINE_SIZE
+                    + (flouka_Ptr->deferredSlotsCount * sizeof(*buffer_Ptr->slotList_Ptr)));
+    buffer_Ptr = (flouka_DeferredBuffer_s*) allocation_Ptr;
+    buffer_Ptr->slotList_Ptr
+                    = (flouka_DeferredSlot_s*) (((size_t) (allocation_Ptr + sizeof(*buffer_Ptr))
+                                    + FLOUKA_CACHE_LINE_SIZE - 1)
+                                    & ~((size_t) FLOUKA_CACHE_LINE_SIZE - 1));
+    for(i = 0; i < flouka_Ptr->deferredSlotsCount; i++)
+    {
+        buffer_Ptr->slotList_Ptr[i].counterID = FLOUKA_DEFERRED_SLOT_EMPTY;
+        buffer_Ptr->slotList_Ptr[i].total = 0;
+        buffer_Ptr->slotList_Ptr[i].flushed = 0;
+    }
+    buffer_Ptr->owner_Ptr = &g_flouka_threadToken;
+    buffer_Ptr->isBusy = FALSE;
+    buffer_Ptr->next_Ptr = flouka_Ptr->deferredBufferList_Ptr;
+    __atomic_store_n(&(flouka_Ptr->deferredBufferList_Ptr), buffer_Ptr, __ATOMIC_RELEASE);
+
+    flouka_Ptr->unlockFunction_Ptr();
+
+    return (buffer_Ptr);
+}
+
+STATIC INLINE flouka_DeferredBuffer_s* DeferredBuffer_get(flouka_s* flouka_Ptr)
+{
+    flouka_DeferredBuffer_s* buffer_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the cached table if the calling thread used the same object last time.
+     * 2. Otherwise, search the list of tables of the object for the one owned by the calling thread
+     *    (a thread that exits leaves its table behind, to be reused by a later thread that gets the
+     *    same thread local storage, or to be released with the object).
+     * 3. If the calling thread has no table yet, create one.
+     * 4. Cache the table for the next update.
+     */
+    if((flouka_Ptr == g_flouka_cachedDeferredOwner_Ptr)
+                    && (flouka_Ptr->instanceSerial == g_flouka_cachedDeferredSerial))
+    {
+        return (g_flouka_cachedDeferredBuffer_Ptr);
+    }
+
+    buffer_Ptr = __atomic_load_n(&(flouka_Ptr->deferredBufferList_Ptr), __ATOMIC_ACQUIRE);
+    while((NULL != buffer_Ptr) && (&g_flouka_threadToken != buffer_Ptr->owner_Ptr))
+    {
+        buffer_Ptr = buffer_Ptr->next_Ptr;
+    }
+
+    if(NULL == buffer_Ptr)
+    {
+        buffer_Ptr = DeferredBuffer_create(flouka_Ptr);
+    }
+
+    g_flouka_cachedDeferredOwner_Ptr = flouka_Ptr;
+    g_flouka_cachedDeferredSerial = flouka_Ptr->instanceSerial;
+    g_flouka_cachedDeferredBuffer_Ptr = buffer_Ptr;
+
+    return (buffer_Ptr);
+}
+
+STATIC INLINE void DeferredBuffer_add(flouka_s* flouka_Ptr,
+                                      uint32 counterID,
+                                      uint32 delta)
+{
+    flouka_DeferredBuffer_s* buffer_Ptr;
+    flouka_DeferredSlot_s* slot_Ptr;
+    uint32* shard_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Get the slot of the counter in the table of the calling thread.
+     * 2. If the slot is used by another counter, move its delta to the shard of the calling thread
+     *    and claim it, the shard is looked up before the busy flag is taken, since the first
+     *    lookup of a thread takes the lock of the object in the NUMA mode (see
+     *    NodeUpdates_create), which may be held by a thread collecting the table.
+     * 3. Add the delta to the total of the slot, the total is only written by the calling thread, so
+     *    a relaxed load and store are enough (no locked read-modify-write), and the collecting
+     *    threads never see a torn value (see DeferredBuffer_moveSlot).
+     */
+    buffer_Ptr = DeferredBuffer_get(flouka_Ptr);
+    slot_Ptr = &(buffer_Ptr->slotList_Ptr[counterID & (flouka_Ptr->deferredSlotsCount - 1)]);
+
+    if(counterID != slot_Ptr->counterID)
+    {
+        shard_Ptr = CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic);
+        DeferredBuffer_lock(buffer_Ptr);
+        if(FLOUKA_DEFERRED_SLOT_EMPTY != slot_Ptr->counterID)
+        {
+            DeferredBuffer_moveSlot(flouka_Ptr, shard_Ptr, slot_Ptr);
+        }
+        slot_Ptr->counterID = counterID;
+        DeferredBuffer_unlock(buffer_Ptr);
+        CounterStorage_endUpdate(writersCount_Ptr);
+    }
+
+    __atomic_store_n(&(slot_Ptr->total),
+                     __atomic_load_n(&(slot_Ptr->total), __ATOMIC_RELAXED) + delta,
+                     __ATOMIC_RELAXED);
+}
+
+STATIC void CounterStorage_collectDeferred(flouka_s* flouka_Ptr)
+{
+    flouka_DeferredBuffer_s* buffer_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Move the pending deltas of the tables of all the threads to the first shard.
+     *
+     * Note:
+     * The shard of the collecting thread is not looked up, the collecting thread usually holds the
+     * lock of the object (ex. while taking a snapshot), and the first lookup of a thread takes it in
+     * the NUMA mode (see NodeUpdates_create).
+     */
+    buffer_Ptr = __atomic_load_n(&(flouka_Ptr->deferredBufferList_Ptr), __ATOMIC_ACQUIRE);
+    while(NULL != buffer_Ptr)
+    {
+        DeferredBuffer_flush(flouka_Ptr, buffer_Ptr, flouka_Ptr->fastPath.counterValuesList_Ptr);
+        buffer_Ptr = buffer_Ptr->next_Ptr;
+    }
+}
+
+STATIC INLINE void CounterStorage_add(flouka_s* flouka_Ptr,
+                                      uint32 counterID,
+                                      uint32 delta)
+{
+    uint32* value_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Add the delta to the counter in the shard of the calling thread, using a relaxed atomic
+     *    addition if the shard is atomic (only the counter itself has to be consistent, no ordering
+     *    is needed with respect to any other memory).
+     * 2. In the deferred mode, add it to the table of the calling thread instead.
+     *
+     * Note:
+     * Whether the shard is atomic is returned by its lookup, since the last shard of the round
+     * robin threads is atomic even without the atomic mode (see CounterStorage_isShardAtomic).
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        DeferredBuffer_add(flouka_Ptr, counterID, delta);
+        return;
+    }
+
+    value_Ptr = &(CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic)[CounterStorage_getSlot(flouka_Ptr, counterID)]);
+    if(TRUE == isAtomic)
+    {
+        __atomic_fetch_add(value_Ptr, delta, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        *value_Ptr += delta;
+    }
+    CounterStorage_endUpdate(writersCount_Ptr);
+}
+
+STATIC INLINE void CounterStorage_subtract(flouka_s* flouka_Ptr,
+                                           uint32 counterID,
+                                           uint32 delta)
+{
+    uint32* value_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Subtract the delta from the counter in the shard of the calling thread, using a relaxed
+     *    atomic subtraction if the shard is atomic.
+     * 2. In the deferred mode, add the two's complement of the delta to the table of the calling
+     *    thread instead.
+     *
+     * Note:
+     * Whether the shard is atomic is returned by its lookup (see CounterStorage_add).
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        DeferredBuffer_add(flouka_Ptr, counterID, (0 - delta));
+        return;
+    }
+
+    value_Ptr = &(CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic)[CounterStorage_getSlot(flouka_Ptr, counterID)]);
+    if(TRUE == isAtomic)
+    {
+        __atomic_fetch_sub(value_Ptr, delta, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        *value_Ptr -= delta;
+    }
+    CounterStorage_endUpdate(writersCount_Ptr);
+}
+
+STATIC uint32 CounterStorage_read(flouka_s* flouka_Ptr,
+                                  uint32 counterID)
+{
+    uint32 shardIndex;
+    uint32 slot;
+    uint32* value_Ptr;
+    uint32 value = 0;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Sum the value of the counter in all the shards, the shards may wrap around individually
+     *    (ex. decremented in one shard and incremented in another) but the sum is still correct.
+     */
+    slot = CounterStorage_getSlot(flouka_Ptr, counterID);
+    for(shardIndex = 0; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+    {
+        value_Ptr = &(flouka_Ptr->fastPath.counterValuesList_Ptr[(shardIndex * flouka_Ptr->shardStride)
+                        + slot]);
+        if(TRUE == CounterStorage_isShardAtomic(flouka_Ptr, shardIndex))
+        {
+            value += __atomic_load_n(value_Ptr, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            value += *value_Ptr;
+        }
+    }
+    return (value);
+}
+
+STATIC uint32 CounterStorage_exchange(flouka_s* flouka_Ptr,
+                                      uint32 counterID,
+                                      uint32 value)
+{
+    uint32 shardIndex;
+    uint32 slot;
+    uint32* value_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+    uint32 oldValue = 0;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. In the deferred mode, collect the pending updates first, so they are not applied on top
+     *    of the new value later.
+     * 2. Store the value in the first shard, and clear the counter in all the other shards.
+     * 3. Return the sum of the replaced values, every atomic shard (see
+     *    CounterStorage_isShardAtomic) is swapped using an atomic exchange, so no concurrent update
+     *    is lost between reading and clearing it.
+     *
+     * Note:
+     * When the snapshots are consistent, the shards of the closed epoch are being read by the
+     * snapshot, so the difference between the new value and the old one is added to the shard of
+     * the calling thread instead, as any other update.
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        CounterStorage_collectDeferred(flouka_Ptr);
+    }
+
+    slot = CounterStorage_getSlot(flouka_Ptr, counterID);
+    if(NULL != flouka_Ptr->epochWritersList_Ptr)
+    {
+        oldValue = CounterStorage_read(flouka_Ptr, counterID);
+        value_Ptr = &(CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic)[slot]);
+        if(TRUE == isAtomic)
+        {
+            __atomic_fetch_add(value_Ptr, (value - oldValue), __ATOMIC_RELAXED);
+        }
+        else
+        {
+            *value_Ptr += (value - oldValue);
+        }
+        CounterStorage_endUpdate(writersCount_Ptr);
+        return (oldValue);
+    }
+
+    for(shardIndex = 0; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+    {
+        value_Ptr = &(flouka_Ptr->fastPath.counterValuesList_Ptr[(shardIndex * flouka_Ptr->shardStride)
+                        + slot]);
+        if(TRUE == CounterStorage_isShardAtomic(flouka_Ptr, shardIndex))
+        {
+            oldValue += __atomic_exchange_n(value_Ptr, value, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            oldValue += *value_Ptr;
+            *value_Ptr = value;
+        }
+        value = 0;
+    }
+    return (oldValue);
+}
+
+STATIC void CounterStorage_aggregate(flouka_s* flouka_Ptr,
+                                     uint32* statisticsBuffer_Ptr,
+                                     uint32 countersCount)
+{
+    uint32 i;
+    uint32 shardIndex;
+    uint32* shard_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Copy the first shard to the given buffer.
+     * 2. Add the rest of the shards to it, one shard at a time to keep the access sequential.
+     *
+     * Note:
+     * In the atomic mode, or when the counters are placed by hints, the shards are read counter by
+     * counter instead (using atomic loads in the atomic mode), so that the given buffer is always
+     * ordered by the counter IDs.
+     *
+     * The given buffer is zeroed and summed in place, so it must be private to the caller (ex. a
+     * snapshot buffer), never a buffer that another reader may be reading.
+     */
+    if((TRUE == flouka_Ptr->isAtomic) || (NULL != flouka_Ptr->counterSlotList_Ptr))
+    {
+        memset(statisticsBuffer_Ptr, 0, countersCount * sizeof(*statisticsBuffer_Ptr));
+        for(shardIndex = 0; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+        {
+            shard_Ptr = &(flouka_Ptr->fastPath.counterValuesList_Ptr[shardIndex * flouka_Ptr->shardStride]);
+            for(i = 0; i < countersCount; i++)
+            {
+                if(TRUE == flouka_Ptr->isAtomic)
+                {
+                    statisticsBuffer_Ptr[i] += __atomic_load_n(&(shard_Ptr[CounterStorage_getSlot(flouka_Ptr, i)]),
+                                                               __ATOMIC_RELAXED);
+                }
+                else
+                {
+                    statisticsBuffer_Ptr[i] += shard_Ptr[CounterStorage_getSlot(flouka_Ptr, i)];
+                }
+            }
+        }
+        return;
+    }
+
+    memcpy(statisticsBuffer_Ptr,
+           flouka_Ptr->fastPath.counterValuesList_Ptr,
+           countersCount * sizeof(*statisticsBuffer_Ptr));
+
+    for(shardIndex = 1; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+    {
+        shard_Ptr = &(flouka_Ptr->fastPath.counterValuesList_Ptr[shardIndex * flouka_Ptr->shardStride]);
+        for(i = 0; i < countersCount; i++)
+        {
+            statisticsBuffer_Ptr[i] += shard_Ptr[i];
+        }
+    }
+}
+
+STATIC void CounterStorage_collect(flouka_s* flouka_Ptr,
+                                   uint32* counterValuesList_Ptr,
+                                   uint32 countersCount)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Collect the pending updates of all the threads (only in the deferred mode).
+     * 2. Sum the shards into the given list if the counters are sharded or placed by hints (see
+     *    CounterStorage_aggregate).
+     * 3. Otherwise, copy the given number of counters to the given list (unless it is the list of
+     *    counters itself), using atomic loads in the atomic mode.
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        CounterStorage_collectDeferred(flouka_Ptr);
+    }
+
+    if(flouka_Ptr->statisticsBuffer_Ptr != flouka_Ptr->fastPath.counterValuesList_Ptr)
+    {
+        CounterStorage_aggregate(flouka_Ptr, counterValuesList_Ptr, countersCount);
+    }
+    else if(counterValuesList_Ptr != flouka_Ptr->fastPath.counterValuesList_Ptr)
+    {
+        if(TRUE == flouka_Ptr->isAtomic)
+        {
+            for(i = 0; i < countersCount; i++)
+            {
+                counterValuesList_Ptr[i] = __atomic_load_n(&(flouka_Ptr->fastPath.counterValuesList_Ptr[i]),
+                                                           __ATOMIC_RELAXED);
+            }
+        }
+        else
+        {
+            memcpy(counterValuesList_Ptr,
+                   flouka_Ptr->fastPath.counterValuesList_Ptr,
+                   countersCount * sizeof(*counterValuesList_Ptr));
+        }
+    }
+}
+
+STATIC uint32* CounterStorage_refresh(flouka_s* flouka_Ptr)
+{
+    uint32 i;
+    uint32 countersCount;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Collect the pending updates of all the threads (only in the deferred mode).
+     * 2. Sum every counter over the shards, and store the sum once into the statistics buffer (only
+     *    if the counters are sharded or placed by hints, otherwise the list of counters is the
+     *    statistics buffer itself).
+     * 3. Return the statistics buffer.
+     *
+     * Note:
+     * The statistics buffer is shared by all the callers of flouka_getStatistics, which may still
+     * be reading it, so every counter is overwritten by its new value in one store, it is never
+     * zeroed nor summed in place (see CounterStorage_aggregate).
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        CounterStorage_collectDeferred(flouka_Ptr);
+    }
+
+    if(flouka_Ptr->statisticsBuffer_Ptr != flouka_Ptr->fastPath.counterValuesList_Ptr)
+    {
+        countersCount = __atomic_load_n(&(flouka_Ptr->totalCountersCount), __ATOMIC_ACQUIRE);
+        for(i = 0; i < countersCount; i++)
+        {
+            __atomic_store_n(&(flouka_Ptr->statisticsBuffer_Ptr[i]),
+                             CounterStorage_read(flouka_Ptr, i),
+                             __ATOMIC_RELAXED);
+        }
+    }
+
+    return (flouka_Ptr->statisticsBuffer_Ptr);
+}
+
+STATIC uint32 CounterStorage_takeLine(flouka_s* flouka_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Take the next free cache line from the end of the shard, and return its first location.
+     * 2. Return zero if the lines left are reserved for the cold counters.
+     */
+    if((flouka_Ptr->lastPlacedLine - 1) < flouka_Ptr->coldLinesCount)
+    {
+        return (0);
+    }
+    flouka_Ptr->lastPlacedLine--;
+    return (flouka_Ptr->lastPlacedLine * (FLOUKA_CACHE_LINE_SIZE
+                    / sizeof(*flouka_Ptr->fastPath.counterValuesList_Ptr)));
+}
+
+STATIC void CounterStorage_placeCounter(flouka_s* flouka_Ptr,
+                                        uint32 counterID,
+                                        flouka_placement_e placement,
+                                        uint32 ownerIndex)
+{
+    uint32 slot = 0;
+    uint32 shardIndex;
+    uint32 countersPerCacheLine;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Hot counter: take a whole cache line for it.
+     * 2. Owned counter: use the next location in the current line of the owner, and take a new
+     *    line for the owner when it has none, or its line is full.
+     * 3. Cold counter, or no lines left (the cold lines always have room for all the counters):
+     *    use the next cold location.
+     * 4. Clear the value of the counter in all the shards (unless the counters are persisted, then
+     *    the value is cleared by PersistentStorage_restoreCounter only if it belongs to another
+     *    counter).
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    countersPerCacheLine = FLOUKA_CACHE_LINE_SIZE / sizeof(*flouka_Ptr->fastPath.counterValuesList_Ptr);
+
+    if(FLOUKA_PLACEMENT_HOT == placement)
+    {
+        slot = CounterStorage_takeLine(flouka_Ptr);
+    }
+    else if((FLOUKA_PLACEMENT_OWNER == placement) && (ownerIndex < flouka_Ptr->ownersCount))
+    {
+        slot = flouka_Ptr->ownerNextSlotList_Ptr[ownerIndex];
+        if(0 == (slot % countersPerCacheLine))
+        {
+            slot = CounterStorage_takeLine(flouka_Ptr);
+        }
+        if(0 != slot)
+        {
+            flouka_Ptr->ownerNextSlotList_Ptr[ownerIndex] = slot + 1;
+        }
+    }
+
+    if(0 == slot)
+    {
+        slot = flouka_Ptr->nextColdSlot;
+        flouka_Ptr->nextColdSlot++;
+    }
+
+    flouka_Ptr->counterSlotList_Ptr[counterID] = slot;
+    if(NULL != flouka_Ptr->persistentHeader_Ptr)
+    {
+        return;
+    }
+    for(shardIndex = 0; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+    {
+        flouka_Ptr->fastPath.counterValuesList_Ptr[(shardIndex * flouka_Ptr->shardStride) + slot] = 0;
+    }
+}
+
+STATIC uint32 CounterStorage_getShardStride(uint32 totalCountersCount,
+                                            const flouka_options_s* options_Ptr)
+{
+    uint32 countersPerCacheLine;
+    uint32 linesCount;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the size of a shard (in counters), which is the cold lines (enough for all the
+     *    counters), and when the counters are placed by hints, a line for every hot counter, a
+     *    spare line for every owner, and a last line for the unassigned counters.
+     */
+    countersPerCacheLine = FLOUKA_CACHE_LINE_SIZE / sizeof(uint32);
+    linesCount = (totalCountersCount + countersPerCacheLine - 1) / countersPerCacheLine;
+    if((0 != options_Ptr->hotCountersCount) || (0 != options_Ptr->ownersCount))
+    {
+        linesCount += options_Ptr->hotCountersCount + options_Ptr->ownersCount + 1;
+    }
+    return (linesCount * countersPerCacheLine);
+}
+
+STATIC bool CounterStorage_commit(uint8* reservation_Ptr,
+                                  uint32 shardsCount,
+                                  uint32 shardStride,
+                                  uint32 firstCounter,
+                                  uint32 lastCounter)
+{
+    uint32 shardIndex;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Make the memory of the counters from firstCounter up to (not including) lastCounter of
+     *    every shard readable and writable, both are whole segments, and the memory is zero until
+     *    it is first written.
+     * 2. Return FALSE if the memory cannot be committed (the committed part is harmless, it is
+     *    committed again by the next try).
+     */
+    for(shardIndex = 0; shardIndex < shardsCount; shardIndex++)
+    {
+        if(0 != mprotect(reservation_Ptr + ((((size_t) shardIndex * shardStride) + firstCounter) * sizeof(uint32)),
+                         (size_t) (lastCounter - firstCounter) * sizeof(uint32),
+                         PROT_READ | PROT_WRITE))
+        {
+            return (FALSE);
+        }
+    }
+    return (TRUE);
+}
+
+STATIC uint32 Numa_parseList(const char* path_Ptr,
+                             uint32* list_Ptr,
+                             uint32 listSize,
+                             uint32 value)
+{
+    FILE* file_Ptr;
+    char text[FLOUKA_NUMA_LIST_SIZE];
+    char* next_Ptr;
+    uint32 first;
+    uint32 last;
+    uint32 i;
+    uint32 count;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read the list (ex. "0-3,8-11") from the given file of the system, and return zero if it
+     *    cannot be read.
+     * 2. Set the entry of every number in the list to the given value in the given list (if any,
+     *    the numbers beyond its size are ignored).
+     * 3. Return the highest number in the list plus one.
+     */
+    file_Ptr = fopen(path_Ptr, "r");
+    if(NULL == file_Ptr)
+    {
+        return (0);
+    }
+    if(NULL == fgets(text, sizeof(text), file_Ptr))
+    {
+        text[0] = '\0';
+    }
+    fclose(file_Ptr);
+
+    count = 0;
+    next_Ptr = text;
+    while((*next_Ptr >= '0') && (*next_Ptr <= '9'))
+    {
+        first = (uint32) strtoul(next_Ptr, &next_Ptr, 10);
+        last = first;
+        if('-' == *next_Ptr)
+        {
+            last = (uint32) strtoul(next_Ptr + 1, &next_Ptr, 10);
+        }
+        for(i = first; (NULL != list_Ptr) && (i <= last) && (i < listSize); i++)
+        {
+            list_Ptr[i] = value;
+        }
+        if(last >= count)
+        {
+            count = last + 1;
+        }
+        if(',' == *next_Ptr)
+        {
+            next_Ptr++;
+        }
+    }
+    return (count);
+}
+
+STATIC uint32 Numa_getOnlineNodes(uint32* nodeIDList_Ptr)
+{
+    uint32 i;
+    uint32 nodesCount;
+    uint32 highestCount;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Mark the online nodes in the given list (of FLOUKA_NUMA_MAXIMUM_NODES entries).
+     * 2. Move the IDs of the marked nodes to the start of the list in ascending order (in place,
+     *    an ID is never written beyond its own entry), so that the node IDs may have gaps (ex.
+     *    "0,2").
+     * 3. Return the number of online nodes, zero if the list cannot be read.
+     */
+    memset(nodeIDList_Ptr, 0, FLOUKA_NUMA_MAXIMUM_NODES * sizeof(*nodeIDList_Ptr));
+    highestCount = Numa_parseList(FLOUKA_NUMA_ONLINE_NODES_PATH, nodeIDList_Ptr, FLOUKA_NUMA_MAXIMUM_NODES, TRUE);
+
+    nodesCount = 0;
+    for(i = 0; (i < highestCount) && (i < FLOUKA_NUMA_MAXIMUM_NODES); i++)
+    {
+        if(TRUE == nodeIDList_Ptr[i])
+        {
+            nodeIDList_Ptr[nodesCount] = i;
+            nodesCount++;
+        }
+    }
+    return (nodesCount);
+}
+
+STATIC void Numa_bind(void* memory_Ptr,
+                      size_t size,
+                      uint32 nodeIndex)
+{
+    unsigned long nodeMask[FLOUKA_NUMA_MAXIMUM_NODES / (8 * sizeof(unsigned long))];
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Prefer the given node for the given (page aligned) memory, moving the pages already
+     *    touched to it, the binding is only a hint, so it is ignored if it fails (ex. the kernel
+     *    does not support NUMA).
+     */
+    if(nodeIndex >= FLOUKA_NUMA_MAXIMUM_NODES)
+    {
+        return;
+    }
+    memset(nodeMask, 0, sizeof(nodeMask));
+    nodeMask[nodeIndex / (8 * sizeof(unsigned long))] = 1LU << (nodeIndex % (8 * sizeof(unsigned long)));
+    syscall(SYS_mbind,
+            memory_Ptr,
+            size,
+            FLOUKA_NUMA_MPOL_PREFERRED,
+            nodeMask,
+            (unsigned long) FLOUKA_NUMA_MAXIMUM_NODES + 1,
+            FLOUKA_NUMA_MPOL_MF_MOVE);
+}
+
+STATIC void PersistentStorage_restoreCounter(flouka_s* flouka_Ptr,
+                                             uint32 counterID)
+{
+    uint32 key;
+    uint32 slot;
+    uint32 shardIndex;
+    uint32* keyList_Ptr;
+    flouka_StatisticsCounterInfo_s* counterInfo_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Compute the key of the counter from its sub group, unit, name, and location.
+     * 2. Keep the persisted value if the counter ID was persisted with the same key, otherwise
+     *    clear the value in all the shards and persist the new key.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, and the counter must be placed already.
+     */
+    counterInfo_Ptr = &(flouka_Ptr->information.counterInfoList_Ptr[counterID]);
+    slot = CounterStorage_getSlot(flouka_Ptr, counterID);
+    key = PersistentStorage_hashValue(FLOUKA_KEY_OFFSET_BASIS, counterInfo_Ptr->subgroupID);
+    key = PersistentStorage_hashString(key, counterInfo_Ptr->unit_Ptr);
+    key = PersistentStorage_hashString(key, counterInfo_Ptr->counterName_Ptr);
+    key = PersistentStorage_hashValue(key, slot);
+    if(0 == key)
+    {
+        /*Zero is the key of the counter IDs that were never assigned*/
+        key = 1;
+    }
+
+    keyList_Ptr = PersistentStorage_getKeys_Ptr(flouka_Ptr->persistentHeader_Ptr);
+    if(key == keyList_Ptr[counterID])
+    {
+        return;
+    }
+    for(shardIndex = 0; shardIndex < flouka_Ptr->shardsCount; shardIndex++)
+    {
+        flouka_Ptr->fastPath.counterValuesList_Ptr[(shardIndex * flouka_Ptr->shardStride) + slot] = 0;
+    }
+    keyList_Ptr[counterID] = key;
+}
+
+STATIC void Snapshot_addHalf(flouka_s* flouka_Ptr,
+                             uint32* counterValuesList_Ptr,
+                             uint32 countersCount,
+                             uint32 half)
+{
+    uint32 i;
+    uint32 shardIndex;
+    uint32* shard_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Add the given number of counters of every shard in the given half to the given list.
+     *
+     * Note:
+     * The half must be closed (no update is writing to it), so plain loads are used.
+     */
+    for(shardIndex = 0; shardIndex < flouka_Ptr->epochShardsCount; shardIndex++)
+    {
+        shard_Ptr = &(flouka_Ptr->fastPath.counterValuesList_Ptr[((half * flouka_Ptr->epochShardsCount) + shardIndex)
+                        * flouka_Ptr->shardStride]);
+        for(i = 0; i < countersCount; i++)
+        {
+            counterValuesList_Ptr[i] += shard_Ptr[CounterStorage_getSlot(flouka_Ptr, i)];
+        }
+    }
+}
+
+STATIC void Snapshot_takeConsistent(flouka_s* flouka_Ptr,
+                                    uint32* counterValuesList_Ptr,
+                                    uint32 countersCount,
+                                    struct timespec* now_Ptr)
+{
+    uint32 epoch;
+    uint32 shardIndex;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Sum the half of the next epoch, it is closed since the previous snapshot waited for its
+     *    updates.
+     * 2. Advance the epoch, this is the point in time of the snapshot, the new updates go to the
+     *    half that was just summed (after it was summed).
+     * 3. Wait for the updates that started in the closed epoch to finish, then sum its half.
+     *
+     * Note:
+     * The lock of the object must be held by the caller (only the snapshots advance the epoch).
+     */
+    epoch = flouka_Ptr->snapshotEpoch;
+    memset(counterValuesList_Ptr, 0, countersCount * sizeof(*counterValuesList_Ptr));
+    Snapshot_addHalf(flouka_Ptr, counterValuesList_Ptr, countersCount, ((epoch + 1) & 1));
+
+    clock_gettime(CLOCK_MONOTONIC, now_Ptr);
+    __atomic_store_n(&(flouka_Ptr->snapshotEpoch), (epoch + 1), __ATOMIC_SEQ_CST);
+
+    for(shardIndex = 0; shardIndex < flouka_Ptr->epochShardsCount; shardIndex++)
+    {
+        while(0 != __atomic_load_n(&(flouka_Ptr->epochWritersList_Ptr[(shardIndex * (FLOUKA_CACHE_LINE_SIZE / sizeof(uint32)))
+                                        + (epoch & 1)]),
+                                   __ATOMIC_ACQUIRE))
+        {
+        }
+    }
+    Snapshot_addHalf(flouka_Ptr, counterValuesList_Ptr, countersCount, (epoch & 1));
+}
+
+STATIC void Snapshot_take(flouka_s* flouka_Ptr,
+                          uint32* counterValuesList_Ptr,
+                          uint32 countersCount,
+                          flouka_snapshotInfo_s* snapshotInfo_Ptr)
+{
+    struct timespec now;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. When the snapshots are consistent, take the snapshot at an epoch change (see
+     *    Snapshot_takeConsistent).
+     * 2. Otherwise, collect the given number of counters into the given list in one pass (see
+     *    CounterStorage_collect).
+     * 3. Number and time stamp the snapshot.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     *
+     * Without the consistent snapshots, the counters are read one by one while the updates go on,
+     * so every value is exact but the snapshot is not a single point in time (an update of two
+     * counters may be seen in one of them only).
+     */
+    if(NULL != flouka_Ptr->epochWritersList_Ptr)
+    {
+        Snapshot_takeConsistent(flouka_Ptr, counterValuesList_Ptr, countersCount, &now);
+    }
+    else
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        CounterStorage_collect(flouka_Ptr, counterValuesList_Ptr, countersCount);
+    }
+
+    flouka_Ptr->snapshotsCount++;
+    snapshotInfo_Ptr->sequenceNumber = flouka_Ptr->snapshotsCount;
+    snapshotInfo_Ptr->timestampSeconds = (uint32) now.tv_sec;
+    snapshotInfo_Ptr->timestampNanoseconds = (uint32) now.tv_nsec;
+}
+
+STATIC void StatisticsInformation_validateGroup(flouka_s* flouka_Ptr,
+                                                uint32 groupID,
+                                                const char* groupName_Ptr,
+                                                const char* groupDescription_Ptr COMMA()
+                                                FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the total number of assigned groups (less than maximum).
+     * 2. Validate the given group ID (less than maximum).
+     * 3. Validate the group assignment status (not assigned).
+     * 4. Validate the groupName_Ptr (not NULL).
+     * 5. Validate the groupName_Ptr (non empty string ("")).
+     * 6. Validate the groupDescription_Ptr (not NULL).
+     * 7. Validate the groupDescription_Ptr (non empty string ("")).
+     */
+    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount < flouka_Ptr->totalGroupsCount),
+                    "FLOUKA:  Maximum number of groups exceeded initialized value",
+                    fileName,
+                    lineNumber);
+    ASSERT((groupID < flouka_Ptr->totalGroupsCount),
+                    "FLOUKA:  groupID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((FALSE == flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned),
+                    "FLOUKA:  groupID is already assigned" ,
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != groupName_Ptr),
+                    "FLOUKA:  NULL was passed as the group name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != groupName_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the group name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != groupDescription_Ptr),
+                    "FLOUKA:  NULL was passed as the group description pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != groupDescription_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the group description pointer",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Set the group as assigned (tracked by the DEBUG build only), so that the sub groups
+     *    validated after it may belong to it, and a group given twice is caught.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, and the group is then assigned by
+     * StatisticsInformation_assignGroup.
+     */
+#ifdef DEBUG
+    flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned = TRUE;
+#endif /*DEBUG*/
+}
+
+STATIC void StatisticsInformation_assignGroup(flouka_s* flouka_Ptr,
+                                              uint32 groupID,
+                                              const char* groupName_Ptr,
+                                              const char* groupDescription_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Assign the group name (interned, the caller's string may be released after the call).
+     * 2. Assign the group description (interned).
+     * 3. Increment the number of assigned groups.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the group must be validated by
+     * StatisticsInformation_validateGroup first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    flouka_Ptr->information.groupInfoList_Ptr[groupID].groupName_Ptr = StringStore_intern(flouka_Ptr,
+                                                                                         groupName_Ptr);
+    flouka_Ptr->information.groupInfoList_Ptr[groupID].groupDescription_Ptr
+                    = StringStore_intern(flouka_Ptr, groupDescription_Ptr);
+    flouka_Ptr->information.sizes.assignedGroupsCount++;
+}
+
+STATIC void StatisticsInformation_validateSubGroup(flouka_s* flouka_Ptr,
+                                                   uint32 subgroupID,
+                                                   uint32 groupID,
+                                                   const char* subgroupName_Ptr,
+                                                   const char* subgroupDescription_Ptr COMMA()
+                                                   FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the total number of assigned sub groups (less than maximum).
+     * 2. Validate the given sub group ID (less than maximum).
+     * 3. Validate the given group ID (less than maximum).
+     * 4. Validate the sub group assignment status (not assigned).
+     * 5. Validate the group assignment status (assigned).
+     * 6. Validate the subgroupName_Ptr (not NULL).
+     * 7. Validate the subgroupName_Ptr (non empty string ("")).
+     * 8. Validate the subgroupDescription_Ptr (not NULL).
+     * 9. Validate the subgroupDescription_Ptr (non empty string ("")).
+     */
+    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount < flouka_Ptr->totalSubGroupsCount),
+                    "FLOUKA:  Maximum number of sub groups exceeded initialized value",
+                    fileName,
+                    lineNumber);
+    ASSERT((subgroupID < flouka_Ptr->totalSubGroupsCount),
+                    "FLOUKA:  subgroupID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((groupID < flouka_Ptr->totalGroupsCount),
+                    "FLOUKA:  groupID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((FALSE == flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned),
+                    "FLOUKA:  subgroupID is already assigned" ,
+                    fileName,
+                    lineNumber);
+    ASSERT((TRUE == flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned),
+                    "FLOUKA:  groupID is not assigned yet" ,
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != subgroupName_Ptr),
+                    "FLOUKA:  NULL was passed as the sub group name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != subgroupName_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the sub group name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != subgroupDescription_Ptr),
+                    "FLOUKA:  NULL was passed as the sub group description pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != subgroupDescription_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the sub group description pointer",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Set the sub group as assigned (tracked by the DEBUG build only), so that the counters
+     *    validated after it may belong to it, and a sub group given twice is caught.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, and the sub group is then assigned by
+     * StatisticsInformation_assignSubGroup.
+     */
+#ifdef DEBUG
+    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned = TRUE;
+#endif /*DEBUG*/
+}
+
+STATIC void StatisticsInformation_assignSubGroup(flouka_s* flouka_Ptr,
+                                                 uint32 subgroupID,
+                                                 uint32 groupID,
+                                                 const char* subgroupName_Ptr,
+                                                 const char* subgroupDescription_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Assign the parent group id.
+     * 2. Assign the sub group name (interned, the caller's string may be released after the call).
+     * 3. Assign the sub group description (interned).
+     * 4. Increment the number of assigned sub groups.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the sub group must be validated by
+     * StatisticsInformation_validateSubGroup first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].groupID = groupID;
+    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].subgroupName_Ptr
+                    = StringStore_intern(flouka_Ptr, subgroupName_Ptr);
+    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].subgroupDescription_Ptr
+                    = StringStore_intern(flouka_Ptr, subgroupDescription_Ptr);
+    flouka_Ptr->information.sizes.assignedSubGroupsCount++;
+}
+
+STATIC void StatisticsInformation_validateCounter(flouka_s* flouka_Ptr,
+                                                  uint32 counterID,
+                                                  uint32 subgroupID,
+                                                  const char* unit_Ptr,
+                                                  const char* counterName_Ptr,
+                                                  const char* counterDescription_Ptr,
+                                                  flouka_placement_e placement,
+                                                  uint32 ownerIndex COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the total number of assigned counters (less than maximum).
+     * 2. Validate the given counter ID (less than maximum).
+     * 3. Validate the given sub group ID (less than maximum).
+     * 4. Validate the sub group assignment status (assigned).
+     * 5. Validate the counter assignment status (not assigned).
+     * 6. Validate the counterName_Ptr (not NULL).
+     * 7. Validate the counterName_Ptr (non empty string ("")).
+     * 8. Validate the counterDescription_Ptr (not NULL).
+     * 9. Validate the counterDescription_Ptr (non empty string ("")).
+     * 10.Validate the unit_Ptr (not NULL).
+     * 11.Validate the unit_Ptr (non empty string ("")).
+     * 12.Validate the ownerIndex (less than the number of owners) for owned counters.
+     * 13.Validate the counter is not reserved by a family.
+     */
+    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount < flouka_Ptr->totalCountersCount),
+                    "FLOUKA:  Maximum number of counters exceeded initialized value",
+                    fileName,
+                    lineNumber);
+    ASSERT((counterID < flouka_Ptr->totalCountersCount),
+                    "FLOUKA:  CounterID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((subgroupID < flouka_Ptr->totalSubGroupsCount),
+                    "FLOUKA:  subgroupID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((TRUE == flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned),
+                    "FLOUKA:  subroupID is not assigned yet",
+                    fileName,
+                    lineNumber);
+    ASSERT((FALSE == flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned),
+                    "FLOUKA:  CounterID is already assigned",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != counterName_Ptr),
+                    "FLOUKA:  NULL was passed as the counter name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != counterName_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the counter name pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != counterDescription_Ptr),
+                    "FLOUKA:  NULL was passed as the counter description pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != counterDescription_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the counter description pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != unit_Ptr),
+                    "FLOUKA:  NULL was passed as the counter unit pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(('\0' != unit_Ptr[0]),
+                    "FLOUKA:  Empty string (\"\") was passed as the counter unit pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(((NULL == flouka_Ptr->counterSlotList_Ptr) || (FLOUKA_PLACEMENT_OWNER != placement)
+                    || (ownerIndex < flouka_Ptr->ownersCount)),
+                    "FLOUKA:  ownerIndex is outside of the owners count initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_UNASSIGNED_ID == flouka_Ptr->information.counterInfoList_Ptr[counterID].familyID),
+                    "FLOUKA:  CounterID is reserved by a family",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Set the counter as assigned (tracked by the DEBUG build only), so that a counter given
+     *    twice is caught.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, and the counter is then assigned by
+     * StatisticsInformation_assignCounter.
+     */
+#ifdef DEBUG
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned = TRUE;
+#endif /*DEBUG*/
+}
+
+STATIC void StatisticsInformation_assignCounter(flouka_s* flouka_Ptr,
+                                                uint32 counterID,
+                                                uint32 subgroupID,
+                                                const char* unit_Ptr,
+                                                const char* counterName_Ptr,
+                                                const char* counterDescription_Ptr,
+                                                flouka_placement_e placement,
+                                                uint32 ownerIndex)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Set the parent sub group id.
+     * 2. Assign the counter unit (interned, the caller's string may be released after the call).
+     * 3. Assign the counter name (interned).
+     * 4. Assign the counter description (interned, a description shared by many counters is
+     *    stored once).
+     * 5. Increment the number of assigned counters.
+     * 6. Place the counter value in memory according to the placement hint (if enabled).
+     * 7. Restore the persisted value of the counter if it was persisted for the same counter (if
+     *    the counters are persisted).
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the counter must be validated by
+     * StatisticsInformation_validateCounter first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterID = counterID;
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].subgroupID = subgroupID;
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].unit_Ptr = StringStore_intern(flouka_Ptr,
+                                                                                        unit_Ptr);
+
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterName_Ptr
+                    = StringStore_intern(flouka_Ptr, counterName_Ptr);
+    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterDescription_Ptr
+                    = StringStore_intern(flouka_Ptr, counterDescription_Ptr);
+    flouka_Ptr->information.sizes.assignedCountersCount++;
+    if(NULL != flouka_Ptr->counterSlotList_Ptr)
+    {
+        CounterStorage_placeCounter(flouka_Ptr, counterID, placement, ownerIndex);
+    }
+    if(NULL != flouka_Ptr->persistentHeader_Ptr)
+    {
+        PersistentStorage_restoreCounter(flouka_Ptr, counterID);
+    }
+}
+
+STATIC void StatisticsInformation_validateGroupList(flouka_s* flouka_Ptr,
+                                                    const flouka_groupDescriptor_s* groupList_Ptr,
+                                                    uint32 groupsCount COMMA()
+                                                    FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the groupList_Ptr (not NULL) if any group is given.
+     * 2. Validate the number of groups (the assigned ones and the given ones within maximum).
+     * 3. Every group is validated by StatisticsInformation_validateGroup.
+     */
+    ASSERT(((0 == groupsCount) || (NULL != groupList_Ptr)),
+                    "FLOUKA:  NULL was passed as the group descriptors pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((groupsCount <= (flouka_Ptr->totalGroupsCount - flouka_Ptr->information.sizes.assignedGroupsCount)),
+                    "FLOUKA:  Maximum number of groups exceeded initialized value",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Validate the given groups in their order in the list, before any of them is assigned.
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    for(i = 0; i < groupsCount; i++)
+    {
+        StatisticsInformation_validateGroup(flouka_Ptr,
+                                            groupList_Ptr[i].groupID,
+                                            groupList_Ptr[i].groupName_Ptr,
+                                            groupList_Ptr[i].groupDescription_Ptr COMMA()
+                                            FILE_AND_LINE_FOR_CALL());
+    }
+}
+
+STATIC void StatisticsInformation_validateSubGroupList(flouka_s* flouka_Ptr,
+                                                       const flouka_subGroupDescriptor_s* subGroupList_Ptr,
+                                                       uint32 subGroupsCount COMMA()
+                                                       FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the subGroupList_Ptr (not NULL) if any sub group is given.
+     * 2. Validate the number of sub groups (the assigned ones and the given ones within maximum).
+     * 3. Every sub group is validated by StatisticsInformation_validateSubGroup.
+     */
+    ASSERT(((0 == subGroupsCount) || (NULL != subGroupList_Ptr)),
+                    "FLOUKA:  NULL was passed as the sub group descriptors pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((subGroupsCount <= (flouka_Ptr->totalSubGroupsCount - flouka_Ptr->information.sizes.assignedSubGroupsCount)),
+                    "FLOUKA:  Maximum number of sub groups exceeded initialized value",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Validate the given sub groups in their order in the list, before any of them is assigned
+     *    (a sub group may belong to a group validated by the same call, or assigned by an earlier
+     *    one).
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    for(i = 0; i < subGroupsCount; i++)
+    {
+        StatisticsInformation_validateSubGroup(flouka_Ptr,
+                                               subGroupList_Ptr[i].subgroupID,
+                                               subGroupList_Ptr[i].groupID,
+                                               subGroupList_Ptr[i].subgroupName_Ptr,
+                                               subGroupList_Ptr[i].subgroupDescription_Ptr COMMA()
+                                               FILE_AND_LINE_FOR_CALL());
+    }
+}
+
+STATIC void StatisticsInformation_validateCounterList(flouka_s* flouka_Ptr,
+                                                      const flouka_counterDescriptor_s* counterList_Ptr,
+                                                      uint32 countersCount COMMA()
+                                                      FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the counterList_Ptr (not NULL) if any counter is given.
+     * 2. Validate the number of counters (the assigned ones and the given ones within maximum).
+     * 3. Every counter is validated by StatisticsInformation_validateCounter.
+     */
+    ASSERT(((0 == countersCount) || (NULL != counterList_Ptr)),
+                    "FLOUKA:  NULL was passed as the counter descriptors pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((countersCount <= (flouka_Ptr->totalCountersCount - flouka_Ptr->information.sizes.assignedCountersCount)),
+                    "FLOUKA:  Maximum number of counters exceeded initialized value",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Validate the given counters in their order in the list, as cold counters, before any of
+     *    them is assigned (a counter may belong to a sub group validated by the same call, or
+     *    assigned by an earlier one).
+     *
+     * Note:
+     * The lock of the object must be held by the caller.
+     */
+    for(i = 0; i < countersCount; i++)
+    {
+        StatisticsInformation_validateCounter(flouka_Ptr,
+                                              counterList_Ptr[i].counterID,
+                                              counterList_Ptr[i].subgroupID,
+                                              counterList_Ptr[i].unit_Ptr,
+                                              counterList_Ptr[i].counterName_Ptr,
+                                              counterList_Ptr[i].counterDescription_Ptr,
+                                              FLOUKA_PLACEMENT_COLD,
+                                              0 COMMA()
+                                              FILE_AND_LINE_FOR_CALL());
+    }
+}
+
+STATIC void StatisticsInformation_assignGroupList(flouka_s* flouka_Ptr,
+                                                  const flouka_groupDescriptor_s* groupList_Ptr,
+                                                  uint32 groupsCount)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Assign the given groups in their order in the list.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the groups must be validated by
+     * StatisticsInformation_validateGroupList first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    for(i = 0; i < groupsCount; i++)
+    {
+        StatisticsInformation_assignGroup(flouka_Ptr,
+                                          groupList_Ptr[i].groupID,
+                                          groupList_Ptr[i].groupName_Ptr,
+                                          groupList_Ptr[i].groupDescription_Ptr);
+    }
+}
+
+STATIC void StatisticsInformation_assignSubGroupList(flouka_s* flouka_Ptr,
+                                                     const flouka_subGroupDescriptor_s* subGroupList_Ptr,
+                                                     uint32 subGroupsCount)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Assign the given sub groups in their order in the list.
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the sub groups must be validated by
+     * StatisticsInformation_validateSubGroupList first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    for(i = 0; i < subGroupsCount; i++)
+    {
+        StatisticsInformation_assignSubGroup(flouka_Ptr,
+                                             subGroupList_Ptr[i].subgroupID,
+                                             subGroupList_Ptr[i].groupID,
+                                             subGroupList_Ptr[i].subgroupName_Ptr,
+                                             subGroupList_Ptr[i].subgroupDescription_Ptr);
+    }
+}
+
+STATIC void StatisticsInformation_assignCounterList(flouka_s* flouka_Ptr,
+                                                    const flouka_counterDescriptor_s* counterList_Ptr,
+                                                    uint32 countersCount)
+{
+    uint32 i;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Size the string store for a new name per counter (the units and descriptions are mostly
+     *    shared by many counters).
+     * 2. Assign the given counters in their order in the list, as cold counters (see
+     *    flouka_assignCounterWithPlacement).
+     *
+     * Note:
+     * The lock of the object must be held by the caller, the counters must be validated by
+     * StatisticsInformation_validateCounterList first, and the serialized information must be
+     * invalidated by the caller.
+     */
+    StringStore_reserve(flouka_Ptr, countersCount);
+    for(i = 0; i < countersCount; i++)
+    {
+        StatisticsInformation_assignCounter(flouka_Ptr,
+                                            counterList_Ptr[i].counterID,
+                                            counterList_Ptr[i].subgroupID,
+                                            counterList_Ptr[i].unit_Ptr,
+                                            counterList_Ptr[i].counterName_Ptr,
+                                            counterList_Ptr[i].counterDescription_Ptr,
+                                            FLOUKA_PLACEMENT_COLD,
+                                            0);
+    }
+}
+
+/***************************************************************************************************
+ *
+ *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+void flouka_getDefaultOptions(flouka_options_s* options_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Disable sharding (single list of counters shared by all threads).
+     * 2. Disable the atomic updates.
+     * 3. Disable the deferred updates.
+     * 4. Lay out the counters by their IDs (no placement hints).
+     * 5. Do not export the counters to shared memory.
+     * 6. Do not persist the counters.
+     * 7. Do not allow the object to grow.
+     * 8. Allocate the object with the allocation function (no arena, nor huge pages).
+     * 9. Do not shard the counters by the NUMA nodes.
+     * 10. Take the snapshots without the cooperation of the updates (not consistent).
+     */
+    options_Ptr->shardsCount = 1;
+    options_Ptr->shardIndexFunction_Ptr = NULL;
+    options_Ptr->isAtomic = FALSE;
+    options_Ptr->deferredSlotsCount = 0;
+    options_Ptr->hotCountersCount = 0;
+    options_Ptr->ownersCount = 0;
+    options_Ptr->sharedMemoryName_Ptr = NULL;
+    options_Ptr->sharedMemoryInformationSize = 0;
+    options_Ptr->isSharedMemoryAnonymous = FALSE;
+    options_Ptr->persistenceFileName_Ptr = NULL;
+    options_Ptr->maximumCountersCount = 0;
+    options_Ptr->isArenaAllocated = FALSE;
+    options_Ptr->hugePages = FLOUKA_HUGE_PAGES_NONE;
+    options_Ptr->isNumaLocal = FALSE;
+    options_Ptr->isSnapshotConsistent = FALSE;
+}
+
+flouka_status_e flouka_init(flouka_s** flouka_Pointer_Ptr,
+                            uint32 totalGroupsCount,
+                            uint32 totalSubGroupsCount,
+                            uint32 totalCountersCount,
+                            AllocFuncPtr allocationFunction_Ptr,
+                            DeallocFuncPtr deallocationFunction_Ptr,
+                            LockFuncPtr lockFunction_Ptr,
+                            UnlockFuncPtr unlockFunction_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    return (flouka_initWithOptions(flouka_Pointer_Ptr,
+                                   totalGroupsCount,
+                                   totalSubGroupsCount,
+                                   totalCountersCount,
+                                   allocationFunction_Ptr,
+                                   deallocationFunction_Ptr,
+                                   lockFunction_Ptr,
+                                   unlockFunction_Ptr,
+                                   NULL COMMA()
+                                   FILE_AND_LINE_FOR_CALL()));
+}
+
+flouka_status_e flouka_initWithOptions(flouka_s** flouka_Pointer_Ptr,
+                                       uint32 totalGroupsCount,
+                                       uint32 totalSubGroupsCount,
+                                       uint32 totalCountersCount,
+                                       AllocFuncPtr allocationFunction_Ptr,
+                                       DeallocFuncPtr deallocationFunction_Ptr,
+                                       LockFuncPtr lockFunction_Ptr,
+                                       UnlockFuncPtr unlockFunction_Ptr,
+                                       const flouka_options_s* options_Ptr COMMA()
+                                       FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32 countersPerCacheLine;
+    flouka_s* flouka_Ptr;
+    flouka_options_s options;
+    flouka_status_e status;
+    int32 sharedMemoryDescriptor;
+    uint32 shardStride;
+    uint32 segmentCountersCount;
+    uint32 committedCountersCount;
+    uint32 countersCapacity;
+    size_t reservationSize;
+    void* reservation_Ptr;
+    bool isPlaced;
+    size_t arenaSize;
+    size_t hotRegionOffset;
+    size_t pageSize;
+    uint8* arena_Ptr;
+    uint8* arenaNext_Ptr;
+    bool isNumaLocal;
+    uint32 nodesCount;
+    uint32 cpusCount;
+    uint32 epochShardsCount;
+    size_t valuesAlignment;
+    char path[FLOUKA_NUMA_PATH_SIZE];
+    uint32 nodeIDList[FLOUKA_NUMA_MAXIMUM_NODES];
+    flouka_sharedMemoryHeader_s* sharedMemory_Ptr;
+    flouka_PersistentHeader_s* persistentHeader_Ptr;
+
+    status = FLOUKA_STATUS_SUCCESS;
+
+    if(NULL == options_Ptr)
+    {
+        flouka_getDefaultOptions(&options);
+    }
+    else
+    {
+        options = *options_Ptr;
+    }
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (Must be NULL).
+     * 2. Validate the number of groups (non-zero).
+     * 3. Validate the number of sub groups (non-zero).
+     * 4. Validate the number of counters (non-zero).
+     * 5. Validate the allocation function pointer (not NULL).
+     * 6. Validate the deallocation function pointer (not NULL).
+     * 7. Validate the lock function pointer (not NULL).
+     * 8. Validate the unlock function pointer (not NULL).
+     * 9. Validate the number of shards (non-zero).
+     * 10. Validate the number of deferred slots (zero or power of two).
+     * 11. Validate the size of the shared memory information area (non-zero if exported).
+     * 12. Validate the maximum number of counters (zero or not less than the number of counters).
+     * 13. Validate that an object that may grow is not placed, exported, or persisted.
+     * 14. Validate that no shard function is given in the NUMA mode.
+     */
+    ASSERT((NULL == *flouka_Pointer_Ptr),
+                    "FLOUKA:  *flouka_Ptr pointer is not NULL, it is expected to initialize a NULL pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((totalGroupsCount> 0),
+                    "FLOUKA:  Total number of groups cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT((totalSubGroupsCount> 0),
+                    "FLOUKA:  Total number of sub groups cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT((totalCountersCount> 0),
+                    "FLOUKA:  Total number of counters cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != allocationFunction_Ptr),
+                    "FLOUKA:  allocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != deallocationFunction_Ptr),
+                    "FLOUKA:  deallocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != lockFunction_Ptr),
+                    "FLOUKA:  lock function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != unlockFunction_Ptr),
+                    "FLOUKA:  unlock function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((options.shardsCount > 0),
+                    "FLOUKA:  Number of shards cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT((0 == (options.deferredSlotsCount & (options.deferredSlotsCount - 1))),
+                    "FLOUKA:  Number of deferred slots must be a power of two",
+                    fileName,
+                    lineNumber);
+    ASSERT(((NULL == options.sharedMemoryName_Ptr) || (0 != options.sharedMemoryInformationSize)),
+                    "FLOUKA:  Size of the shared memory information area cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT(((0 == options.maximumCountersCount) || (options.maximumCountersCount >= totalCountersCount)),
+                    "FLOUKA:  Maximum number of counters cannot be less than the number of counters",
+                    fileName,
+                    lineNumber);
+    ASSERT(((FALSE == options.isNumaLocal) || (NULL == options.shardIndexFunction_Ptr)),
+                    "FLOUKA:  The shard function cannot be given in the NUMA mode",
+                    fileName,
+                    lineNumber);
+    ASSERT(((FALSE == options.isSnapshotConsistent) || (0 == options.deferredSlotsCount)),
+                    "FLOUKA:  The updates cannot be deferred when the snapshots are consistent",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Fail (creating nothing) if the object may grow and it is also placed, exported, or
+     *    persisted (their layouts are fixed by the initial number of counters), then map the file
+     *    the counters are persisted to (if persisted), create the shared memory segment (if
+     *    exported), and reserve the memory of the counters (if the object may grow), committing
+     *    the segments of the initial counters, and fail if any of them cannot be created.
+     * 2. Map the arena (if allocated from an arena), sized for the object, the information lists,
+     *    and the lists of the placed counters (the cold region), and then, from a new page, the
+     *    counters shards and the statistics buffer if they are allocated (the hot region), and
+     *    fail (releasing what is created by step 1) if it cannot be mapped.
+     * 3. Allocate the space needed for the statistics collector object using the given function
+     *    (or from the arena).
+     * 4. Allocate memory for the internal members, the counters shards are rounded up to a whole
+     *    number of cache lines, so that two threads updating different shards never share a line.
+     *    When the counters are placed by hints, every shard has the cold lines, a line for every
+     *    hot counter, a spare line for every owner, and a last line for the unassigned counters.
+     *    When the counters are persisted, the shards are the counters list of the file.
+     *    When the counters are exported and they are neither sharded, placed, nor persisted, the
+     *    list of counters is the counters area of the segment (the readers see the updates in
+     *    place).
+     *    When the object may grow, the shards are the reserved memory, every shard is sized for
+     *    the maximum number of counters (in whole segments), and the statistics buffer too.
+     *    In the NUMA mode (if there is more than one node), the shards are the nodes, every shard
+     *    starts on a page and is bound to its node (unless the counters are persisted), the node
+     *    of every CPU is listed (by its index among the online nodes), and the updates are atomic
+     *    (the threads on the CPUs of a node share its shard).
+     *    When the snapshots are consistent, the shards are doubled (the first half is updated in
+     *    the even epochs, and the second half in the odd ones), and the updates in progress of
+     *    every shard of a half are counted on a line of its own.
+     * 5. Save the passed parameters (e.g. totalGroupsCount).
+     * 6. Initialize all groups and counter to not-assigned.
+     *
+     * Note 1:
+     * flouka_Ptr is a double pointer, so that this function can change what it points to, the
+     * reason for this is to hide the details of the internal memory needed from the caller.
+     *
+     * Note 2:
+     * allocationFunction_Ptr is saved to the object only for the deferred mode, where the table of
+     * every thread is allocated on its first update (under the lock of the object).
+     */
+
+    if((options.maximumCountersCount > totalCountersCount)
+       && ((0 != options.hotCountersCount) || (0 != options.ownersCount)
+           || (NULL != options.sharedMemoryName_Ptr) || (NULL != options.persistenceFileName_Ptr)))
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    nodesCount = 1;
+    cpusCount = 0;
+    if(TRUE == options.isNumaLocal)
+    {
+        nodesCount = Numa_getOnlineNodes(nodeIDList);
+        if(0 == nodesCount)
+        {
+            nodesCount = 1;
+        }
+        options.shardsCount = nodesCount;
+        cpusCount = (uint32) sysconf(_SC_NPROCESSORS_CONF);
+    }
+    isNumaLocal = (nodesCount > 1);
+    valuesAlignment = (TRUE == isNumaLocal) ? pageSize : FLOUKA_CACHE_LINE_SIZE;
+    epochShardsCount = options.shardsCount;
+    if(TRUE == options.isSnapshotConsistent)
+    {
+        options.shardsCount *= 2;
+    }
+
+    countersCapacity = totalCountersCount;
+    shardStride = CounterStorage_getShardStride(totalCountersCount, &options);
+    if((TRUE == isNumaLocal) && (NULL == options.persistenceFileName_Ptr))
+    {
+        shardStride = ((shardStride + (pageSize / sizeof(uint32)) - 1) / (pageSize / sizeof(uint32)))
+                        * (pageSize / sizeof(uint32));
+    }
+    segmentCountersCount = 0;
+    committedCountersCount = 0;
+    reservationSize = 0;
+    reservation_Ptr = NULL;
+    if(options.maximumCountersCount > totalCountersCount)
+    {
+        countersCapacity = options.maximumCountersCount;
+        segmentCountersCount = (uint32) sysconf(_SC_PAGESIZE) / sizeof(uint32);
+        shardStride = CounterStorage_getShardStride(countersCapacity, &options);
+        shardStride = ((shardStride + segmentCountersCount - 1) / segmentCountersCount) * segmentCountersCount;
+        committedCountersCount = ((totalCountersCount + segmentCountersCount - 1) / segmentCountersCount)
+                        * segmentCountersCount;
+        reservationSize = (size_t) options.shardsCount * shardStride * sizeof(uint32);
+        reservation_Ptr = mmap(NULL,
+                               reservationSize,
+                               PROT_NONE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                               -1,
+                               0);
+        if(MAP_FAILED == reservation_Ptr)
+        {
+            return (FLOUKA_STATUS_FAILURE);
+        }
+        if(FALSE == CounterStorage_commit((uint8*) reservation_Ptr,
+                                          options.shardsCount,
+                                          shardStride,
+                                          0,
+                                          committedCountersCount))
+        {
+            munmap(reservation_Ptr, reservationSize);
+            return (FLOUKA_STATUS_FAILURE);
+        }
+    }
+
+    persistentHeader_Ptr = NULL;
+    if(NULL != options.persistenceFileName_Ptr)
+    {
+        persistentHeader_Ptr = PersistentStorage_open(options.persistenceFileName_Ptr,
+                                                      totalCountersCount,
+                                                      options.shardsCount,
+                                                      CounterStorage_getShardStride(totalCountersCount,
+                                                                                    &options));
+        if(NULL == persistentHeader_Ptr)
+        {
+            return (FLOUKA_STATUS_FAILURE);
+        }
+    }
+
+    sharedMemory_Ptr = NULL;
+    sharedMemoryDescriptor = -1;
+    if(NULL != options.sharedMemoryName_Ptr)
+    {
+        sharedMemory_Ptr = SharedMemory_create(options.sharedMemoryName_Ptr,
+                                               options.isSharedMemoryAnonymous,
+                                               totalCountersCount,
+                                               options.sharedMemoryInformationSize,
+                                               &sharedMemoryDescriptor);
+        if(NULL == sharedMemory_Ptr)
+        {
+            if(NULL != persistentHeader_Ptr)
+            {
+                munmap(persistentHeader_Ptr, persistentHeader_Ptr->fileSize);
+            }
+            return (FLOUKA_STATUS_FAILURE);
+        }
+    }
+
+    isPlaced = ((0 != options.hotCountersCount) || (0 != options.ownersCount));
+    arenaSize = 0;
+    hotRegionOffset = 0;
+    arena_Ptr = NULL;
+    if(TRUE == options.isArenaAllocated)
+    {
+        arenaSize = Arena_roundUp(sizeof(*flouka_Ptr))
+                        + Arena_roundUp(totalGroupsCount * sizeof(*flouka_Ptr->information.groupInfoList_Ptr))
+                        + Arena_roundUp(totalSubGroupsCount * sizeof(*flouka_Ptr->information.subgroupInfoList_Ptr))
+                        + Arena_roundUp(totalCountersCount * sizeof(*flouka_Ptr->information.counterInfoList_Ptr));
+        if(TRUE == isPlaced)
+        {
+            arenaSize += Arena_roundUp(totalCountersCount * sizeof(*flouka_Ptr->counterSlotList_Ptr))
+                            + Arena_roundUp(options.ownersCount * sizeof(*flouka_Ptr->ownerNextSlotList_Ptr));
+        }
+        if(TRUE == isNumaLocal)
+        {
+            arenaSize += Arena_roundUp(cpusCount * sizeof(*flouka_Ptr->cpuNodeList_Ptr));
+        }
+        if((1 != epochShardsCount) && (NULL == options.shardIndexFunction_Ptr) && (FALSE == isNumaLocal))
+        {
+            arenaSize += Arena_roundUp((epochShardsCount - 1) * sizeof(*flouka_Ptr->shardOwnerList_Ptr));
+        }
+        hotRegionOffset = ((arenaSize + pageSize - 1) / pageSize) * pageSize;
+        arenaSize = hotRegionOffset;
+        if((NULL == persistentHeader_Ptr) && (NULL == reservation_Ptr)
+           && ((NULL == sharedMemory_Ptr) || (1 != options.shardsCount) || (TRUE == isPlaced)))
+        {
+            arenaSize += Arena_roundUp(((size_t) options.shardsCount * shardStride * sizeof(uint32))
+                            + valuesAlignment);
+        }
+        if((1 != options.shardsCount) || (TRUE == isPlaced))
+        {
+            arenaSize += Arena_roundUp(countersCapacity * sizeof(*flouka_Ptr->statisticsBuffer_Ptr));
+        }
+        if(TRUE == options.isSnapshotConsistent)
+        {
+            arenaSize += Arena_roundUp(epochShardsCount * FLOUKA_CACHE_LINE_SIZE);
+        }
+        if(FLOUKA_HUGE_PAGES_NONE != options.hugePages)
+        {
+            pageSize = FLOUKA_HUGE_PAGE_SIZE;
+        }
+        arenaSize = ((arenaSize + pageSize - 1) / pageSize) * pageSize;
+
+        arena_Ptr = Arena_create(arenaSize, options.hugePages);
+        if(NULL == arena_Ptr)
+        {
+            if(NULL != reservation_Ptr)
+            {
+                munmap(reservation_Ptr, reservationSize);
+            }
+            if(NULL != persistentHeader_Ptr)
+            {
+                munmap(persistentHeader_Ptr, persistentHeader_Ptr->fileSize);
+            }
+            if(NULL != sharedMemory_Ptr)
+            {
+                munmap(sharedMemory_Ptr, sharedMemory_Ptr->segmentSize);
+                if(sharedMemoryDescriptor >= 0)
+                {
+                    close(sharedMemoryDescriptor);
+                }
+                if(FALSE == options.isSharedMemoryAnonymous)
+                {
+                    shm_unlink(options.sharedMemoryName_Ptr);
+                }
+            }
+            return (FLOUKA_STATUS_FAILURE);
+        }
+    }
+    arenaNext_Ptr = arena_Ptr;
+
+    flouka_Ptr = (flouka_s*) Arena_allocate(&arenaNext_Ptr, allocationFunction_Ptr, sizeof(*flouka_Ptr));
+    flouka_Ptr->arena_Ptr = arena_Ptr;
+    flouka_Ptr->arenaSize = arenaSize;
+    flouka_Ptr->information.groupInfoList_Ptr
+                    = (flouka_StatisticsGroupInfo_s*) Arena_allocate(&arenaNext_Ptr,
+                                    allocationFunction_Ptr,
+                                    totalGroupsCount * sizeof(*flouka_Ptr->information.groupInfoList_Ptr));
+    flouka_Ptr->information.subgroupInfoList_Ptr
+                    = (flouka_StatisticsSubGroupInfo_s*) Arena_allocate(&arenaNext_Ptr,
+                                    allocationFunction_Ptr,
+                                    totalSubGroupsCount * sizeof(*flouka_Ptr->information.subgroupInfoList_Ptr));
+    flouka_Ptr->information.counterInfoList_Ptr
+                    = (flouka_StatisticsCounterInfo_s*) Arena_allocate(&arenaNext_Ptr,
+                                    allocationFunction_Ptr,
+                                    totalCountersCount * sizeof(*flouka_Ptr->information.counterInfoList_Ptr));
+    flouka_Ptr->information.sizes.assignedGroupsCount = 0;
+    flouka_Ptr->information.sizes.assignedSubGroupsCount = 0;
+    flouka_Ptr->information.sizes.assignedCountersCount = 0;
+
+    countersPerCacheLine = FLOUKA_CACHE_LINE_SIZE / sizeof(*flouka_Ptr->fastPath.counterValuesList_Ptr);
+    flouka_Ptr->shardsCount = options.shardsCount;
+    flouka_Ptr->epochShardsCount = epochShardsCount;
+    flouka_Ptr->shardIndexFunction_Ptr = options.shardIndexFunction_Ptr;
+    flouka_Ptr->isAtomic = options.isAtomic;
+    flouka_Ptr->deferredSlotsCount = options.deferredSlotsCount;
+    flouka_Ptr->deferredBufferList_Ptr = NULL;
+    flouka_Ptr->instanceSerial = __atomic_add_fetch(&g_flouka_lastInstanceSerial, 1, __ATOMIC_RELAXED);
+    flouka_Ptr->fastPath.slowPathFlags = 0;
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        /*The deltas are moved to the shared counters by any thread, so they are added atomically*/
+        flouka_Ptr->isAtomic = TRUE;
+        flouka_Ptr->fastPath.slowPathFlags |= FLOUKA_SLOW_PATH_DEFERRED;
+    }
+    if(TRUE == isNumaLocal)
+    {
+        /*The threads running on the CPUs of a node share its shard, so they update it atomically*/
+        flouka_Ptr->isAtomic = TRUE;
+    }
+    if(1 != flouka_Ptr->shardsCount)
+    {
+        flouka_Ptr->fastPath.slowPathFlags |= FLOUKA_SLOW_PATH_SHARDED;
+    }
+    if(TRUE == flouka_Ptr->isAtomic)
+    {
+        flouka_Ptr->fastPath.slowPathFlags |= FLOUKA_SLOW_PATH_ATOMIC;
+    }
+    flouka_Ptr->coldLinesCount = (totalCountersCount + countersPerCacheLine - 1) / countersPerCacheLine;
+    flouka_Ptr->shardStride = shardStride;
+    flouka_Ptr->maximumCountersCount = countersCapacity;
+    flouka_Ptr->counterValuesReservation_Ptr = reservation_Ptr;
+    flouka_Ptr->counterValuesReservationSize = reservationSize;
+    flouka_Ptr->committedCountersCount = committedCountersCount;
+    flouka_Ptr->segmentCountersCount = segmentCountersCount;
+    flouka_Ptr->counterSlotList_Ptr = NULL;
+    flouka_Ptr->ownerNextSlotList_Ptr = NULL;
+    flouka_Ptr->ownersCount = options.ownersCount;
+    flouka_Ptr->nextColdSlot = 0;
+    if(TRUE == isPlaced)
+    {
+        flouka_Ptr->fastPath.slowPathFlags |= FLOUKA_SLOW_PATH_PLACED;
+        flouka_Ptr->lastPlacedLine = flouka_Ptr->coldLinesCount + options.hotCountersCount
+                        + options.ownersCount;
+        flouka_Ptr->counterSlotList_Ptr = (uint32*) Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        totalCountersCount * sizeof(*flouka_Ptr->counterSlotList_Ptr));
+        for(i = 0; i < totalCountersCount; i++)
+        {
+            flouka_Ptr->counterSlotList_Ptr[i] = flouka_Ptr->shardStride - 1;
+        }
+        if(0 != options.ownersCount)
+        {
+            flouka_Ptr->ownerNextSlotList_Ptr = (uint32*) Arena_allocate(&arenaNext_Ptr,
+                            allocationFunction_Ptr,
+                            options.ownersCount * sizeof(*flouka_Ptr->ownerNextSlotList_Ptr));
+            memset(flouka_Ptr->ownerNextSlotList_Ptr,
+                   0,
+                   options.ownersCount * sizeof(*flouka_Ptr->ownerNextSlotList_Ptr));
+        }
+    }
+    flouka_Ptr->cpuNodeList_Ptr = NULL;
+    flouka_Ptr->cpusCount = cpusCount;
+    flouka_Ptr->nodeUpdatesList_Ptr = NULL;
+    flouka_Ptr->shardOwnerList_Ptr = NULL;
+    flouka_Ptr->shardOwnersCount = 0;
+    if((1 != epochShardsCount) && (NULL == options.shardIndexFunction_Ptr) && (FALSE == isNumaLocal))
+    {
+        flouka_Ptr->shardOwnerList_Ptr = (const void**) Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        (epochShardsCount - 1) * sizeof(*flouka_Ptr->shardOwnerList_Ptr));
+        memset(flouka_Ptr->shardOwnerList_Ptr, 0, (epochShardsCount - 1) * sizeof(*flouka_Ptr->shardOwnerList_Ptr));
+    }
+    if(TRUE == isNumaLocal)
+    {
+        flouka_Ptr->cpuNodeList_Ptr = (uint32*) Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        cpusCount * sizeof(*flouka_Ptr->cpuNodeList_Ptr));
+        memset(flouka_Ptr->cpuNodeList_Ptr, 0, cpusCount * sizeof(*flouka_Ptr->cpuNodeList_Ptr));
+        for(i = 0; i < nodesCount; i++)
+        {
+            snprintf(path, sizeof(path), FLOUKA_NUMA_NODE_CPUS_PATH, nodeIDList[i]);
+            Numa_parseList(path, flouka_Ptr->cpuNodeList_Ptr, cpusCount, i);
+        }
+    }
+    flouka_Ptr->sharedMemory_Ptr = sharedMemory_Ptr;
+    flouka_Ptr->sharedMemoryName_Ptr = options.sharedMemoryName_Ptr;
+    flouka_Ptr->isSharedMemoryAnonymous = options.isSharedMemoryAnonymous;
+    flouka_Ptr->sharedMemoryDescriptor = sharedMemoryDescriptor;
+    flouka_Ptr->persistentHeader_Ptr = persistentHeader_Ptr;
+    if(NULL != arena_Ptr)
+    {
+        arenaNext_Ptr = arena_Ptr + hotRegionOffset;
+    }
+    if(NULL != persistentHeader_Ptr)
+    {
+        flouka_Ptr->counterValuesAllocation_Ptr = NULL;
+        flouka_Ptr->fastPath.counterValuesList_Ptr = PersistentStorage_getCounters_Ptr(persistentHeader_Ptr);
+    }
+    else if(NULL != reservation_Ptr)
+    {
+        flouka_Ptr->counterValuesAllocation_Ptr = NULL;
+        flouka_Ptr->fastPath.counterValuesList_Ptr = (uint32*) reservation_Ptr;
+    }
+    else if((NULL != sharedMemory_Ptr) && (1 == flouka_Ptr->shardsCount)
+            && (NULL == flouka_Ptr->counterSlotList_Ptr))
+    {
+        sharedMemory_Ptr->isLive = TRUE;
+        flouka_Ptr->counterValuesAllocation_Ptr = NULL;
+        flouka_Ptr->fastPath.counterValuesList_Ptr = SharedMemory_getCounters_Ptr(sharedMemory_Ptr);
+    }
+    else
+    {
+        flouka_Ptr->counterValuesAllocation_Ptr = Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        ((size_t) flouka_Ptr->shardsCount * flouka_Ptr->shardStride
+                         * sizeof(*flouka_Ptr->fastPath.counterValuesList_Ptr)) + valuesAlignment);
+        flouka_Ptr->fastPath.counterValuesList_Ptr
+                        = (uint32*) (((size_t) flouka_Ptr->counterValuesAllocation_Ptr
+                                        + valuesAlignment - 1)
+                                        & ~(valuesAlignment - 1));
+    }
+    if((TRUE == isNumaLocal) && (NULL == persistentHeader_Ptr))
+    {
+        for(i = 0; i < flouka_Ptr->shardsCount; i++)
+        {
+            Numa_bind(&(flouka_Ptr->fastPath.counterValuesList_Ptr[i * flouka_Ptr->shardStride]),
+                      flouka_Ptr->shardStride * sizeof(*flouka_Ptr->fastPath.counterValuesList_Ptr),
+                      nodeIDList[i % flouka_Ptr->epochShardsCount]);
+        }
+    }
+
+    if((1 == flouka_Ptr->shardsCount) && (NULL == flouka_Ptr->counterSlotList_Ptr))
+    {
+        flouka_Ptr->statisticsBuffer_Ptr = flouka_Ptr->fastPath.counterValuesList_Ptr;
+    }
+    else
+    {
+        flouka_Ptr->statisticsBuffer_Ptr = (uint32*) Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        countersCapacity * sizeof(*flouka_Ptr->statisticsBuffer_Ptr));
+    }
+    flouka_Ptr->snapshotEpoch = 0;
+    flouka_Ptr->epochWritersList_Ptr = NULL;
+    if(TRUE == options.isSnapshotConsistent)
+    {
+        flouka_Ptr->epochWritersList_Ptr = (uint32*) Arena_allocate(&arenaNext_Ptr,
+                        allocationFunction_Ptr,
+                        epochShardsCount * FLOUKA_CACHE_LINE_SIZE);
+        memset(flouka_Ptr->epochWritersList_Ptr, 0, epochShardsCount * FLOUKA_CACHE_LINE_SIZE);
+    }
+    flouka_Ptr->allocationFunction_Ptr = allocationFunction_Ptr;
+    flouka_Ptr->deallocationFunction_Ptr = deallocationFunction_Ptr;
+    flouka_Ptr->lockFunction_Ptr = lockFunction_Ptr;
+    flouka_Ptr->unlockFunction_Ptr = unlockFunction_Ptr;
+    flouka_Ptr->informationCache_Ptr = NULL;
+    flouka_Ptr->informationCacheSize = 0;
+    flouka_Ptr->indexCache_Ptr = NULL;
+    flouka_Ptr->indexCacheSize = 0;
+    flouka_Ptr->membershipIndex_Ptr = NULL;
+    flouka_Ptr->schemaGeneration = 0;
+    flouka_Ptr->snapshotList[0].counterValuesList_Ptr = NULL;
+    flouka_Ptr->snapshotList[0].countersCount = 0;
+    flouka_Ptr->snapshotList[1].counterValuesList_Ptr = NULL;
+    flouka_Ptr->snapshotList[1].countersCount = 0;
+    flouka_Ptr->snapshotsCount = 0;
+    flouka_Ptr->totalGroupsCount = totalGroupsCount;
+    flouka_Ptr->totalSubGroupsCount = totalSubGroupsCount;
+    flouka_Ptr->totalCountersCount = totalCountersCount;
+    flouka_Ptr->groupsCapacity = totalGroupsCount;
+    flouka_Ptr->subGroupsCapacity = totalSubGroupsCount;
+    flouka_Ptr->countersCapacity = totalCountersCount;
+    flouka_Ptr->retiredListList_Ptr = NULL;
+    flouka_Ptr->sparseCounterList_Ptr = NULL;
+    flouka_Ptr->sparseCountersCount = 0;
+    flouka_Ptr->sparseCountersCapacity = 0;
+    flouka_Ptr->nextSparseCounterID = 0;
+    flouka_Ptr->sparseTable_Ptr = NULL;
+    flouka_Ptr->sparseTableMask = 0;
+    flouka_Ptr->familyList_Ptr = NULL;
+    flouka_Ptr->familiesCount = 0;
+    flouka_Ptr->familiesCapacity = 0;
+    flouka_Ptr->stringChunkList_Ptr = NULL;
+    flouka_Ptr->stringBucketList_Ptr
+                    = (flouka_InternedString_s**) allocationFunction_Ptr(FLOUKA_STRING_BUCKETS_COUNT
+                                    * sizeof(*flouka_Ptr->stringBucketList_Ptr));
+    memset(flouka_Ptr->stringBucketList_Ptr,
+           0,
+           FLOUKA_STRING_BUCKETS_COUNT * sizeof(*flouka_Ptr->stringBucketList_Ptr));
+    flouka_Ptr->stringBucketsMask = FLOUKA_STRING_BUCKETS_COUNT - 1;
+    flouka_Ptr->stringsCount = 0;
+    flouka_Ptr->emptyString_Ptr = StringStore_intern(flouka_Ptr, "");
+
+    StatisticsInformation_clear(flouka_Ptr, 0, 0, 0, totalCountersCount);
+#ifdef DEBUG
+    flouka_Ptr->initializationPattern = FLOUKA_INITIALIZATION_PATTEREN;
+#endif /*DEBUG*/
+    *flouka_Pointer_Ptr = flouka_Ptr;
+    return status;
+}
+
+void flouka_destroy(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32 j;
+    uint8* arena_Ptr;
+    size_t arenaSize;
+    DeallocFuncPtr deallocationFunctionPointer;
+    flouka_DeferredBuffer_s* buffer_Ptr;
+    flouka_DeferredBuffer_s* nextBuffer_Ptr;
+    flouka_RetiredList_s* retiredList_Ptr;
+    flouka_RetiredList_s* nextRetiredList_Ptr;
+    flouka_NodeUpdates_s* nodeUpdates_Ptr;
+    flouka_NodeUpdates_s* nextNodeUpdates_Ptr;
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not null).
+     * 2. Validate the flouka_Ptr (already initialized).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_INITIALIZATION_PATTEREN == flouka_Ptr->initializationPattern),
+                    "FLOUKA:  Invalid statistics counter pointer passed (either not initialized pointer, or incorrect, non-null pointer)",
+                    fileName,
+                    lineNumber);
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Get the pointer to the deallocation function.
+     * 2. Deallocate all the internal member (including the sparse IDs, the families with the
+     *    labels of their instances, and the string store), remove the shared memory segment (if any), unmap the file the
+     *    counters are persisted to (if any, the file is kept for the next run), and release the
+     *    memory reserved for the counters (if the object may grow), the members taken from the
+     *    arena are released with it.
+     * 3. Deallocate the flouka_Ptr itself, or unmap the arena if the object is allocated from it.
+     * 4. Set the flouka_Ptr to NULL to prevent invalid access.
+     */
+    deallocationFunctionPointer = flouka_Ptr->deallocationFunction_Ptr;
+    arena_Ptr = flouka_Ptr->arena_Ptr;
+    arenaSize = flouka_Ptr->arenaSize;
+    Arena_deallocate(flouka_Ptr, flouka_Ptr->information.groupInfoList_Ptr);
+    Arena_deallocate(flouka_Ptr, flouka_Ptr->information.subgroupInfoList_Ptr);
+    Arena_deallocate(flouka_Ptr, flouka_Ptr->information.counterInfoList_Ptr);
+    if(flouka_Ptr->statisticsBuffer_Ptr != flouka_Ptr->fastPath.counterValuesList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->statisticsBuffer_Ptr);
+    }
+    if(NULL != flouka_Ptr->counterValuesAllocation_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->counterValuesAllocation_Ptr);
+    }
+    if(NULL != flouka_Ptr->sharedMemory_Ptr)
+    {
+        munmap(flouka_Ptr->sharedMemory_Ptr, flouka_Ptr->sharedMemory_Ptr->segmentSize);
+        if(flouka_Ptr->sharedMemoryDescriptor >= 0)
+        {
+            close(flouka_Ptr->sharedMemoryDescriptor);
+        }
+        if(FALSE == flouka_Ptr->isSharedMemoryAnonymous)
+        {
+            shm_unlink(flouka_Ptr->sharedMemoryName_Ptr);
+        }
+    }
+    if(NULL != flouka_Ptr->persistentHeader_Ptr)
+    {
+        munmap(flouka_Ptr->persistentHeader_Ptr, flouka_Ptr->persistentHeader_Ptr->fileSize);
+    }
+    if(NULL != flouka_Ptr->counterValuesReservation_Ptr)
+    {
+        munmap(flouka_Ptr->counterValuesReservation_Ptr, flouka_Ptr->counterValuesReservationSize);
+    }
+    if(NULL != flouka_Ptr->counterSlotList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->counterSlotList_Ptr);
+    }
+    if(NULL != flouka_Ptr->ownerNextSlotList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->ownerNextSlotList_Ptr);
+    }
+    if(NULL != flouka_Ptr->cpuNodeList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->cpuNodeList_Ptr);
+    }
+    for(nodeUpdates_Ptr = flouka_Ptr->nodeUpdatesList_Ptr; NULL != nodeUpdates_Ptr; nodeUpdates_Ptr = nextNodeUpdates_Ptr)
+    {
+        nextNodeUpdates_Ptr = nodeUpdates_Ptr->next_Ptr;
+        deallocationFunctionPointer(nodeUpdates_Ptr);
+    }
+    if(NULL != flouka_Ptr->shardOwnerList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->shardOwnerList_Ptr);
+    }
+    if(NULL != flouka_Ptr->epochWritersList_Ptr)
+    {
+        Arena_deallocate(flouka_Ptr, flouka_Ptr->epochWritersList_Ptr);
+    }
+    for(retiredList_Ptr = flouka_Ptr->retiredListList_Ptr; NULL != retiredList_Ptr; retiredList_Ptr = nextRetiredList_Ptr)
+    {
+        nextRetiredList_Ptr = retiredList_Ptr->next_Ptr;
+        Arena_deallocate(flouka_Ptr, retiredList_Ptr->list_Ptr);
+        deallocationFunctionPointer(retiredList_Ptr);
+    }
+    if(NULL != flouka_Ptr->informationCache_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->informationCache_Ptr);
+    }
+    if(NULL != flouka_Ptr->indexCache_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->indexCache_Ptr);
+    }
+    if(NULL != flouka_Ptr->membershipIndex_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->membershipIndex_Ptr);
+    }
+    if(NULL != flouka_Ptr->snapshotList[0].counterValuesList_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->snapshotList[0].counterValuesList_Ptr);
+    }
+    if(NULL != flouka_Ptr->snapshotList[1].counterValuesList_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->snapshotList[1].counterValuesList_Ptr);
+    }
+    for(buffer_Ptr = flouka_Ptr->deferredBufferList_Ptr; NULL != buffer_Ptr; buffer_Ptr = nextBuffer_Ptr)
+    {
+        nextBuffer_Ptr = buffer_Ptr->next_Ptr;
+        deallocationFunctionPointer(buffer_Ptr);
+    }
+    if(NULL != flouka_Ptr->sparseCounterList_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->sparseCounterList_Ptr);
+    }
+    if(NULL != flouka_Ptr->sparseTable_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->sparseTable_Ptr);
+    }
+    for(i = 0; i < flouka_Ptr->familiesCount; i++)
+    {
+        if(FLOUKA_UNASSIGNED_ID == flouka_Ptr->familyList_Ptr[i].groupID)
+        {
+            continue;
+        }
+        for(j = 0; j < flouka_Ptr->familyList_Ptr[i].instancesCount; j++)
+        {
+            if(NULL != flouka_Ptr->familyList_Ptr[i].labelList_Ptr[j])
+            {
+                deallocationFunctionPointer(flouka_Ptr->familyList_Ptr[i].labelList_Ptr[j]);
+            }
+        }
+        deallocationFunctionPointer(flouka_Ptr->familyList_Ptr[i].memberInfoList_Ptr);
+        deallocationFunctionPointer(flouka_Ptr->familyList_Ptr[i].labelList_Ptr);
+        deallocationFunctionPointer(flouka_Ptr->familyList_Ptr[i].freeSlotList_Ptr);
+    }
+    if(NULL != flouka_Ptr->familyList_Ptr)
+    {
+        deallocationFunctionPointer(flouka_Ptr->familyList_Ptr);
+    }
+    StringStore_destroy(flouka_Ptr);
+    if(NULL != arena_Ptr)
+    {
+        munmap(arena_Ptr, arenaSize);
+    }
+    else
+    {
+        deallocationFunctionPointer((void*) flouka_Ptr);
+    }
+    flouka_Ptr = NULL;
+}
+
+flouka_status_e flouka_grow(flouka_s* flouka_Ptr,
+                            uint32 totalGroupsCount,
+                            uint32 totalSubGroupsCount,
+                            uint32 totalCountersCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 firstGroupID;
+    uint32 firstSubGroupID;
+    uint32 firstCounterID;
+    uint32 committedCountersCount;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access, the information lists are only read under the lock.
+     * 2. Fail (changing nothing) if the counters exceed the maximum, or the memory of their
+     *    segments cannot be committed.
+     * 3. Grow the information lists (if needed), mark the new IDs as not assigned, and invalidate
+     *    the serialized information (if anything grew).
+     * 4. Publish the new number of counters last, after their memory is committed and the cached
+     *    information is dropped, so that a reader that sees it reads committed memory and never
+     *    pairs it with the information of the old counters (the updates of the existing counters
+     *    never stop).
+     * 5. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    firstGroupID = flouka_Ptr->totalGroupsCount;
+    firstSubGroupID = flouka_Ptr->totalSubGroupsCount;
+    firstCounterID = flouka_Ptr->totalCountersCount;
+    if(totalCountersCount > flouka_Ptr->maximumCountersCount)
+    {
+        flouka_Ptr->unlockFunction_Ptr();
+        return (FLOUKA_STATUS_FAILURE);
+    }
+    if((NULL != flouka_Ptr->counterValuesReservation_Ptr)
+       && (totalCountersCount > flouka_Ptr->committedCountersCount))
+    {
+        committedCountersCount = ((totalCountersCount + flouka_Ptr->segmentCountersCount - 1)
+                        / flouka_Ptr->segmentCountersCount) * flouka_Ptr->segmentCountersCount;
+        if(FALSE == CounterStorage_commit((uint8*) flouka_Ptr->counterValuesReservation_Ptr,
+                                          flouka_Ptr->shardsCount,
+                                          flouka_Ptr->shardStride,
+                                          flouka_Ptr->committedCountersCount,
+                                          committedCountersCount))
+        {
+            flouka_Ptr->unlockFunction_Ptr();
+            return (FLOUKA_STATUS_FAILURE);
+        }
+        flouka_Ptr->committedCountersCount = committedCountersCount;
+    }
+
+    if(totalGroupsCount > firstGroupID)
+    {
+        flouka_Ptr->information.groupInfoList_Ptr
+                        = (flouka_StatisticsGroupInfo_s*) StatisticsInformation_growList(flouka_Ptr,
+                                        flouka_Ptr->information.groupInfoList_Ptr,
+                                        sizeof(*flouka_Ptr->information.groupInfoList_Ptr),
+                                        totalGroupsCount,
+                                        &(flouka_Ptr->groupsCapacity));
+        flouka_Ptr->totalGroupsCount = totalGroupsCount;
+    }
+    if(totalSubGroupsCount > firstSubGroupID)
+    {
+        flouka_Ptr->information.subgroupInfoList_Ptr
+                        = (flouka_StatisticsSubGroupInfo_s*) StatisticsInformation_growList(flouka_Ptr,
+                                        flouka_Ptr->information.subgroupInfoList_Ptr,
+                                        sizeof(*flouka_Ptr->information.subgroupInfoList_Ptr),
+                                        totalSubGroupsCount,
+                                        &(flouka_Ptr->subGroupsCapacity));
+        flouka_Ptr->totalSubGroupsCount = totalSubGroupsCount;
+    }
+    if(totalCountersCount > firstCounterID)
+    {
+        flouka_Ptr->information.counterInfoList_Ptr
+                        = (flouka_StatisticsCounterInfo_s*) StatisticsInformation_growList(flouka_Ptr,
+                                        flouka_Ptr->information.counterInfoList_Ptr,
+                                        sizeof(*flouka_Ptr->information.counterInfoList_Ptr),
+                                        totalCountersCount,
+                                        &(flouka_Ptr->countersCapacity));
+    }
+    else
+    {
+        totalCountersCount = firstCounterID;
+    }
+
+    if((flouka_Ptr->totalGroupsCount != firstGroupID) || (flouka_Ptr->totalSubGroupsCount != firstSubGroupID)
+       || (totalCountersCount != firstCounterID))
+    {
+        StatisticsInformation_clear(flouka_Ptr,
+                                    firstGroupID,
+                                    firstSubGroupID,
+                                    firstCounterID,
+                                    totalCountersCount);
+        StatisticsInformation_invalidateCache(flouka_Ptr);
+        __atomic_store_n(&(flouka_Ptr->totalCountersCount), totalCountersCount, __ATOMIC_RELEASE);
+    }
+
+    flouka_Ptr->unlockFunction_Ptr();
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+void flouka_assignGroup(flouka_s* flouka_Ptr,
+                        uint32 groupID,
+                        const char* groupName_Ptr,
+                        const char* groupDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The group is validated by StatisticsInformation_validateGroup.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount < flouka_Ptr->totalGroupsCount),
-                    "FLOUKA:  Maximum number of groups exceeded initialized value",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Validate and assign the group (see StatisticsInformation_assignGroup).
+     * 3. Invalidate the serialized information.
+     * 4. Unlock access.
+     *
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateGroup(flouka_Ptr,
+                                        groupID,
+                                        groupName_Ptr,
+                                        groupDescription_Ptr COMMA()
+                                        FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignGroup(flouka_Ptr,
+                                      groupID,
+                                      groupName_Ptr,
+                                      groupDescription_Ptr);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignSubGroup(flouka_s* flouka_Ptr,
+                           uint32 subgroupID,
+                           uint32 groupID,
+                           const char* subgroupName_Ptr,
+                           const char* subgroupDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The sub group is validated by StatisticsInformation_validateSubGroup.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((groupID < flouka_Ptr->totalGroupsCount),
-                    "FLOUKA:  groupID is outside of the range initialized",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Validate and assign the sub group (see StatisticsInformation_assignSubGroup).
+     * 3. Invalidate the serialized information.
+     * 4. Unlock access.
+     *
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateSubGroup(flouka_Ptr,
+                                           subgroupID,
+                                           groupID,
+                                           subgroupName_Ptr,
+                                           subgroupDescription_Ptr COMMA()
+                                           FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignSubGroup(flouka_Ptr,
+                                         subgroupID,
+                                         groupID,
+                                         subgroupName_Ptr,
+                                         subgroupDescription_Ptr);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignCounter(flouka_s* flouka_Ptr,
+                          uint32 counterID,
+                          uint32 subgroupID,
+                          const char* unit_Ptr,
+                          const char* counterName_Ptr,
+                          const char* counterDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    flouka_assignCounterWithPlacement(flouka_Ptr,
+                                      counterID,
+                                      subgroupID,
+                                      unit_Ptr,
+                                      counterName_Ptr,
+                                      counterDescription_Ptr,
+                                      FLOUKA_PLACEMENT_COLD,
+                                      0 COMMA()
+                                      FILE_AND_LINE_FOR_CALL());
+}
+
+void flouka_assignCounterWithPlacement(flouka_s* flouka_Ptr,
+                                       uint32 counterID,
+                                       uint32 subgroupID,
+                                       const char* unit_Ptr,
+                                       const char* counterName_Ptr,
+                                       const char* counterDescription_Ptr,
+                                       flouka_placement_e placement,
+                                       uint32 ownerIndex COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The counter is validated by StatisticsInformation_validateCounter.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((FALSE == flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned),
-                    "FLOUKA:  groupID is already assigned" ,
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Validate and assign the counter, and place its value in memory according to the
+     *    placement hint (see StatisticsInformation_assignCounter).
+     * 3. Invalidate the serialized information.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateCounter(flouka_Ptr,
+                                          counterID,
+                                          subgroupID,
+                                          unit_Ptr,
+                                          counterName_Ptr,
+                                          counterDescription_Ptr,
+                                          placement,
+                                          ownerIndex COMMA()
+                                          FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignCounter(flouka_Ptr,
+                                        counterID,
+                                        subgroupID,
+                                        unit_Ptr,
+                                        counterName_Ptr,
+                                        counterDescription_Ptr,
+                                        placement,
+                                        ownerIndex);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignSchema(flouka_s* flouka_Ptr,
+                         const flouka_schema_s* schema_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the schema_Ptr (not NULL).
+     * 3. Every group, sub group and counter is validated as if it were assigned alone, the whole
+     *    schema is validated before any of it is assigned.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != groupName_Ptr),
-                    "FLOUKA:  NULL was passed as the group name pointer",
+    ASSERT((NULL != schema_Ptr),
+                    "FLOUKA:  NULL was passed as the schema pointer",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != groupName_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the group name pointer",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access once for the whole schema.
+     * 2. Validate the groups, then the sub groups, and then the counters of the schema.
+     * 3. Assign the groups, then the sub groups, and then the counters of the schema (the
+     *    counters are cold, see flouka_assignCounterWithPlacement).
+     * 4. Invalidate the serialized information once.
+     * 5. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateGroupList(flouka_Ptr,
+                                            schema_Ptr->groupList_Ptr,
+                                            schema_Ptr->groupsCount COMMA()
+                                            FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_validateSubGroupList(flouka_Ptr,
+                                               schema_Ptr->subGroupList_Ptr,
+                                               schema_Ptr->subGroupsCount COMMA()
+                                               FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_validateCounterList(flouka_Ptr,
+                                              schema_Ptr->counterList_Ptr,
+                                              schema_Ptr->countersCount COMMA()
+                                              FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignGroupList(flouka_Ptr,
+                                          schema_Ptr->groupList_Ptr,
+                                          schema_Ptr->groupsCount);
+    StatisticsInformation_assignSubGroupList(flouka_Ptr,
+                                             schema_Ptr->subGroupList_Ptr,
+                                             schema_Ptr->subGroupsCount);
+    StatisticsInformation_assignCounterList(flouka_Ptr,
+                                            schema_Ptr->counterList_Ptr,
+                                            schema_Ptr->countersCount);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignGroups(flouka_s* flouka_Ptr,
+                         const flouka_groupDescriptor_s* groupList_Ptr,
+                         uint32 groupsCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The groups are validated by StatisticsInformation_validateGroupList.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != groupDescription_Ptr),
-                    "FLOUKA:  NULL was passed as the group description pointer",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access once for the whole list.
+     * 2. Validate all the given groups, and then assign them (see
+     *    StatisticsInformation_assignGroupList).
+     * 3. Invalidate the serialized information once.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateGroupList(flouka_Ptr,
+                                            groupList_Ptr,
+                                            groupsCount COMMA()
+                                            FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignGroupList(flouka_Ptr,
+                                          groupList_Ptr,
+                                          groupsCount);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignSubGroups(flouka_s* flouka_Ptr,
+                            const flouka_subGroupDescriptor_s* subGroupList_Ptr,
+                            uint32 subGroupsCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The sub groups are validated by StatisticsInformation_validateSubGroupList.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != groupDescription_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the group description pointer",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access once for the whole list.
+     * 2. Validate all the given sub groups, and then assign them (see
+     *    StatisticsInformation_assignSubGroupList).
+     * 3. Invalidate the serialized information once.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateSubGroupList(flouka_Ptr,
+                                               subGroupList_Ptr,
+                                               subGroupsCount COMMA()
+                                               FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignSubGroupList(flouka_Ptr,
+                                             subGroupList_Ptr,
+                                             subGroupsCount);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_assignCounters(flouka_s* flouka_Ptr,
+                           const flouka_counterDescriptor_s* counterList_Ptr,
+                           uint32 countersCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. The counters are validated by StatisticsInformation_validateCounterList.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access once for the whole list.
+     * 2. Validate all the given counters, and then assign them as cold counters (see
+     *    StatisticsInformation_assignCounterList).
+     * 3. Invalidate the serialized information once.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    StatisticsInformation_validateCounterList(flouka_Ptr,
+                                              counterList_Ptr,
+                                              countersCount COMMA()
+                                              FILE_AND_LINE_FOR_CALL());
+    StatisticsInformation_assignCounterList(flouka_Ptr,
+                                            counterList_Ptr,
+                                            countersCount);
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+flouka_status_e flouka_assignSparseCounter(flouka_s* flouka_Ptr,
+                                           uint64 sparseID,
+                                           uint32 subgroupID,
+                                           const char* unit_Ptr,
+                                           const char* counterName_Ptr,
+                                           const char* counterDescription_Ptr,
+                                           uint32* counterID_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 counterID;
+    flouka_StatisticsCounterInfo_s* counterInfo_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the sparse IDs (not frozen yet).
+     * 3. Validate the counterID_Ptr (not NULL).
+     * The rest are done by flouka_assignCounter.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL == flouka_Ptr->sparseTable_Ptr),
+                    "FLOUKA:  The sparse IDs are already frozen",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != counterID_Ptr),
+                    "FLOUKA:  NULL was passed as the counter ID pointer",
                     fileName,
                     lineNumber);
 
@@ -636,83 +5074,238 @@ void flouka_assignGroup(flouka_s* flouka_Ptr,
      * Steps done in this function:
      * ============================
      * 1. Lock access to prevent data corruption when calling this function from multiple threads.
-     * 2. Assign the group name.
-     * 3. Assign the group description.
-     * 4. Set the group as assigned.
-     * 5. Increment the number of assigned groups.
-     * 6. Unlock access.
-     *
+     * 2. Take the lowest counter ID that is neither assigned nor reserved by a family, and fail if
+     *    there is none left.
+     * 3. Add the sparse ID and the counter ID to the list of the sparse counters, they are added to
+     *    the table when the sparse IDs are frozen.
+     * 4. Unlock access, and assign the counter.
+     * 5. Return the counter ID, it may be used as any other counter ID.
      */
     flouka_Ptr->lockFunction_Ptr();
 
-    flouka_Ptr->information.groupInfoList_Ptr[groupID].groupName_Ptr = groupName_Ptr;
-    flouka_Ptr->information.groupInfoList_Ptr[groupID].groupDescription_Ptr = groupDescription_Ptr;
-#ifdef DEBUG
-    flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned = TRUE;
-#endif /*DEBUG*/
-    flouka_Ptr->information.sizes.assignedGroupsCount++;
+    for(counterID = flouka_Ptr->nextSparseCounterID; counterID < flouka_Ptr->totalCountersCount; counterID++)
+    {
+        counterInfo_Ptr = &(flouka_Ptr->information.counterInfoList_Ptr[counterID]);
+        if((FLOUKA_UNASSIGNED_ID == counterInfo_Ptr->subgroupID)
+           && (FLOUKA_UNASSIGNED_ID == counterInfo_Ptr->familyID))
+        {
+            break;
+        }
+    }
+    if(counterID == flouka_Ptr->totalCountersCount)
+    {
+        flouka_Ptr->nextSparseCounterID = counterID;
+        flouka_Ptr->unlockFunction_Ptr();
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    flouka_Ptr->sparseCounterList_Ptr
+                    = (flouka_SparseCounter_s*) StatisticsInformation_growList(flouka_Ptr,
+                                    flouka_Ptr->sparseCounterList_Ptr,
+                                    sizeof(*flouka_Ptr->sparseCounterList_Ptr),
+                                    flouka_Ptr->sparseCountersCount + 1,
+                                    &(flouka_Ptr->sparseCountersCapacity));
+    flouka_Ptr->sparseCounterList_Ptr[flouka_Ptr->sparseCountersCount].sparseID = sparseID;
+    flouka_Ptr->sparseCounterList_Ptr[flouka_Ptr->sparseCountersCount].counterID = counterID;
+    flouka_Ptr->sparseCountersCount++;
+    flouka_Ptr->nextSparseCounterID = counterID + 1;
+
+    flouka_Ptr->unlockFunction_Ptr();
+
+    flouka_assignCounter(flouka_Ptr,
+                         counterID,
+                         subgroupID,
+                         unit_Ptr,
+                         counterName_Ptr,
+                         counterDescription_Ptr COMMA()
+                         FILE_AND_LINE_FOR_CALL());
+
+    *counterID_Ptr = counterID;
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+flouka_status_e flouka_freezeSparseCounters(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32 entriesCount;
+    uint32 index;
+    flouka_SparseCounter_s* table_Ptr;
+    flouka_SparseCounter_s* sparseCounter_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the sparse IDs (not frozen yet).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL == flouka_Ptr->sparseTable_Ptr),
+                    "FLOUKA:  The sparse IDs are already frozen",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Allocate the table, the number of its entries is the smallest power of two that is at least
+     *    twice the number of sparse counters, so that a look up rarely probes more than one entry.
+     * 3. Add every sparse counter to the entry of its hash, or the first empty entry after it
+     *    (linear probing), and fail (keeping the sparse IDs not frozen) if a sparse ID is given
+     *    twice.
+     * 4. Publish the table, it never changes after that, so that the look ups are not locked, and
+     *    release the list of the sparse counters.
+     * 5. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    entriesCount = 2;
+    while(entriesCount < (2 * flouka_Ptr->sparseCountersCount))
+    {
+        entriesCount *= 2;
+    }
+    table_Ptr = (flouka_SparseCounter_s*) flouka_Ptr->allocationFunction_Ptr(entriesCount * sizeof(*table_Ptr));
+    for(i = 0; i < entriesCount; i++)
+    {
+        table_Ptr[i].sparseID = 0;
+        table_Ptr[i].counterID = FLOUKA_UNASSIGNED_ID;
+    }
+
+    for(i = 0; i < flouka_Ptr->sparseCountersCount; i++)
+    {
+        sparseCounter_Ptr = &(flouka_Ptr->sparseCounterList_Ptr[i]);
+        index = SparseTable_hash(sparseCounter_Ptr->sparseID) & (entriesCount - 1);
+        while(FLOUKA_UNASSIGNED_ID != table_Ptr[index].counterID)
+        {
+            if(sparseCounter_Ptr->sparseID == table_Ptr[index].sparseID)
+            {
+                flouka_Ptr->deallocationFunction_Ptr(table_Ptr);
+                flouka_Ptr->unlockFunction_Ptr();
+                return (FLOUKA_STATUS_FAILURE);
+            }
+            index = (index + 1) & (entriesCount - 1);
+        }
+        table_Ptr[index] = *sparseCounter_Ptr;
+    }
+
+    flouka_Ptr->sparseTableMask = entriesCount - 1;
+    __atomic_store_n(&(flouka_Ptr->sparseTable_Ptr), table_Ptr, __ATOMIC_RELEASE);
+    if(NULL != flouka_Ptr->sparseCounterList_Ptr)
+    {
+        flouka_Ptr->deallocationFunction_Ptr(flouka_Ptr->sparseCounterList_Ptr);
+        flouka_Ptr->sparseCounterList_Ptr = NULL;
+    }
+
+    flouka_Ptr->unlockFunction_Ptr();
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+INLINE uint32 flouka_getSparseCounterID(flouka_s* flouka_Ptr,
+                                        uint64 sparseID COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 index;
+    flouka_SparseCounter_s* entry_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the sparse IDs (frozen).
+     * 3. Validate the sparse ID (assigned).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr->sparseTable_Ptr),
+                    "FLOUKA:  The sparse IDs are not frozen yet",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Probe the table from the entry of the hash of the sparse ID, until the entry of the sparse
+     *    ID, or an empty entry (the sparse ID is not assigned) is found.
+     * 2. Return the counter ID of the entry, FLOUKA_UNASSIGNED_ID if it is empty.
+     */
+    index = SparseTable_hash(sparseID) & flouka_Ptr->sparseTableMask;
+    entry_Ptr = &(flouka_Ptr->sparseTable_Ptr[index]);
+    while((sparseID != entry_Ptr->sparseID) && (FLOUKA_UNASSIGNED_ID != entry_Ptr->counterID))
+    {
+        index = (index + 1) & flouka_Ptr->sparseTableMask;
+        entry_Ptr = &(flouka_Ptr->sparseTable_Ptr[index]);
+    }
+
+    ASSERT((FLOUKA_UNASSIGNED_ID != entry_Ptr->counterID),
+                    "FLOUKA:  The sparse ID is not assigned",
+                    fileName,
+                    lineNumber);
 
-    flouka_Ptr->unlockFunction_Ptr();
+    return (entry_Ptr->counterID);
 }
 
-void flouka_assignSubGroup(flouka_s* flouka_Ptr,
-                           uint32 subgroupID,
-                           uint32 groupID,
-                           const char* subgroupName_Ptr,
-                           const char* subgroupDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+void flouka_assignFamily(flouka_s* flouka_Ptr,
+                         uint32 familyID,
+                         uint32 groupID,
+                         uint32 firstCounterID,
+                         uint32 membersCount,
+                         uint32 instancesCount,
+                         const char* familyName_Ptr,
+                         const char* familyDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
 {
+    uint32 i;
+    uint32 familiesCount;
+    uint32 countersCount;
+    flouka_CounterFamily_s* family_Ptr;
+
     /*
      * Assertions done in this function:
      * =================================
      * 1. Validate the flouka_Ptr (not NULL).
-     * 2. Validate the total number of assigned sub groups (less than maximum).
-     * 3. Validate the given sub group ID (less than maximum).
-     * 4. Validate the given group ID (less than maximum).
-     * 5. Validate the sub group assignment status (not assigned).
-     * 6. Validate the group assignment status (assigned).
-     * 7. Validate the subgroupName_Ptr (not NULL).
-     * 8. Validate the subgroupName_Ptr (non empty string ("")).
-     * 9. Validate the subgroupDescription_Ptr (not NULL).
-     * 10. Validate the subgroupDescription_Ptr (non empty string ("")).
+     * 2. Validate the family assignment status (not assigned).
+     * 3. Validate the given group ID (less than maximum).
+     * 4. Validate the group assignment status (assigned).
+     * 5. Validate the number of members and instances (non-zero).
+     * 6. Validate the range of counters of the family (inside the range initialized).
+     * 7. Validate the familyName_Ptr (not NULL, non empty string ("")).
+     * 8. Validate the familyDescription_Ptr (not NULL, non empty string ("")).
+     * 9. Validate the counters of the family (neither assigned nor reserved by another family).
      */
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount < flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA:  Maximum number of sub groups exceeded initialized value",
-                    fileName,
-                    lineNumber);
-    ASSERT((subgroupID < flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA:  subgroupID is outside of the range initialized",
+    ASSERT(((familyID >= flouka_Ptr->familiesCount)
+                    || (FLOUKA_UNASSIGNED_ID == flouka_Ptr->familyList_Ptr[familyID].groupID)),
+                    "FLOUKA:  familyID is already assigned",
                     fileName,
                     lineNumber);
     ASSERT((groupID < flouka_Ptr->totalGroupsCount),
                     "FLOUKA:  groupID is outside of the range initialized",
                     fileName,
                     lineNumber);
-    ASSERT((FALSE == flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned),
-                    "FLOUKA:  subgroupID is already assigned" ,
-                    fileName,
-                    lineNumber);
     ASSERT((TRUE == flouka_Ptr->information.groupInfoList_Ptr[groupID].isAssigned),
                     "FLOUKA:  groupID is not assigned yet" ,
                     fileName,
                     lineNumber);
-    ASSERT((NULL != subgroupName_Ptr),
-                    "FLOUKA:  NULL was passed as the sub group name pointer",
+    ASSERT(((0 != membersCount) && (0 != instancesCount)),
+                    "FLOUKA:  Number of members and instances of a family cannot be zero",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != subgroupName_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the sub group name pointer",
+    ASSERT(((firstCounterID + (membersCount * instancesCount)) <= flouka_Ptr->totalCountersCount),
+                    "FLOUKA:  The counters of the family are outside of the range initialized",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != subgroupDescription_Ptr),
-                    "FLOUKA:  NULL was passed as the sub group description pointer",
+    ASSERT(((NULL != familyName_Ptr) && ('\0' != familyName_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the family name pointer",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != subgroupDescription_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the sub group description pointer",
+    ASSERT(((NULL != familyDescription_Ptr) && ('\0' != familyDescription_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the family description pointer",
                     fileName,
                     lineNumber);
 
@@ -720,98 +5313,191 @@ void flouka_assignSubGroup(flouka_s* flouka_Ptr,
      * Steps done in this function:
      * ============================
      * 1. Lock access to prevent data corruption when calling this function from multiple threads.
-     * 2. Assign the parent group id.
-     * 3. Assign the sub group name.
-     * 4. Assign the sub group description.
-     * 5. Set the sub group as assigned.
-     * 6. Increment the number of assigned sub groups.
-     * 7. Unlock access.
-     *
+     * 2. Grow the list of families (if needed), the families between the last one and the given
+     *    one are not assigned.
+     * 3. Assign the group, the name, the description (both interned), and the range of counters
+     *    of the family, allocate its members (described by flouka_assignFamilyMember), the labels
+     *    of its slots, and the stack of its free slots (the lowest slot is taken first).
+     * 4. Reserve the counters of the family, and place them in memory (if enabled).
+     * 5. Invalidate the serialized information.
+     * 6. Unlock access.
      */
     flouka_Ptr->lockFunction_Ptr();
 
-    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].groupID = groupID;
-    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].subgroupName_Ptr = subgroupName_Ptr;
-    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].subgroupDescription_Ptr
-                    = subgroupDescription_Ptr;
+    familiesCount = flouka_Ptr->familiesCount;
+    if(familyID >= familiesCount)
+    {
+        flouka_Ptr->familyList_Ptr
+                        = (flouka_CounterFamily_s*) StatisticsInformation_growList(flouka_Ptr,
+                                        flouka_Ptr->familyList_Ptr,
+                                        sizeof(*flouka_Ptr->familyList_Ptr),
+                                        familyID + 1,
+                                        &(flouka_Ptr->familiesCapacity));
+        for(i = familiesCount; i <= familyID; i++)
+        {
+            CounterFamily_clear(&(flouka_Ptr->familyList_Ptr[i]), flouka_Ptr->emptyString_Ptr);
+        }
+        flouka_Ptr->familiesCount = familyID + 1;
+    }
 
+    family_Ptr = &(flouka_Ptr->familyList_Ptr[familyID]);
+    family_Ptr->groupID = groupID;
+    family_Ptr->familyName_Ptr = StringStore_intern(flouka_Ptr, familyName_Ptr);
+    family_Ptr->familyDescription_Ptr = StringStore_intern(flouka_Ptr, familyDescription_Ptr);
+    family_Ptr->firstCounterID = firstCounterID;
+    family_Ptr->membersCount = membersCount;
+    family_Ptr->instancesCount = instancesCount;
+    family_Ptr->memberInfoList_Ptr
+                    = (flouka_StatisticsCounterInfo_s*) flouka_Ptr->allocationFunction_Ptr(membersCount
+                                    * sizeof(*family_Ptr->memberInfoList_Ptr));
+    for(i = 0; i < membersCount; i++)
+    {
 #ifdef DEBUG
-    flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned = TRUE;
+        family_Ptr->memberInfoList_Ptr[i].isAssigned = FALSE;
 #endif /*DEBUG*/
-    flouka_Ptr->information.sizes.assignedSubGroupsCount++;
+        family_Ptr->memberInfoList_Ptr[i].counterID = i;
+        family_Ptr->memberInfoList_Ptr[i].subgroupID = FLOUKA_UNASSIGNED_ID;
+        family_Ptr->memberInfoList_Ptr[i].unit_Ptr = flouka_Ptr->emptyString_Ptr;
+        family_Ptr->memberInfoList_Ptr[i].counterName_Ptr = flouka_Ptr->emptyString_Ptr;
+        family_Ptr->memberInfoList_Ptr[i].counterDescription_Ptr = flouka_Ptr->emptyString_Ptr;
+        family_Ptr->memberInfoList_Ptr[i].familyID = familyID;
+    }
+    family_Ptr->labelList_Ptr = (char**) flouka_Ptr->allocationFunction_Ptr(instancesCount
+                    * sizeof(*family_Ptr->labelList_Ptr));
+    family_Ptr->freeSlotList_Ptr = (uint32*) flouka_Ptr->allocationFunction_Ptr(instancesCount
+                    * sizeof(*family_Ptr->freeSlotList_Ptr));
+    for(i = 0; i < instancesCount; i++)
+    {
+        family_Ptr->labelList_Ptr[i] = NULL;
+        family_Ptr->freeSlotList_Ptr[i] = instancesCount - 1 - i;
+    }
+    family_Ptr->freeSlotsCount = instancesCount;
+
+    countersCount = membersCount * instancesCount;
+    for(i = firstCounterID; i < (firstCounterID + countersCount); i++)
+    {
+        ASSERT(((FLOUKA_UNASSIGNED_ID == flouka_Ptr->information.counterInfoList_Ptr[i].subgroupID)
+                        && (FLOUKA_UNASSIGNED_ID == flouka_Ptr->information.counterInfoList_Ptr[i].familyID)),
+                        "FLOUKA:  A counter of the family is already assigned or reserved",
+                        fileName,
+                        lineNumber);
+        flouka_Ptr->information.counterInfoList_Ptr[i].familyID = familyID;
+        if(NULL != flouka_Ptr->counterSlotList_Ptr)
+        {
+            CounterStorage_placeCounter(flouka_Ptr, i, FLOUKA_PLACEMENT_COLD, 0);
+        }
+    }
+    StatisticsInformation_invalidateCache(flouka_Ptr);
 
     flouka_Ptr->unlockFunction_Ptr();
 }
 
-void flouka_assignCounter(flouka_s* flouka_Ptr,
-                          uint32 counterID,
-                          uint32 subgroupID,
-                          const char* unit_Ptr,
-                          const char* counterName_Ptr,
-                          const char* counterDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+void flouka_assignFamilyMember(flouka_s* flouka_Ptr,
+                               uint32 familyID,
+                               uint32 memberIndex,
+                               const char* unit_Ptr,
+                               const char* counterName_Ptr,
+                               const char* counterDescription_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
 {
+    flouka_StatisticsCounterInfo_s* memberInfo_Ptr;
+
     /*
      * Assertions done in this function:
      * =================================
      * 1. Validate the flouka_Ptr (not NULL).
-     * 2. Validate the total number of assigned counters (less than maximum).
-     * 3. Validate the given counter ID (less than maximum).
-     * 4. Validate the given sub group ID (less than maximum).
-     * 5. Validate the sub group assignment status (assigned).
-     * 6. Validate the counter assignment status (not assigned).
-     * 7. Validate the counterName_Ptr (not NULL).
-     * 8. Validate the counterName_Ptr (non empty string ("")).
-     * 9. Validate the counterDescription_Ptr (not NULL).
-     * 10.Validate the counterDescription_Ptr (non empty string ("")).
-     * 11.Validate the unit_Ptr (not NULL).
-     * 12.Validate the unit_Ptr (non empty string ("")).
+     * 2. Validate the family assignment status (assigned).
+     * 3. Validate the given member index (less than the number of members).
+     * 4. Validate the member assignment status (not assigned).
+     * 5. Validate the unit_Ptr, counterName_Ptr and counterDescription_Ptr (not NULL, non empty
+     *    string ("")).
      */
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount < flouka_Ptr->totalCountersCount),
-                    "FLOUKA:  Maximum number of counters exceeded initialized value",
-                    fileName,
-                    lineNumber);
-    ASSERT((counterID < flouka_Ptr->totalCountersCount),
-                    "FLOUKA:  CounterID is outside of the range initialized",
+    ASSERT(((familyID < flouka_Ptr->familiesCount)
+                    && (FLOUKA_UNASSIGNED_ID != flouka_Ptr->familyList_Ptr[familyID].groupID)),
+                    "FLOUKA:  familyID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT((subgroupID < flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA:  subgroupID is outside of the range initialized",
+    ASSERT((memberIndex < flouka_Ptr->familyList_Ptr[familyID].membersCount),
+                    "FLOUKA:  memberIndex is outside of the members of the family",
                     fileName,
                     lineNumber);
-    ASSERT((TRUE == flouka_Ptr->information.subgroupInfoList_Ptr[subgroupID].isAssigned),
-                    "FLOUKA:  subroupID is not assigned yet",
+    ASSERT((FALSE == flouka_Ptr->familyList_Ptr[familyID].memberInfoList_Ptr[memberIndex].isAssigned),
+                    "FLOUKA:  memberIndex is already assigned",
                     fileName,
                     lineNumber);
-    ASSERT((FALSE == flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned),
-                    "FLOUKA:  CounterID is already assigned",
+    ASSERT(((NULL != unit_Ptr) && ('\0' != unit_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the counter unit pointer",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != counterName_Ptr),
-                    "FLOUKA:  NULL was passed as the counter name pointer",
+    ASSERT(((NULL != counterName_Ptr) && ('\0' != counterName_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the counter name pointer",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != counterName_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the counter name pointer",
+    ASSERT(((NULL != counterDescription_Ptr) && ('\0' != counterDescription_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the counter description pointer",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != counterDescription_Ptr),
-                    "FLOUKA:  NULL was passed as the counter description pointer",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Assign the unit, the name and the description of the member (interned), they describe the
+     *    counter of the member of every instance of the family.
+     * 3. Invalidate the serialized information.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    memberInfo_Ptr = &(flouka_Ptr->familyList_Ptr[familyID].memberInfoList_Ptr[memberIndex]);
+    memberInfo_Ptr->unit_Ptr = StringStore_intern(flouka_Ptr, unit_Ptr);
+    memberInfo_Ptr->counterName_Ptr = StringStore_intern(flouka_Ptr, counterName_Ptr);
+    memberInfo_Ptr->counterDescription_Ptr = StringStore_intern(flouka_Ptr, counterDescription_Ptr);
+#ifdef DEBUG
+    memberInfo_Ptr->isAssigned = TRUE;
+#endif /*DEBUG*/
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+flouka_status_e flouka_addFamilyInstance(flouka_s* flouka_Ptr,
+                                         uint32 familyID,
+                                         const char* label_Ptr,
+                                         uint32* firstCounterID_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32 slot;
+    uint32 firstCounterID;
+    uint32 labelSize;
+    flouka_CounterFamily_s* family_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the family assignment status (assigned).
+     * 3. Validate the label_Ptr (not NULL, non empty string ("")).
+     * 4. Validate the firstCounterID_Ptr (not NULL).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != counterDescription_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the counter description pointer",
+    ASSERT(((familyID < flouka_Ptr->familiesCount)
+                    && (FLOUKA_UNASSIGNED_ID != flouka_Ptr->familyList_Ptr[familyID].groupID)),
+                    "FLOUKA:  familyID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT((NULL != unit_Ptr),
-                    "FLOUKA:  NULL was passed as the counter unit pointer",
+    ASSERT(((NULL != label_Ptr) && ('\0' != label_Ptr[0])),
+                    "FLOUKA:  NULL or empty string (\"\") was passed as the instance label pointer",
                     fileName,
                     lineNumber);
-    ASSERT(('\0' != unit_Ptr[0]),
-                    "FLOUKA:  Empty string (\"\") was passed as the counter unit pointer",
+    ASSERT((NULL != firstCounterID_Ptr),
+                    "FLOUKA:  NULL was passed as the first counter ID pointer",
                     fileName,
                     lineNumber);
 
@@ -819,142 +5505,429 @@ void flouka_assignCounter(flouka_s* flouka_Ptr,
      * Steps done in this function:
      * ============================
      * 1. Lock access to prevent data corruption when calling this function from multiple threads.
-     * 2. Set the parent sub group id.
-     * 3. Assign the counter unit.
-     * 4. Assign the counter name.
-     * 5. Assign the counter description.
-     * 6. Set the counter as assigned.
-     * 7. Increment the number of assigned counters.
-     * 8. Unlock access.
+     * 2. Take the last freed slot, and fail if all the slots are used.
+     * 3. Copy the label to the slot (the label may be released by the caller after that).
+     * 4. Reset the counters of the slot (they may hold the values of the removed instance).
+     * 5. Invalidate the serialized information.
+     * 6. Unlock access.
+     * 7. Return the first counter of the instance, the counter of a member is the first counter
+     *    plus the member index.
      */
     flouka_Ptr->lockFunction_Ptr();
 
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterID = counterID;
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].subgroupID = subgroupID;
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].unit_Ptr = unit_Ptr;
+    family_Ptr = &(flouka_Ptr->familyList_Ptr[familyID]);
+    if(0 == family_Ptr->freeSlotsCount)
+    {
+        flouka_Ptr->unlockFunction_Ptr();
+        return (FLOUKA_STATUS_FAILURE);
+    }
+    family_Ptr->freeSlotsCount--;
+    slot = family_Ptr->freeSlotList_Ptr[family_Ptr->freeSlotsCount];
 
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterName_Ptr = counterName_Ptr;
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].counterDescription_Ptr
-                    = counterDescription_Ptr;
+    labelSize = strlen(label_Ptr) + 1;
+    family_Ptr->labelList_Ptr[slot] = (char*) flouka_Ptr->allocationFunction_Ptr(labelSize);
+    memcpy(family_Ptr->labelList_Ptr[slot], label_Ptr, labelSize);
+
+    firstCounterID = family_Ptr->firstCounterID + (slot * family_Ptr->membersCount);
+    for(i = firstCounterID; i < (firstCounterID + family_Ptr->membersCount); i++)
+    {
+        CounterStorage_exchange(flouka_Ptr, i, FLOUKA_COUNTER_MINIMUM_VALUE);
 #ifdef DEBUG
-    flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned = TRUE;
+        flouka_Ptr->information.counterInfoList_Ptr[i].isAssigned = TRUE;
 #endif /*DEBUG*/
-    flouka_Ptr->information.sizes.assignedCountersCount++;
+    }
+    StatisticsInformation_invalidateCache(flouka_Ptr);
 
     flouka_Ptr->unlockFunction_Ptr();
+
+    *firstCounterID_Ptr = firstCounterID;
+    return (FLOUKA_STATUS_SUCCESS);
 }
 
-uint32 flouka_getInformationSize(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+void flouka_removeFamilyInstance(flouka_s* flouka_Ptr,
+                                 uint32 familyID,
+                                 uint32 firstCounterID COMMA() FILE_AND_LINE_FOR_TYPE())
 {
+    uint32 slot;
+    flouka_CounterFamily_s* family_Ptr;
+#ifdef DEBUG
+    uint32 i;
+#endif /*DEBUG*/
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the family assignment status (assigned).
+     * 3. Validate the given first counter ID (the first counter of an added instance).
+     */
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount == flouka_Ptr->totalGroupsCount),
-                    "FLOUKA: assigned groups are less than the total, you have to assign all groups",
+    ASSERT(((familyID < flouka_Ptr->familiesCount)
+                    && (FLOUKA_UNASSIGNED_ID != flouka_Ptr->familyList_Ptr[familyID].groupID)),
+                    "FLOUKA:  familyID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount == flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA: assigned sub groups are less than the total, you have to assign all sub groups",
+    ASSERT(((firstCounterID >= flouka_Ptr->familyList_Ptr[familyID].firstCounterID)
+                    && (0 == ((firstCounterID - flouka_Ptr->familyList_Ptr[familyID].firstCounterID)
+                              % flouka_Ptr->familyList_Ptr[familyID].membersCount))
+                    && (((firstCounterID - flouka_Ptr->familyList_Ptr[familyID].firstCounterID)
+                         / flouka_Ptr->familyList_Ptr[familyID].membersCount)
+                        < flouka_Ptr->familyList_Ptr[familyID].instancesCount)
+                    && (NULL != flouka_Ptr->familyList_Ptr[familyID].labelList_Ptr[(firstCounterID
+                                    - flouka_Ptr->familyList_Ptr[familyID].firstCounterID)
+                                    / flouka_Ptr->familyList_Ptr[familyID].membersCount])),
+                    "FLOUKA:  firstCounterID is not the first counter of an instance of the family",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount == flouka_Ptr->totalCountersCount),
-                    "FLOUKA: assigned counters are less than the total, you have to assign all counters",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access to prevent data corruption when calling this function from multiple threads.
+     * 2. Release the label of the slot, and push the slot on the stack of the free slots, its
+     *    counters are reset when it is reused (the schema of the family does not change).
+     * 3. Invalidate the serialized information.
+     * 4. Unlock access.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    family_Ptr = &(flouka_Ptr->familyList_Ptr[familyID]);
+    slot = (firstCounterID - family_Ptr->firstCounterID) / family_Ptr->membersCount;
+    flouka_Ptr->deallocationFunction_Ptr(family_Ptr->labelList_Ptr[slot]);
+    family_Ptr->labelList_Ptr[slot] = NULL;
+    family_Ptr->freeSlotList_Ptr[family_Ptr->freeSlotsCount] = slot;
+    family_Ptr->freeSlotsCount++;
+#ifdef DEBUG
+    for(i = firstCounterID; i < (firstCounterID + family_Ptr->membersCount); i++)
+    {
+        flouka_Ptr->information.counterInfoList_Ptr[i].isAssigned = FALSE;
+    }
+#endif /*DEBUG*/
+    StatisticsInformation_invalidateCache(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+uint32 flouka_getInformationSize(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 infoSize;
+
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
 
-    return (StatisticsInformation_getSerializedSize(&(flouka_Ptr->information),
-                                                    flouka_Ptr->totalGroupsCount,
-                                                    flouka_Ptr->totalSubGroupsCount,
-                                                    flouka_Ptr->totalCountersCount));
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Serialize the information if it is not cached yet.
+     * 2. Return its size without the length header (it is added by the caller).
+     */
+    flouka_Ptr->lockFunction_Ptr();
+    StatisticsInformation_buildCache(flouka_Ptr);
+    infoSize = flouka_Ptr->informationCacheSize;
+    flouka_Ptr->unlockFunction_Ptr();
+
+    return (infoSize - LENGTH_HEADER_SIZE);
 }
 
-void flouka_getInformation(flouka_s* flouka_Ptr,
-                           uint8* informationBuffer_Ptr,
-                           uint32 allocatedInfoBufferSize COMMA() FILE_AND_LINE_FOR_TYPE())
+uint32 flouka_getInformation(flouka_s* flouka_Ptr,
+                             uint8* informationBuffer_Ptr,
+                             uint32 allocatedInfoBufferSize COMMA() FILE_AND_LINE_FOR_TYPE())
 {
     uint32 infoSize;
 
-    infoSize = flouka_getInformationSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_CALL()) + LENGTH_HEADER_SIZE;
-
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the informationBuffer_Ptr (not NULL).
+     */
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((allocatedInfoBufferSize >= infoSize),
-                    "FLOUKA: Information buffer allocated is smaller than expected)",
+    ASSERT((NULL != informationBuffer_Ptr),
+                    "FLOUKA:  NULL was passed as the information buffer pointer",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount == flouka_Ptr->totalGroupsCount),
-                    "FLOUKA: assigned groups are less than the total, you have to assign all groups",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access, and serialize the information if it is not cached yet.
+     * 2. Copy the cached serialized information if it fits in the given buffer, the information
+     *    may have grown since its size was taken (ex. a counter was assigned, or the object grew),
+     *    so the size is checked under the same lock as the copy.
+     * 3. Unlock access, and return the size copied (with the length header), zero if nothing was
+     *    copied.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+    StatisticsInformation_buildCache(flouka_Ptr);
+    infoSize = flouka_Ptr->informationCacheSize;
+    if(infoSize > allocatedInfoBufferSize)
+    {
+        infoSize = 0;
+    }
+    memcpy(informationBuffer_Ptr, flouka_Ptr->informationCache_Ptr, infoSize);
+    flouka_Ptr->unlockFunction_Ptr();
+
+    return (infoSize);
+}
+
+void flouka_getInformationBuffer(flouka_s* flouka_Ptr,
+                                 uint8** informationBufferPointer_Ptr,
+                                 uint32* informationBufferSize_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount == flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA: assigned sub groups are less than the total, you have to assign all sub groups",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the cached serialized information (serialize it first if needed) and its size.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+    StatisticsInformation_buildCache(flouka_Ptr);
+    *informationBufferPointer_Ptr = flouka_Ptr->informationCache_Ptr;
+    *informationBufferSize_Ptr = flouka_Ptr->informationCacheSize;
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_getIndexedInformation(flouka_s* flouka_Ptr,
+                                  uint8** indexBufferPointer_Ptr,
+                                  uint32* indexBufferSize_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount == flouka_Ptr->totalCountersCount),
-                    "FLOUKA: assigned counters are less than the total, you have to assign all counters",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the cached indexed information (build it first if needed) and its size.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+    IndexedInformation_build(flouka_Ptr);
+    *indexBufferPointer_Ptr = flouka_Ptr->indexCache_Ptr;
+    *indexBufferSize_Ptr = flouka_Ptr->indexCacheSize;
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+flouka_status_e flouka_getGroupCounters(flouka_s* flouka_Ptr,
+                                        uint32 groupID,
+                                        const uint32** counterIDListPointer_Ptr,
+                                        uint32* countersCount_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32* groupStartList_Ptr;
+    uint32* groupEndList_Ptr;
+
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
 
-    FLOUKA_ENCODE_PARAMETER(informationBuffer_Ptr, infoSize);
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Fail if the group ID is invalid.
+     * 2. Return the range of the membership index (build it first if needed) of the group.
+     */
+    if(groupID >= flouka_Ptr->totalGroupsCount)
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    flouka_Ptr->lockFunction_Ptr();
+    MembershipIndex_build(flouka_Ptr);
+    groupStartList_Ptr = flouka_Ptr->membershipIndex_Ptr;
+    groupEndList_Ptr = groupStartList_Ptr + flouka_Ptr->totalGroupsCount;
+    *counterIDListPointer_Ptr = MembershipIndex_getCounterIDList_Ptr(flouka_Ptr)
+                    + groupStartList_Ptr[groupID];
+    *countersCount_Ptr = groupEndList_Ptr[groupID] - groupStartList_Ptr[groupID];
+    flouka_Ptr->unlockFunction_Ptr();
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+flouka_status_e flouka_getSubGroupCounters(flouka_s* flouka_Ptr,
+                                           uint32 subgroupID,
+                                           const uint32** counterIDListPointer_Ptr,
+                                           uint32* countersCount_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32* subgroupStartList_Ptr;
+    uint32* subgroupEndList_Ptr;
+
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
 
-    StatisticsInformation_serialize(&(flouka_Ptr->information),
-                                    informationBuffer_Ptr,
-                                    flouka_Ptr->totalGroupsCount,
-                                    flouka_Ptr->totalSubGroupsCount,
-                                    flouka_Ptr->totalCountersCount);
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Fail if the sub group ID is invalid.
+     * 2. Return the range of the membership index (build it first if needed) of the sub group.
+     */
+    if(subgroupID >= flouka_Ptr->totalSubGroupsCount)
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
 
+    flouka_Ptr->lockFunction_Ptr();
+    MembershipIndex_build(flouka_Ptr);
+    subgroupStartList_Ptr = flouka_Ptr->membershipIndex_Ptr + (2 * flouka_Ptr->totalGroupsCount);
+    subgroupEndList_Ptr = subgroupStartList_Ptr + flouka_Ptr->totalSubGroupsCount;
+    *counterIDListPointer_Ptr = MembershipIndex_getCounterIDList_Ptr(flouka_Ptr)
+                    + subgroupStartList_Ptr[subgroupID];
+    *countersCount_Ptr = subgroupEndList_Ptr[subgroupID] - subgroupStartList_Ptr[subgroupID];
+    flouka_Ptr->unlockFunction_Ptr();
+    return (FLOUKA_STATUS_SUCCESS);
 }
 
-uint32 flouka_getStatisticsSize(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+uint32 flouka_getSchemaGeneration(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
 {
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount == flouka_Ptr->totalGroupsCount),
-                    "FLOUKA: assigned groups are less than the total, you have to assign all groups",
+
+    return (flouka_Ptr->schemaGeneration);
+}
+
+uint32 flouka_getStatisticsSize(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount == flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA: assigned sub groups are less than the total, you have to assign all sub groups",
+
+    return (__atomic_load_n(&(flouka_Ptr->totalCountersCount), __ATOMIC_ACQUIRE)
+                    * sizeof(*(flouka_Ptr->fastPath.counterValuesList_Ptr)));
+}
+
+void flouka_getStatistics(flouka_s* flouka_Ptr,
+                          uint8** statisticsBufferPointer_Ptr,
+                          uint32* statisticsBufferSize_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount == flouka_Ptr->totalCountersCount),
-                    "FLOUKA: assigned counters are less than the total, you have to assign all counters",
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access, so that the statistics buffer is never aggregated by two threads at once
+     *    (ex. while a snapshot or the shared memory publishing collects it).
+     * 2. Bring the statistics buffer up to date (see CounterStorage_refresh).
+     * 3. Unlock access, and return the statistics buffer and its size.
+     *
+     * Note:
+     * The counters are read one by one while the updates go on, so the buffer is not a single
+     * point in time, take a consistent snapshot for that (see flouka_getSnapshot).
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    *statisticsBufferSize_Ptr = __atomic_load_n(&(flouka_Ptr->totalCountersCount), __ATOMIC_ACQUIRE)
+                    * (sizeof(*(flouka_Ptr->fastPath.counterValuesList_Ptr)));
+    *statisticsBufferPointer_Ptr = (uint8*) CounterStorage_refresh(flouka_Ptr);
+
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+void flouka_getSnapshot(flouka_s* flouka_Ptr,
+                        uint8** statisticsBufferPointer_Ptr,
+                        uint32* statisticsBufferSize_Ptr,
+                        flouka_snapshotInfo_s* snapshotInfo_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 countersCount;
+    flouka_Snapshot_s* snapshot_Ptr;
+
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
 
-    return ((flouka_Ptr->totalCountersCount) * sizeof(*(flouka_Ptr->counterValuesList_Ptr)));
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access, so that two snapshots are never taken into the same buffer at once.
+     * 2. Pick the buffer that was not used by the last snapshot (allocate it on its first use, or
+     *    if the object grew beyond it).
+     * 3. Take the snapshot into the buffer (see Snapshot_take).
+     * 4. Unlock access, and return the snapshot buffer, its size and its description.
+     */
+    flouka_Ptr->lockFunction_Ptr();
+
+    snapshot_Ptr = &(flouka_Ptr->snapshotList[flouka_Ptr->snapshotsCount & 1]);
+    countersCount = flouka_Ptr->totalCountersCount;
+    if(snapshot_Ptr->countersCount < countersCount)
+    {
+        if(NULL != snapshot_Ptr->counterValuesList_Ptr)
+        {
+            flouka_Ptr->deallocationFunction_Ptr(snapshot_Ptr->counterValuesList_Ptr);
+        }
+        snapshot_Ptr->counterValuesList_Ptr
+                        = (uint32*) flouka_Ptr->allocationFunction_Ptr(countersCount
+                                        * sizeof(*snapshot_Ptr->counterValuesList_Ptr));
+        snapshot_Ptr->countersCount = countersCount;
+    }
+    Snapshot_take(flouka_Ptr, snapshot_Ptr->counterValuesList_Ptr, countersCount, &(snapshot_Ptr->info));
+
+    flouka_Ptr->unlockFunction_Ptr();
+
+    *statisticsBufferSize_Ptr = countersCount * sizeof(*snapshot_Ptr->counterValuesList_Ptr);
+    *statisticsBufferPointer_Ptr = (uint8*) snapshot_Ptr->counterValuesList_Ptr;
+    if(NULL != snapshotInfo_Ptr)
+    {
+        *snapshotInfo_Ptr = snapshot_Ptr->info;
+    }
 }
 
-void flouka_getStatistics(flouka_s* flouka_Ptr,
-                          uint8** statisticsBufferPointer_Ptr,
-                          uint32* statisticsBufferSize_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+void flouka_copySnapshot(flouka_s* flouka_Ptr,
+                         uint8* statisticsBuffer_Ptr,
+                         uint32 allocatedStatisticsBufferSize,
+                         flouka_snapshotInfo_s* snapshotInfo_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
 {
+    uint32 countersCount;
+    flouka_snapshotInfo_s snapshotInfo;
+
     ASSERT((NULL != flouka_Ptr),
                     "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedGroupsCount == flouka_Ptr->totalGroupsCount),
-                    "FLOUKA: assigned groups are less than the total, you have to assign all groups",
-                    fileName,
-                    lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedSubGroupsCount == flouka_Ptr->totalSubGroupsCount),
-                    "FLOUKA: assigned sub groups are less than the total, you have to assign all sub groups",
-                    fileName,
-                    lineNumber);
-    ASSERT((flouka_Ptr->information.sizes.assignedCountersCount == flouka_Ptr->totalCountersCount),
-                    "FLOUKA: assigned counters are less than the total, you have to assign all counters",
+    ASSERT((NULL != statisticsBuffer_Ptr),
+                    "FLOUKA:  Invalid statistics buffer pointer passed (NULL pointer passed)",
                     fileName,
                     lineNumber);
 
-    *statisticsBufferSize_Ptr = (flouka_Ptr->totalCountersCount)
-                    * (sizeof(*(flouka_Ptr->counterValuesList_Ptr)));
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Lock access, take the snapshot of the counters that fit into the given buffer (see
+     *    Snapshot_take), and unlock, the buffer holds all the counters unless the object grew
+     *    after its size was taken.
+     * 2. Return the description of the snapshot (if requested).
+     */
+    flouka_Ptr->lockFunction_Ptr();
+    countersCount = allocatedStatisticsBufferSize / sizeof(uint32);
+    if(countersCount > flouka_Ptr->totalCountersCount)
+    {
+        countersCount = flouka_Ptr->totalCountersCount;
+    }
+    Snapshot_take(flouka_Ptr, (uint32*) statisticsBuffer_Ptr, countersCount, &snapshotInfo);
+    flouka_Ptr->unlockFunction_Ptr();
 
-    *statisticsBufferPointer_Ptr = (uint8*) flouka_Ptr->counterValuesList_Ptr;
+    if(NULL != snapshotInfo_Ptr)
+    {
+        *snapshotInfo_Ptr = snapshotInfo;
+    }
 }
 
 INLINE void flouka_incrementCounter(flouka_s* flouka_Ptr,
@@ -980,7 +5953,7 @@ INLINE void flouka_incrementCounter(flouka_s* flouka_Ptr,
                     "FLOUKA:  CounterID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT(((flouka_Ptr->counterValuesList_Ptr[counterID] + 1) < FLOUKA_COUNTER_MAXIMUM_VALUE),
+    ASSERT(((CounterStorage_read(flouka_Ptr, counterID) + 1) < FLOUKA_COUNTER_MAXIMUM_VALUE),
                     "FLOUKA:  Counter reached the maximum possible value and will wrap around, comment this line if that is OK",
                     fileName,
                     lineNumber);
@@ -990,7 +5963,7 @@ INLINE void flouka_incrementCounter(flouka_s* flouka_Ptr,
      * ============================
      * 1. Increment the counter value by one.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID]++;
+    CounterStorage_add(flouka_Ptr, counterID, 1);
 }
 
 INLINE void flouka_decrementCounter(flouka_s*   flouka_Ptr,
@@ -1016,7 +5989,7 @@ INLINE void flouka_decrementCounter(flouka_s*   flouka_Ptr,
                     "FLOUKA:  CounterID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT(((flouka_Ptr->counterValuesList_Ptr[counterID] - 1) > FLOUKA_COUNTER_MINIMUM_VALUE),
+    ASSERT(((CounterStorage_read(flouka_Ptr, counterID) - 1) > FLOUKA_COUNTER_MINIMUM_VALUE),
                     "FLOUKA:  Counter reached the minimum possible value and will wrap around, comment this line if that is OK",
                     fileName,
                     lineNumber);
@@ -1026,7 +5999,7 @@ INLINE void flouka_decrementCounter(flouka_s*   flouka_Ptr,
      * ============================
      * 1. decrement the counter value by one.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID]--;
+    CounterStorage_subtract(flouka_Ptr, counterID, 1);
 }
 
 INLINE void flouka_increaseCounter(flouka_s*    flouka_Ptr,
@@ -1053,7 +6026,7 @@ INLINE void flouka_increaseCounter(flouka_s*    flouka_Ptr,
                     "FLOUKA:  CounterID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT(((FLOUKA_COUNTER_MAXIMUM_VALUE - flouka_Ptr->counterValuesList_Ptr[counterID])> delta),
+    ASSERT(((FLOUKA_COUNTER_MAXIMUM_VALUE - CounterStorage_read(flouka_Ptr, counterID))> delta),
                     "FLOUKA:  Overflow occurred and counter will wrap around, comment this line if that is OK",
                     fileName,
                     lineNumber);
@@ -1063,7 +6036,7 @@ INLINE void flouka_increaseCounter(flouka_s*    flouka_Ptr,
      * ============================
      * 1. Increment the counter value by the given delta.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID] += delta;
+    CounterStorage_add(flouka_Ptr, counterID, delta);
 }
 
 INLINE void flouka_decreaseCounter(flouka_s*    flouka_Ptr,
@@ -1090,7 +6063,7 @@ INLINE void flouka_decreaseCounter(flouka_s*    flouka_Ptr,
                     "FLOUKA:  CounterID is not assigned yet",
                     fileName,
                     lineNumber);
-    ASSERT(((flouka_Ptr->counterValuesList_Ptr[counterID] - FLOUKA_COUNTER_MINIMUM_VALUE)> delta),
+    ASSERT(((CounterStorage_read(flouka_Ptr, counterID) - FLOUKA_COUNTER_MINIMUM_VALUE)> delta),
                     "FLOUKA:  Underflow occurred and counter will wrap around, comment this line if that is OK",
                     fileName,
                     lineNumber);
@@ -1100,7 +6073,7 @@ INLINE void flouka_decreaseCounter(flouka_s*    flouka_Ptr,
      * ============================
      * 1. Decrement the counter value by the given delta.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID] -= delta;
+    CounterStorage_subtract(flouka_Ptr, counterID, delta);
 }
 
 INLINE void flouka_setCounter(flouka_s* flouka_Ptr,
@@ -1131,7 +6104,7 @@ INLINE void flouka_setCounter(flouka_s* flouka_Ptr,
      * ============================
      * 1. Set the counter to the given value.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID] = value;
+    CounterStorage_exchange(flouka_Ptr, counterID, value);
 
 }
 
@@ -1162,7 +6135,7 @@ INLINE void flouka_resetCounter(flouka_s* flouka_Ptr,
      * ============================
      * 1. Reset the counter.
      */
-    flouka_Ptr->counterValuesList_Ptr[counterID] = FLOUKA_COUNTER_MINIMUM_VALUE;
+    CounterStorage_exchange(flouka_Ptr, counterID, FLOUKA_COUNTER_MINIMUM_VALUE);
 }
 
 INLINE uint32 flouka_getCounter(flouka_s* flouka_Ptr,
@@ -1190,7 +6163,425 @@ INLINE uint32 flouka_getCounter(flouka_s* flouka_Ptr,
     /*
      * Steps done in this function:
      * ============================
-     * 1. Return the counter value.
+     * 1. Collect the pending updates of all the threads (only in the deferred mode).
+     * 2. Return the counter value.
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        CounterStorage_collectDeferred(flouka_Ptr);
+    }
+
+    return (CounterStorage_read(flouka_Ptr, counterID));
+}
+
+uint32 flouka_readAndResetCounter(flouka_s* flouka_Ptr,
+                                  uint32 counterID COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the given counter ID (less than maximum).
+     * 3. Validate the counter assignment status (assigned).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((counterID < flouka_Ptr->totalCountersCount),
+                    "FLOUKA:  CounterID is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+    ASSERT((TRUE == flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned),
+                    "FLOUKA:  CounterID is not assigned yet",
+                    fileName,
+                    lineNumber);
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Reset the counter, and return the value it had before the reset.
+     */
+    return (CounterStorage_exchange(flouka_Ptr, counterID, FLOUKA_COUNTER_MINIMUM_VALUE));
+}
+
+void flouka_applyDeltas(flouka_s* flouka_Ptr,
+                        const uint32* counterIDList_Ptr,
+                        const uint32* deltaList_Ptr,
+                        uint32 deltasCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32* shard_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+#ifdef DEBUG
+    uint32 counterID;
+#endif /*DEBUG*/
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the counterIDList_Ptr and the deltaList_Ptr (not NULL).
+     * 3. Validate every given counter ID (less than maximum).
+     * 4. Validate every counter assignment status (assigned).
+     * 5. Validate every counter value (no overflow).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT(((NULL != counterIDList_Ptr) && (NULL != deltaList_Ptr)),
+                    "FLOUKA:  NULL was passed as the counter IDs or the deltas list pointer",
+                    fileName,
+                    lineNumber);
+#ifdef DEBUG
+    for(i = 0; i < deltasCount; i++)
+    {
+        counterID = counterIDList_Ptr[i];
+        ASSERT((counterID < flouka_Ptr->totalCountersCount),
+                        "FLOUKA:  CounterID is outside of the range initialized",
+                        fileName,
+                        lineNumber);
+        ASSERT((TRUE == flouka_Ptr->information.counterInfoList_Ptr[counterID].isAssigned),
+                        "FLOUKA:  CounterID is not assigned yet",
+                        fileName,
+                        lineNumber);
+        ASSERT(((FLOUKA_COUNTER_MAXIMUM_VALUE - CounterStorage_read(flouka_Ptr, counterID))
+                        > deltaList_Ptr[i]),
+                        "FLOUKA:  Overflow occurred and counter will wrap around, comment this line if that is OK",
+                        fileName,
+                        lineNumber);
+    } /*for*/
+#endif /*DEBUG*/
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Look up the shard of the calling thread once for the whole batch (a consistent snapshot
+     *    sees the whole batch or none of it).
+     * 2. Increment every counter by its delta, using relaxed atomic additions if the shard is
+     *    atomic.
+     */
+    shard_Ptr = CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic);
+
+    if(TRUE == isAtomic)
+    {
+        for(i = 0; i < deltasCount; i++)
+        {
+            __atomic_fetch_add(&(shard_Ptr[CounterStorage_getSlot(flouka_Ptr, counterIDList_Ptr[i])]),
+                               deltaList_Ptr[i],
+                               __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        for(i = 0; i < deltasCount; i++)
+        {
+            shard_Ptr[CounterStorage_getSlot(flouka_Ptr, counterIDList_Ptr[i])] += deltaList_Ptr[i];
+        }
+    }
+    CounterStorage_endUpdate(writersCount_Ptr);
+}
+
+void flouka_applyDenseDeltas(flouka_s* flouka_Ptr,
+                             uint32 firstCounterID,
+                             const uint32* deltaList_Ptr,
+                             uint32 deltasCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32* shard_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate the deltaList_Ptr (not NULL).
+     * 3. Validate the given counter IDs range (less than maximum).
+     * 4. Validate every counter assignment status (assigned).
+     * 5. Validate every counter value (no overflow).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != deltaList_Ptr),
+                    "FLOUKA:  NULL was passed as the deltas list pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT(((firstCounterID <= flouka_Ptr->totalCountersCount)
+                    && (deltasCount <= (flouka_Ptr->totalCountersCount - firstCounterID))),
+                    "FLOUKA:  CounterIDs range is outside of the range initialized",
+                    fileName,
+                    lineNumber);
+#ifdef DEBUG
+    for(i = 0; i < deltasCount; i++)
+    {
+        ASSERT((TRUE == flouka_Ptr->information.counterInfoList_Ptr[firstCounterID + i].isAssigned),
+                        "FLOUKA:  CounterID is not assigned yet",
+                        fileName,
+                        lineNumber);
+        ASSERT(((FLOUKA_COUNTER_MAXIMUM_VALUE - CounterStorage_read(flouka_Ptr, firstCounterID + i))
+                        > deltaList_Ptr[i]),
+                        "FLOUKA:  Overflow occurred and counter will wrap around, comment this line if that is OK",
+                        fileName,
+                        lineNumber);
+    } /*for*/
+#endif /*DEBUG*/
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Look up the shard of the calling thread once for the whole batch (a consistent snapshot
+     *    sees the whole batch or none of it).
+     * 2. Add the deltas to the counters range, the plain loop has no dependency between iterations
+     *    so the compiler can vectorize it, relaxed atomic additions are used if the shard is
+     *    atomic.
+     *
+     * Note:
+     * When the counters are placed by hints, the range is not consecutive in memory, so every
+     * delta is added to the location of its counter instead.
+     */
+    shard_Ptr = CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic);
+    if(NULL != flouka_Ptr->counterSlotList_Ptr)
+    {
+        for(i = 0; i < deltasCount; i++)
+        {
+            if(TRUE == isAtomic)
+            {
+                __atomic_fetch_add(&(shard_Ptr[CounterStorage_getSlot(flouka_Ptr, firstCounterID + i)]),
+                                   deltaList_Ptr[i],
+                                   __ATOMIC_RELAXED);
+            }
+            else
+            {
+                shard_Ptr[CounterStorage_getSlot(flouka_Ptr, firstCounterID + i)] += deltaList_Ptr[i];
+            }
+        }
+        CounterStorage_endUpdate(writersCount_Ptr);
+        return;
+    }
+
+    shard_Ptr = &(shard_Ptr[firstCounterID]);
+
+    if(TRUE == isAtomic)
+    {
+        for(i = 0; i < deltasCount; i++)
+        {
+            __atomic_fetch_add(&(shard_Ptr[i]), deltaList_Ptr[i], __ATOMIC_RELAXED);
+        }
+    }
+    else
+    {
+        for(i = 0; i < deltasCount; i++)
+        {
+            shard_Ptr[i] += deltaList_Ptr[i];
+        }
+    }
+    CounterStorage_endUpdate(writersCount_Ptr);
+}
+
+void flouka_flush(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32* shard_Ptr;
+    uint32* writersCount_Ptr;
+    bool isAtomic;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Move the pending updates of the calling thread to its shard (only in the deferred mode).
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        shard_Ptr = CounterStorage_beginUpdate(flouka_Ptr, &writersCount_Ptr, &isAtomic);
+        DeferredBuffer_flush(flouka_Ptr, DeferredBuffer_get(flouka_Ptr), shard_Ptr);
+        CounterStorage_endUpdate(writersCount_Ptr);
+    }
+}
+
+
+void flouka_publishSharedMemory(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    flouka_sharedMemoryHeader_s* header_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate that the counters are exported to shared memory.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr->sharedMemory_Ptr),
+                    "FLOUKA:  The object is not initialized with the sharedMemoryName_Ptr option",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Make the change sequence odd, so that the readers retry any copy that overlaps the publish.
+     * 2. Copy the serialized information to the segment if the schema changed since the last
+     *    publish (or it was never published).
+     * 3. Collect the counters into the segment (see CounterStorage_collect), nothing is copied if the
+     *    segment holds the list of counters itself.
+     * 4. Make the change sequence even again.
+     */
+    header_Ptr = flouka_Ptr->sharedMemory_Ptr;
+    flouka_Ptr->lockFunction_Ptr();
+    __atomic_store_n(&(header_Ptr->changeSequence), header_Ptr->changeSequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if((0 == header_Ptr->informationSize) || (header_Ptr->schemaGeneration != flouka_Ptr->schemaGeneration))
+    {
+        StatisticsInformation_buildCache(flouka_Ptr);
+        ASSERT((flouka_Ptr->informationCacheSize <= header_Ptr->informationCapacity),
+                        "FLOUKA:  The information does not fit in the shared memory information area",
+                        fileName,
+                        lineNumber);
+        header_Ptr->informationSize = 0;
+        if(flouka_Ptr->informationCacheSize <= header_Ptr->informationCapacity)
+        {
+            memcpy((uint8*) header_Ptr + header_Ptr->informationOffset,
+                   flouka_Ptr->informationCache_Ptr,
+                   flouka_Ptr->informationCacheSize);
+            header_Ptr->informationSize = flouka_Ptr->informationCacheSize;
+        }
+        header_Ptr->schemaGeneration = flouka_Ptr->schemaGeneration;
+    }
+
+    CounterStorage_collect(flouka_Ptr, SharedMemory_getCounters_Ptr(header_Ptr), flouka_Ptr->totalCountersCount);
+
+    __atomic_store_n(&(header_Ptr->changeSequence), header_Ptr->changeSequence + 1, __ATOMIC_RELEASE);
+    flouka_Ptr->unlockFunction_Ptr();
+}
+
+
+int32 flouka_getSharedMemoryDescriptor(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the read only descriptor of the shared memory segment, -1 if the counters are not
+     *    exported (the descriptor is owned by the object, it is closed when the object is
+     *    destroyed).
+     */
+    return ((NULL == flouka_Ptr->sharedMemory_Ptr) ? -1 : flouka_Ptr->sharedMemoryDescriptor);
+}
+
+
+flouka_status_e flouka_syncPersistentCounters(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate that the counters are persisted.
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr->persistentHeader_Ptr),
+                    "FLOUKA:  The object is not initialized with the persistenceFileName_Ptr option",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Collect the pending updates of all the threads (only in the deferred mode).
+     * 2. Write the changed pages of the file, and wait until they are written.
+     */
+    if(0 != flouka_Ptr->deferredSlotsCount)
+    {
+        CounterStorage_collectDeferred(flouka_Ptr);
+    }
+
+    if(0 != msync(flouka_Ptr->persistentHeader_Ptr, flouka_Ptr->persistentHeader_Ptr->fileSize, MS_SYNC))
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+uint32 flouka_getNodesCount(flouka_s* flouka_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the number of shards in the NUMA mode (a shard per node in every epoch), zero
+     *    otherwise.
+     */
+    return ((NULL == flouka_Ptr->cpuNodeList_Ptr) ? 0 : flouka_Ptr->epochShardsCount);
+}
+
+uint32 flouka_getNodeUpdates(flouka_s* flouka_Ptr,
+                             uint32 nodeIndex COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 updatesCount;
+    flouka_NodeUpdates_s* nodeUpdates_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the flouka_Ptr (not NULL).
+     * 2. Validate that the counters are sharded by the NUMA nodes.
+     * 3. Validate the given node index (less than the number of nodes).
+     */
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr->cpuNodeList_Ptr),
+                    "FLOUKA:  The counters are not sharded by the NUMA nodes",
+                    fileName,
+                    lineNumber);
+    ASSERT((nodeIndex < flouka_Ptr->epochShardsCount),
+                    "FLOUKA:  nodeIndex is outside of the range of the nodes",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Sum the updates of the node counted by every thread (including the threads that exited).
      */
-    return (flouka_Ptr->counterValuesList_Ptr[counterID]);
+    updatesCount = 0;
+    for(nodeUpdates_Ptr = __atomic_load_n(&(flouka_Ptr->nodeUpdatesList_Ptr), __ATOMIC_ACQUIRE);
+        NULL != nodeUpdates_Ptr;
+        nodeUpdates_Ptr = nodeUpdates_Ptr->next_Ptr)
+    {
+        updatesCount += __atomic_load_n(&(nodeUpdates_Ptr->updatesList_Ptr[nodeIndex]), __ATOMIC_RELAXED);
+    }
+    return (updatesCount);
 }
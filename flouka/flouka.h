@@ -40,11 +40,198 @@ typedef enum flouka_status
     FLOUKA_STATUS_FAILURE = 1
 } flouka_status_e;
 
+/*Parent ID of a sub group or a counter that is not assigned yet, as found in the information (the
+  information may be read before all the groups, sub groups and counters are assigned)*/
+#define FLOUKA_UNASSIGNED_ID              (0xFFFFFFFFLU)
+
 typedef struct flouka flouka_s;
 typedef void*(*AllocFuncPtr)(size_t bytesCount);
 typedef void (*DeallocFuncPtr)(void* ptr);
 typedef void (*LockFuncPtr)();
 typedef void (*UnlockFuncPtr)();
+typedef uint32 (*ShardIndexFuncPtr)();
+
+typedef enum flouka_placement
+{
+    /*The counter is rarely updated, it is packed with the other cold counters*/
+    FLOUKA_PLACEMENT_COLD = 0,
+    /*The counter is updated very frequently, it is given a cache line of its own*/
+    FLOUKA_PLACEMENT_HOT = 1,
+    /*The counter is updated mostly by one thread, it is packed with the counters of that thread*/
+    FLOUKA_PLACEMENT_OWNER = 2
+} flouka_placement_e;
+
+typedef enum flouka_hugePages
+{
+    /*The arena is mapped with the normal pages*/
+    FLOUKA_HUGE_PAGES_NONE = 0,
+    /*The kernel is advised to back the arena with transparent huge pages (when it can)*/
+    FLOUKA_HUGE_PAGES_TRANSPARENT = 1,
+    /*The arena is mapped with the reserved huge pages (MAP_HUGETLB), the initialization fails if
+      there are not enough of them*/
+    FLOUKA_HUGE_PAGES_RESERVED = 2
+} flouka_hugePages_e;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_options_s
+ *
+ * Structure Description:
+ * This structure holds the optional settings of the statistics collector object, it shall be filled
+ * by flouka_getDefaultOptions first, and then only the needed fields are changed by the user.
+ **************************************************************************************************/
+typedef struct flouka_options
+{
+    /*Number of private copies (shards) of the counters list, each thread/CPU updates its own shard
+      and the shards are summed when the counters are read, 1 disables sharding, without the
+      atomic updates a shard must only be updated by one thread at a time*/
+    uint32 shardsCount;
+    /*Returns the shard of the calling thread/CPU (ex. sched_getcpu), if NULL every thread is given
+      a shard of the object in round robin fashion on its first update of it, and the threads
+      beyond the other shards all share the last one, which is always updated atomically, a
+      function that may return the same shard to two threads at once needs the isAtomic option*/
+    ShardIndexFuncPtr shardIndexFunction_Ptr;
+    /*Indicates whether the counters are updated using (relaxed) atomic operations, so that updates
+      of the same counter from multiple threads are never lost*/
+    bool isAtomic;
+    /*Number of slots (power of two) of the per thread table in which the updates are accumulated
+      before being added to the shared counters by flouka_flush, or when the statistics are read,
+      0 disables the deferred updates (the table of a thread is updated by plain loads and stores,
+      while the shared counters always use atomic operations in the deferred mode)*/
+    uint32 deferredSlotsCount;
+    /*Maximum number of counters assigned with FLOUKA_PLACEMENT_HOT, each one takes a cache line*/
+    uint32 hotCountersCount;
+    /*Number of owners (threads) that counters can be assigned to with FLOUKA_PLACEMENT_OWNER, the
+      counters are laid out by their IDs unless hotCountersCount or ownersCount is non-zero*/
+    uint32 ownersCount;
+    /*Name of the POSIX shared memory segment (ex. "/my_application") the counters and the
+      information are exported to (see flouka_shm.h), NULL disables the export, the name must stay
+      valid until the object is destroyed*/
+    const char* sharedMemoryName_Ptr;
+    /*Size in bytes of the area reserved for the serialized information in the shared memory
+      segment, it must be at least flouka_getInformationSize plus the length header*/
+    uint32 sharedMemoryInformationSize;
+    /*Indicates whether the shared memory segment is created without a name (memfd), nothing is
+      then created on the file system, sharedMemoryName_Ptr only labels the segment for debugging,
+      and the readers get the segment from flouka_getSharedMemoryDescriptor (ex. passed to them by
+      the local socket of the statistics server, see flouka_server.h)*/
+    bool isSharedMemoryAnonymous;
+    /*Path of the file the counters are persisted to (memory mapped), the counters keep their values
+      across restarts as long as they are assigned the same sub group, unit and name, NULL disables
+      the persistence, the file is cleared if it was created with different counts or options*/
+    const char* persistenceFileName_Ptr;
+    /*Number of counters the object may grow to with flouka_grow, the memory of the counters is
+      reserved for all of them, and committed in segments as the counters are added, so that the
+      counters never move (the updates stay lock free), 0 means the object cannot grow beyond
+      totalCountersCount, growing is not supported with the placement hints, the shared memory
+      export, or the persistence (the initialization fails if any of them is given too)*/
+    uint32 maximumCountersCount;
+    /*Indicates whether the object, its information lists, and the counters are allocated from one
+      memory mapped arena sized (and populated) at initialization, instead of the allocation
+      function, the counters and the statistics buffer start on a page of their own after the
+      information, the lists allocated after the initialization still use the allocation
+      function*/
+    bool isArenaAllocated;
+    /*Huge pages the arena is mapped with (ignored if the arena is not used), its size is rounded up
+      to a whole number of huge pages*/
+    flouka_hugePages_e hugePages;
+    /*Indicates whether the counters are sharded by the NUMA nodes, shardsCount is then the number
+      of the online nodes, the shard of a thread is the node of the CPU it runs on, every shard is
+      bound to the memory of its node (mbind, unless the counters are persisted), the updates are
+      atomic (the threads of a node share its shard), and the updates of every node are counted
+      per thread (see flouka_getNodeUpdates), the shard function must be NULL, and the mode has no
+      effect on a system with one node*/
+    bool isNumaLocal;
+    /*Indicates whether the snapshots are taken at a single point in time (see flouka_getSnapshot),
+      the shards are doubled (one half per epoch, a snapshot closes the epoch and waits for its
+      updates to finish), and every update costs two more atomic operations on a cache line of the
+      shard, the updates cannot be deferred in this mode*/
+    bool isSnapshotConsistent;
+} flouka_options_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_snapshotInfo_s
+ *
+ * Structure Description:
+ * This structure describes a snapshot of the statistics returned by flouka_getSnapshot.
+ **************************************************************************************************/
+typedef struct flouka_snapshotInfo
+{
+    /*Incremented by one for every snapshot taken, the first snapshot is number 1*/
+    uint32 sequenceNumber;
+    /*Time (CLOCK_MONOTONIC) at which the snapshot was taken, the seconds part*/
+    uint32 timestampSeconds;
+    /*Time (CLOCK_MONOTONIC) at which the snapshot was taken, the nanoseconds part*/
+    uint32 timestampNanoseconds;
+} flouka_snapshotInfo_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_groupDescriptor_s, flouka_subGroupDescriptor_s, flouka_counterDescriptor_s
+ *
+ * Structure Description:
+ * These structures describe a group, a sub group and a counter with the same arguments as
+ * flouka_assignGroup, flouka_assignSubGroup and flouka_assignCounter, so that they can be kept in
+ * constant tables (see flouka_schema.h), and assigned in bulk by flouka_assignGroups,
+ * flouka_assignSubGroups and flouka_assignCounters.
+ **************************************************************************************************/
+typedef struct flouka_groupDescriptor
+{
+    uint32 groupID;
+    const char* groupName_Ptr;
+    const char* groupDescription_Ptr;
+} flouka_groupDescriptor_s;
+
+typedef struct flouka_subGroupDescriptor
+{
+    uint32 subgroupID;
+    uint32 groupID;
+    const char* subgroupName_Ptr;
+    const char* subgroupDescription_Ptr;
+} flouka_subGroupDescriptor_s;
+
+typedef struct flouka_counterDescriptor
+{
+    uint32 counterID;
+    uint32 subgroupID;
+    const char* unit_Ptr;
+    const char* counterName_Ptr;
+    const char* counterDescription_Ptr;
+} flouka_counterDescriptor_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_schema_s
+ *
+ * Structure Description:
+ * This structure describes all the groups, sub groups and counters of a schema, it is normally
+ * defined by FLOUKA_DEFINE_SCHEMA (see flouka_schema.h), and assigned by flouka_assignSchema.
+ **************************************************************************************************/
+typedef struct flouka_schema
+{
+    /*Points to the groups of the schema, and holds their number*/
+    const flouka_groupDescriptor_s* groupList_Ptr;
+    uint32 groupsCount;
+    /*Points to the sub groups of the schema, and holds their number*/
+    const flouka_subGroupDescriptor_s* subGroupList_Ptr;
+    uint32 subGroupsCount;
+    /*Points to the counters of the schema, and holds their number*/
+    const flouka_counterDescriptor_s* counterList_Ptr;
+    uint32 countersCount;
+} flouka_schema_s;
+
+/***************************************************************************************************
+ *  Name        : flouka_getDefaultOptions
+ *
+ *  Arguments   : flouka_options_s*     options_Ptr
+ *
+ *  Description : This function fills the given options with the default settings, which are the
+ *                settings used by flouka_init.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_getDefaultOptions(flouka_options_s* options_Ptr);
 
 /***************************************************************************************************
  *  Name        : flouka_init
@@ -73,6 +260,36 @@ flouka_status_e flouka_init(flouka_s** flouka_Pointer_Ptr,
                             UnlockFuncPtr unlockFunction_Ptr COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
+/***************************************************************************************************
+ *  Name        : flouka_initWithOptions
+ *
+ *  Arguments   : flouka_s**                flouka_Pointer_Ptr,
+ *                uint32                    totalGroupsCount,
+ *                uint32                    totalSubGroupsCount,
+ *                uint32                    totalCountersCount,
+ *                AllocFuncPtr              allocationFunction_Ptr,
+ *                DeallocFuncPtr            deallocationFunction_Ptr
+ *                LockFuncPtr               lockFunction_Ptr
+ *                UnlockFuncPtr             unlockFunction_Ptr
+ *                const flouka_options_s*   options_Ptr
+ *
+ *  Description : This function is the same as flouka_init, except that it takes the optional
+ *                settings of the statistics collector object, passing NULL options is the same as
+ *                calling flouka_init.
+ *
+ *  Returns     : flouka_status_e
+ **************************************************************************************************/
+flouka_status_e flouka_initWithOptions(flouka_s** flouka_Pointer_Ptr,
+                                       uint32 totalGroupsCount,
+                                       uint32 totalSubGroupsCount,
+                                       uint32 totalCountersCount,
+                                       AllocFuncPtr allocationFunction_Ptr,
+                                       DeallocFuncPtr deallocationFunction_Ptr,
+                                       LockFuncPtr lockFunction_Ptr,
+                                       UnlockFuncPtr unlockFunction_Ptr,
+                                       const flouka_options_s* options_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
 /***************************************************************************************************
  *  Name        : flouka_destroy
  *
@@ -85,6 +302,30 @@ flouka_status_e flouka_init(flouka_s** flouka_Pointer_Ptr,
 void flouka_destroy(flouka_s* flouka_Ptr COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
+/***************************************************************************************************
+ *  Name        : flouka_grow
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint32        totalGroupsCount,
+ *                uint32        totalSubGroupsCount,
+ *                uint32        totalCountersCount
+ *
+ *  Description : This function raises the total number of groups, sub groups and counters of the
+ *                object (ex. to add the counters of a new connection), the new IDs are then
+ *                assigned as usual, a total that is less than the current one is ignored.
+ *
+ *                The existing counters are never moved, and they may be updated by the other
+ *                threads meanwhile, the statistics and the information grow by the new counters.
+ *
+ *  Returns     : flouka_status_e (failure if the counters exceed maximumCountersCount of the
+ *                options, or their memory cannot be committed, nothing is changed then)
+ **************************************************************************************************/
+flouka_status_e flouka_grow(flouka_s* flouka_Ptr,
+                            uint32 totalGroupsCount,
+                            uint32 totalSubGroupsCount,
+                            uint32 totalCountersCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
 /***************************************************************************************************
  *  Name        : flouka_assignGroup
  *
@@ -99,6 +340,9 @@ void flouka_destroy(flouka_s* flouka_Ptr COMMA()
  *                statistics. This allows the presentation software (Web, GUI, Console) to
  *                categorize the different counters in groups.
  *
+ *                The name and the description are copied by the library (see
+ *                flouka_assignCounter).
+ *
  *  Returns     : void
  **************************************************************************************************/
 void flouka_assignGroup(flouka_s* flouka_Ptr,
@@ -126,6 +370,9 @@ void flouka_assignGroup(flouka_s* flouka_Ptr,
  *                the counters of a specific connection, This allows the presentation software
  *                (Web, GUI, Console) to categorize the related counters in separate sub groups.
  *
+ *                The name and the description are copied by the library (see
+ *                flouka_assignCounter).
+ *
  *  Returns     : void
  **************************************************************************************************/
 void flouka_assignSubGroup(flouka_s* flouka_Ptr,
@@ -147,6 +394,11 @@ void flouka_assignSubGroup(flouka_s* flouka_Ptr,
  *  Description : This function creates a new counter and initialize it, each counter is a 32-bit
  *                unsigned integer value.
  *
+ *                The unit, the name and the description are interned, the library keeps one copy
+ *                of every distinct string (ex. the same unit or description given to many
+ *                counters), so the given strings may be built on the stack, and released or
+ *                reused after the call.
+ *
  *  Returns     : void
  **************************************************************************************************/
 void flouka_assignCounter(flouka_s* flouka_Ptr,
@@ -157,6 +409,286 @@ void flouka_assignCounter(flouka_s* flouka_Ptr,
                           const char* counterDescription_Ptr COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
+/***************************************************************************************************
+ *  Name        : flouka_assignCounterWithPlacement
+ *
+ *  Arguments   : flouka_s*             flouka_Ptr,
+ *                uint32                counterID,
+ *                uint32                subgroupID,
+ *                const char*           counterName_Ptr,
+ *                const char*           counterDescription_Ptr,
+ *                flouka_placement_e    placement,
+ *                uint32                ownerIndex
+ *
+ *  Description : This function is the same as flouka_assignCounter, except that it takes a hint
+ *                of how the counter is updated, which is used to place the counter value in
+ *                memory, so that counters updated by different threads never share a cache line.
+ *
+ *                The ownerIndex (less than the ownersCount option) is only used with the
+ *                FLOUKA_PLACEMENT_OWNER placement, the hint is ignored if the object is not
+ *                initialized with hotCountersCount or ownersCount options, and the placement
+ *                never changes the counter ID, or the layout of the statistics buffer.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignCounterWithPlacement(flouka_s* flouka_Ptr,
+                                       uint32 counterID,
+                                       uint32 subgroupID,
+                                       const char* unit_Ptr,
+                                       const char* counterName_Ptr,
+                                       const char* counterDescription_Ptr,
+                                       flouka_placement_e placement,
+                                       uint32 ownerIndex COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignSchema
+ *
+ *  Arguments   : flouka_s*                 flouka_Ptr,
+ *                const flouka_schema_s*    schema_Ptr
+ *
+ *  Description : This function assigns all the groups, then all the sub groups, and then all the
+ *                counters of the given schema (see flouka_schema.h), under one lock of the object,
+ *                as if every one of them was assigned by its own function, and the information
+ *                is serialized once, when it is next requested. The whole schema is validated
+ *                (in the DEBUG build) before any of it is assigned.
+ *
+ *                The object must be initialized with at least the counts of the schema, more
+ *                groups, sub groups and counters (ex. families) may be assigned after it.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignSchema(flouka_s* flouka_Ptr,
+                         const flouka_schema_s* schema_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignGroups
+ *
+ *  Arguments   : flouka_s*                         flouka_Ptr,
+ *                const flouka_groupDescriptor_s*   groupList_Ptr,
+ *                uint32                            groupsCount
+ *
+ *  Description : This function assigns the given list of groups in their order, under one lock of
+ *                the object, as if every one of them was assigned by flouka_assignGroup, and the
+ *                information is serialized once, when it is next requested.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignGroups(flouka_s* flouka_Ptr,
+                         const flouka_groupDescriptor_s* groupList_Ptr,
+                         uint32 groupsCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignSubGroups
+ *
+ *  Arguments   : flouka_s*                             flouka_Ptr,
+ *                const flouka_subGroupDescriptor_s*    subGroupList_Ptr,
+ *                uint32                                subGroupsCount
+ *
+ *  Description : This function assigns the given list of sub groups in their order, under one
+ *                lock of the object, as if every one of them was assigned by
+ *                flouka_assignSubGroup, the groups of the sub groups must be assigned before.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignSubGroups(flouka_s* flouka_Ptr,
+                            const flouka_subGroupDescriptor_s* subGroupList_Ptr,
+                            uint32 subGroupsCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignCounters
+ *
+ *  Arguments   : flouka_s*                           flouka_Ptr,
+ *                const flouka_counterDescriptor_s*   counterList_Ptr,
+ *                uint32                              countersCount
+ *
+ *  Description : This function assigns the given list of counters in their order, under one lock
+ *                of the object, as if every one of them was assigned by flouka_assignCounter, the
+ *                sub groups of the counters must be assigned before.
+ *
+ *                Registering a large schema this way takes one lock, one validation pass over the
+ *                list before it is assigned, and one invalidation of the serialized information,
+ *                instead of one of each per counter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignCounters(flouka_s* flouka_Ptr,
+                           const flouka_counterDescriptor_s* counterList_Ptr,
+                           uint32 countersCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignSparseCounter
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint64        sparseID,
+ *                uint32        subgroupID,
+ *                const char*   unit_Ptr,
+ *                const char*   counterName_Ptr,
+ *                const char*   counterDescription_Ptr,
+ *                uint32*       counterID_Ptr
+ *
+ *  Description : This function is the same as flouka_assignCounter, except that the counter is
+ *                identified by the application with a sparse 64-bit ID (ex. a port number, or a
+ *                hash of a flow), instead of a dense counter ID.
+ *
+ *                The counter takes the lowest counter ID that is not assigned yet, it is returned
+ *                in counterID_Ptr, and it may be used as any other counter ID. The sparse IDs are
+ *                mapped to the counter IDs by flouka_getSparseCounterID, after all of them are
+ *                assigned, and flouka_freezeSparseCounters is called.
+ *
+ *  Returns     : flouka_status_e (FLOUKA_STATUS_FAILURE if all the counter IDs are assigned)
+ **************************************************************************************************/
+flouka_status_e flouka_assignSparseCounter(flouka_s* flouka_Ptr,
+                                           uint64 sparseID,
+                                           uint32 subgroupID,
+                                           const char* unit_Ptr,
+                                           const char* counterName_Ptr,
+                                           const char* counterDescription_Ptr,
+                                           uint32* counterID_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_freezeSparseCounters
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr
+ *
+ *  Description : This function builds the table which maps the sparse IDs to the counter IDs, it
+ *                is called once, after all the sparse counters are assigned, and no sparse counter
+ *                can be assigned after that.
+ *
+ *                The table is an open addressing hash table, that has at least twice as many
+ *                entries as the sparse counters, so that a look up mostly costs a single load of
+ *                the table, besides the load of the counter.
+ *
+ *  Returns     : flouka_status_e (FLOUKA_STATUS_FAILURE if a sparse ID is assigned twice)
+ **************************************************************************************************/
+flouka_status_e flouka_freezeSparseCounters(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getSparseCounterID
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint64        sparseID
+ *
+ *  Description : This function returns the counter ID of the given sparse ID, it may be called
+ *                from any thread without locking, after flouka_freezeSparseCounters.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+INLINE uint32 flouka_getSparseCounterID(flouka_s* flouka_Ptr,
+                                        uint64 sparseID COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignFamily
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint32        familyID,
+ *                uint32        groupID,
+ *                uint32        firstCounterID,
+ *                uint32        membersCount,
+ *                uint32        instancesCount,
+ *                const char*   familyName_Ptr,
+ *                const char*   familyDescription_Ptr
+ *
+ *  Description : This function creates a new family of counters, a family describes a set of
+ *                counters (its members) once, and holds a number of labeled instances of them, for
+ *                example, a protocol stack project may create a family for the reception path of
+ *                the connections, where each connection is an instance of the family, labeled by
+ *                the connection name, that holds the bytes received and the reception failures of
+ *                the connection.
+ *
+ *                The family reserves the membersCount * instancesCount counters from the
+ *                firstCounterID, they are not assigned by flouka_assignCounter, the members are
+ *                described by flouka_assignFamilyMember, and the instances are added and removed
+ *                at run time by flouka_addFamilyInstance and flouka_removeFamilyInstance.
+ *
+ *                The name and the description are copied by the library (see
+ *                flouka_assignCounter).
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignFamily(flouka_s* flouka_Ptr,
+                         uint32 familyID,
+                         uint32 groupID,
+                         uint32 firstCounterID,
+                         uint32 membersCount,
+                         uint32 instancesCount,
+                         const char* familyName_Ptr,
+                         const char* familyDescription_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_assignFamilyMember
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint32        familyID,
+ *                uint32        memberIndex,
+ *                const char*   unit_Ptr,
+ *                const char*   counterName_Ptr,
+ *                const char*   counterDescription_Ptr
+ *
+ *  Description : This function describes a member of the given family, the description is shared
+ *                by the counter of the member in every instance of the family, the strings are
+ *                copied by the library (see flouka_assignCounter).
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_assignFamilyMember(flouka_s* flouka_Ptr,
+                               uint32 familyID,
+                               uint32 memberIndex,
+                               const char* unit_Ptr,
+                               const char* counterName_Ptr,
+                               const char* counterDescription_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_addFamilyInstance
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint32        familyID,
+ *                const char*   label_Ptr,
+ *                uint32*       firstCounterID_Ptr
+ *
+ *  Description : This function adds a new instance with the given label to the given family, the
+ *                instance takes a free slot of the family (a slot of a removed instance is reused),
+ *                and its counters are reset to zero.
+ *
+ *                The first counter ID of the instance is returned in firstCounterID_Ptr, the
+ *                counter ID of a member of the instance is the first counter ID plus the member
+ *                index, and it may be used as any other counter ID.
+ *
+ *  Returns     : flouka_status_e (FLOUKA_STATUS_FAILURE if all the slots of the family are used)
+ **************************************************************************************************/
+flouka_status_e flouka_addFamilyInstance(flouka_s* flouka_Ptr,
+                                         uint32 familyID,
+                                         const char* label_Ptr,
+                                         uint32* firstCounterID_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_removeFamilyInstance
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr,
+ *                uint32        familyID,
+ *                uint32        firstCounterID
+ *
+ *  Description : This function removes the instance of the given family, that starts at the given
+ *                first counter ID, its slot is freed, and reused by the next added instance
+ *                without changing the description of the family.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_removeFamilyInstance(flouka_s* flouka_Ptr,
+                                 uint32 familyID,
+                                 uint32 firstCounterID COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
 /***************************************************************************************************
  *  Name        : flouka_getInformationSize
  *
@@ -180,11 +712,142 @@ uint32 flouka_getInformationSize(flouka_s* flouka_Ptr COMMA()
  *
  *  Description : This function fills the infoBuffer with the statistics setup information.
  *
+ *                The information is serialized once and cached, the cache is rebuilt only after a
+ *                group, sub group or counter is assigned.
+ *
+ *                The information may be read before all the IDs are assigned, the unassigned
+ *                groups, sub groups and counters have empty strings, and their parent ID is
+ *                FLOUKA_UNASSIGNED_ID.
+ *
+ *                The counters reserved by the families are serialized as unassigned counters, the
+ *                families are serialized after the counters (the number of families, then every
+ *                family once, with its members and the first counter ID and the label of each of
+ *                its added instances).
+ *
+ *                The information is copied under the lock of the object, only if it fits in the
+ *                given buffer, the information may have grown since flouka_getInformationSize
+ *                was called (ex. a counter was assigned meanwhile), the caller then takes the size
+ *                again and retries.
+ *
+ *  Returns     : uint32 (the size copied, with the length header, zero if the information does
+ *                not fit in the given buffer)
+ **************************************************************************************************/
+uint32 flouka_getInformation(flouka_s* flouka_Ptr,
+                             uint8* informationBuffer_Ptr,
+                             uint32 allocatedInfoBufferSize COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getInformationBuffer
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint8**     informationBufferPointer_Ptr,
+ *                uint32*     informationBufferSize_Ptr
+ *
+ *  Description : This function returns the cached statistics setup information (the same content
+ *                filled by flouka_getInformation) without copying it, a new buffer is built after
+ *                the next group, sub group or counter assignment, but the returned buffer stays
+ *                valid (unchanged) until the object is destroyed, and it must not be changed.
+ *
  *  Returns     : void
  **************************************************************************************************/
-void flouka_getInformation(flouka_s* flouka_Ptr,
-                           uint8* informationBuffer_Ptr,
-                           uint32 allocatedInfoBufferSize COMMA()
+void flouka_getInformationBuffer(flouka_s* flouka_Ptr,
+                                 uint8** informationBufferPointer_Ptr,
+                                 uint32* informationBufferSize_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getIndexedInformation
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint8**     indexBufferPointer_Ptr,
+ *                uint32*     indexBufferSize_Ptr
+ *
+ *  Description : This function returns the statistics setup information in the indexed layout
+ *                (see flouka_index.h), in which any group, sub group or counter is looked up by its
+ *                ID without parsing the buffer, and the integers have the same size and byte order
+ *                on all hosts, every distinct string is stored once in it.
+ *
+ *                The buffer is built once and cached, it is built again after the next group, sub
+ *                group or counter assignment (or family instance change), but the returned buffer
+ *                stays valid (unchanged) until the object is destroyed, so it may be used without
+ *                the lock, and it must not be changed.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_getIndexedInformation(flouka_s* flouka_Ptr,
+                                  uint8** indexBufferPointer_Ptr,
+                                  uint32* indexBufferSize_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getGroupCounters
+ *
+ *  Arguments   : flouka_s*        flouka_Ptr,
+ *                uint32          groupID,
+ *                const uint32**  counterIDListPointer_Ptr,
+ *                uint32*         countersCount_Ptr
+ *
+ *  Description : This function returns the IDs of all the counters of the given group, ordered by
+ *                their sub groups (the sub groups of the group in their IDs order), and then by
+ *                their IDs.
+ *
+ *                The lists of all the groups and sub groups are built once from the assignments and
+ *                cached, they are built again after the next group, sub group or counter
+ *                assignment, but the returned list stays valid (unchanged) until the object is
+ *                destroyed, so it may be walked without the lock, and it must not be changed.
+ *
+ *  Returns     : flouka_status_e (failure if the group ID is invalid)
+ **************************************************************************************************/
+flouka_status_e flouka_getGroupCounters(flouka_s* flouka_Ptr,
+                                        uint32 groupID,
+                                        const uint32** counterIDListPointer_Ptr,
+                                        uint32* countersCount_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getSubGroupCounters
+ *
+ *  Arguments   : flouka_s*        flouka_Ptr,
+ *                uint32          subgroupID,
+ *                const uint32**  counterIDListPointer_Ptr,
+ *                uint32*         countersCount_Ptr
+ *
+ *  Description : This function returns the IDs of all the counters of the given sub group, ordered
+ *                by their IDs, the returned list is the same as flouka_getGroupCounters.
+ *
+ *  Returns     : flouka_status_e (failure if the sub group ID is invalid)
+ **************************************************************************************************/
+flouka_status_e flouka_getSubGroupCounters(flouka_s* flouka_Ptr,
+                                           uint32 subgroupID,
+                                           const uint32** counterIDListPointer_Ptr,
+                                           uint32* countersCount_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getSchemaGeneration
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr
+ *
+ *  Description : This function returns the schema generation, which is incremented on every
+ *                group, sub group or counter assignment, a client that already holds the setup
+ *                information of the same generation does not need to request it again.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+uint32 flouka_getSchemaGeneration(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getStatisticsSize
+ *
+ *  Arguments   : flouka_s*     flouka_Ptr
+ *
+ *  Description : This function returns the size of the statistics buffer in bytes.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+uint32 flouka_getStatisticsSize(flouka_s* flouka_Ptr COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
 /***************************************************************************************************
@@ -203,6 +866,20 @@ void flouka_getInformation(flouka_s* flouka_Ptr,
  *                pointer and the length doesn't change during the course of the program, but the
  *                data pointed to by the pointer do change.
  *
+ *                The length grows when the object grows (see flouka_grow), the pointer does not
+ *                change. The buffer is shared by all the callers, every counter in it is only ever
+ *                overwritten by its newer value, so it may be read while another thread calls this
+ *                function.
+ *
+ *                The counters are read one by one while the updates go on, so every counter is
+ *                exact but the buffer is not a single point in time (ex. an update of two counters
+ *                may be seen in one of them only).
+ *
+ *                When the counters are sharded, the shards are summed into the statistics buffer
+ *                by this function, so it shall be called every time before sending the buffer.
+ *                The same applies to the deferred mode, where this function collects the updates
+ *                pending in the deferred tables of all the threads.
+ *
  *  Returns     : void
  **************************************************************************************************/
 void flouka_getStatistics(flouka_s* flouka_Ptr,
@@ -210,6 +887,62 @@ void flouka_getStatistics(flouka_s* flouka_Ptr,
                           uint32* statisticsBufferSize_Ptr COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
+/***************************************************************************************************
+ *  Name        : flouka_getSnapshot
+ *
+ *  Arguments   : flouka_s*                 flouka_Ptr,
+ *                uint8**                   statisticsBufferPointer_Ptr,
+ *                uint32*                   statisticsBufferSize_Ptr,
+ *                flouka_snapshotInfo_s*    snapshotInfo_Ptr
+ *
+ *  Description : This function is the same as flouka_getStatistics, except that the returned
+ *                buffer is a private copy of the counters, so it does not change while it is being
+ *                sent (the counters updated during the send are not mixed with the older values),
+ *                the copy is described by the snapshotInfo_Ptr (may be NULL).
+ *
+ *                The copy is a single point in time only if the isSnapshotConsistent option is
+ *                set, the snapshot then waits for the updates in progress (never the other way
+ *                around), otherwise the counters are copied one by one while the updates go on.
+ *
+ *                The snapshots are taken into two buffers alternately, so the buffer returned
+ *                stays valid until this function is called twice more, the updates of the counters
+ *                never wait for the snapshot, which costs one pass over the counters. The buffers
+ *                belong to one reader (ex. the application), every other reader (ex. another
+ *                thread) shall take its snapshots into its own buffer (see flouka_copySnapshot), the
+ *                server and the delta encoder do so.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_getSnapshot(flouka_s* flouka_Ptr,
+                        uint8** statisticsBufferPointer_Ptr,
+                        uint32* statisticsBufferSize_Ptr,
+                        flouka_snapshotInfo_s* snapshotInfo_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_copySnapshot
+ *
+ *  Arguments   : flouka_s*                 flouka_Ptr,
+ *                uint8*                    statisticsBuffer_Ptr,
+ *                uint32                    allocatedStatisticsBufferSize,
+ *                flouka_snapshotInfo_s*    snapshotInfo_Ptr
+ *
+ *  Description : This function is the same as flouka_getSnapshot, except that the snapshot is
+ *                taken into the given buffer (at least flouka_getStatisticsSize bytes), so the
+ *                caller controls how long it stays valid (ex. until it is sent without copying it
+ *                to the socket), and it is not copied again.
+ *
+ *                If the object grew after the size was taken (see flouka_grow), only the counters
+ *                that fit in the buffer are copied (the new counters are always the last ones).
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_copySnapshot(flouka_s* flouka_Ptr,
+                         uint8* statisticsBuffer_Ptr,
+                         uint32 allocatedStatisticsBufferSize,
+                         flouka_snapshotInfo_s* snapshotInfo_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
 /***************************************************************************************************
  *  Name        : flouka_incrementCounter
  *
@@ -308,7 +1041,9 @@ INLINE void flouka_resetCounter(flouka_s*   flouka_Ptr,
  *  Arguments   : flouka_s*    flouka_Ptr,
  *                uint32      counterID
  *
- *  Description : This function return the current value of the given counter.
+ *  Description : This function return the current value of the given counter, when the counters
+ *                are sharded the values of the counter in all the shards are summed, and in the
+ *                deferred mode the pending updates of all the threads are collected first.
  *
  *  Returns     : void
  **************************************************************************************************/
@@ -316,5 +1051,169 @@ INLINE uint32 flouka_getCounter(flouka_s* flouka_Ptr,
                                   uint32 counterID COMMA()
                                                      FILE_AND_LINE_FOR_TYPE());
 
+/***************************************************************************************************
+ *  Name        : flouka_readAndResetCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID
+ *
+ *  Description : This function resets the given counter to zero and returns the value it had just
+ *                before the reset, in the atomic mode the value is swapped atomically, so no update
+ *                is lost between reading and resetting the counter.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+uint32 flouka_readAndResetCounter(flouka_s* flouka_Ptr,
+                                  uint32 counterID COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_applyDeltas
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr,
+ *                const uint32*   counterIDList_Ptr,
+ *                const uint32*   deltaList_Ptr,
+ *                uint32          deltasCount
+ *
+ *  Description : This function increases each counter in the given list of counter IDs by the
+ *                delta at the same index in the given list of deltas, it is equivalent to calling
+ *                flouka_increaseCounter for every counter, but the batch is validated and the
+ *                counters shard is looked up only once.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_applyDeltas(flouka_s* flouka_Ptr,
+                        const uint32* counterIDList_Ptr,
+                        const uint32* deltaList_Ptr,
+                        uint32 deltasCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_applyDenseDeltas
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr,
+ *                uint32          firstCounterID,
+ *                const uint32*   deltaList_Ptr,
+ *                uint32          deltasCount
+ *
+ *  Description : This function increases the deltasCount consecutive counters starting from
+ *                firstCounterID by the corresponding deltas in the given list of deltas.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_applyDenseDeltas(flouka_s* flouka_Ptr,
+                             uint32 firstCounterID,
+                             const uint32* deltaList_Ptr,
+                             uint32 deltasCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_flush
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr
+ *
+ *  Description : This function adds the updates accumulated in the deferred table of the calling
+ *                thread to the shared counters, it shall be called at the end of every batch of
+ *                updates (ex. after processing a burst of packets), it does nothing if the object
+ *                is not initialized in the deferred mode.
+ *
+ *                The deferred tables of all the threads are also collected whenever the counters
+ *                are read (flouka_getStatistics, flouka_getCounter, ...), so the flush only limits
+ *                how old the values seen by the other threads of the application may be.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_flush(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_publishSharedMemory
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr
+ *
+ *  Description : This function updates the shared memory segment the object is exported to (see
+ *                flouka_shm.h), the information is copied to the segment if it changed since the
+ *                last publish, and the counters are copied too unless the segment holds the list
+ *                of counters itself (the counters are neither sharded, placed, nor persisted).
+ *
+ *                It shall be called once all the groups, sub groups and counters are assigned,
+ *                and then periodically if the counters are sharded, placed, persisted, or
+ *                deferred.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_publishSharedMemory(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getSharedMemoryDescriptor
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr
+ *
+ *  Description : This function returns a read only file descriptor of the shared memory segment
+ *                the object is exported to, so that it can be passed to a reader process (see
+ *                flouka_sharedMemoryAttachDescriptor), the descriptor is owned by the object.
+ *
+ *  Returns     : int32 (-1 if the object is not exported to shared memory, or its segment could not
+ *                be opened read only)
+ **************************************************************************************************/
+int32 flouka_getSharedMemoryDescriptor(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_syncPersistentCounters
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr
+ *
+ *  Description : This function writes the persisted counters to the file (msync), and waits until
+ *                they are written, the pending deferred updates of all the threads are collected
+ *                first.
+ *
+ *                Calling it is optional, the operating system writes the changed pages of the file
+ *                on its own (even if the process crashes), the function only limits what is lost
+ *                if the whole system goes down, so it may be called periodically (ex. every
+ *                minute) from a low priority thread.
+ *
+ *  Returns     : flouka_status_e
+ **************************************************************************************************/
+flouka_status_e flouka_syncPersistentCounters(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getNodesCount
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr
+ *
+ *  Description : This function returns the number of NUMA nodes the counters are sharded by (see
+ *                the isNumaLocal option), the nodes are indexed in the order of their IDs in the
+ *                online nodes list of the system (ex. the index 1 is the node 2 if the list is
+ *                "0,2").
+ *
+ *  Returns     : uint32 (0 if the counters are not sharded by the NUMA nodes)
+ **************************************************************************************************/
+uint32 flouka_getNodesCount(flouka_s* flouka_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_getNodeUpdates
+ *
+ *  Arguments   : flouka_s*       flouka_Ptr,
+ *                uint32          nodeIndex
+ *
+ *  Description : This function returns the number of updates done by the threads running on the
+ *                CPUs of the given NUMA node, so that the share of every node shows whether the
+ *                threads are placed as expected (ex. the updates of a thread that is pinned to
+ *                one node are all counted on that node).
+ *
+ *                Every thread counts its own updates (no shared cache line is written), and they
+ *                are summed by this function, the number wraps around, so only the shares are
+ *                meaningful.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+uint32 flouka_getNodeUpdates(flouka_s* flouka_Ptr,
+                             uint32 nodeIndex COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
 #endif /* FLOUKA_H_ */
 
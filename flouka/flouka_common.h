@@ -95,6 +95,10 @@
 
 #define LENGTH_HEADER_SIZE 4
 
+#ifndef FLOUKA_CACHE_LINE_SIZE
+#define FLOUKA_CACHE_LINE_SIZE 64
+#endif
+
 
 
 /***************************************************************************************************
@@ -102,6 +106,9 @@
  *  T Y P E S
  *
  **************************************************************************************************/
+typedef unsigned long long uint64;
+typedef signed   long long int64;
+
 typedef unsigned long  uint32;
 typedef signed   long  int32;
 
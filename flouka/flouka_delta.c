@@ -0,0 +1,437 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ *
+ *                                       I N C L U D E S
+ *
+ **************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flouka.h"
+#include "flouka_delta.h"
+
+/***************************************************************************************************
+ *
+ *                                         M A C R O S
+ *
+ **************************************************************************************************/
+
+/*This macro is used to verify that the delta encoder is initialized properly.*/
+#define FLOUKA_DELTA_INITIALIZATION_PATTEREN    (0x43214321)
+
+/*Size of the fields that precede the counters in every message*/
+#define FLOUKA_DELTA_HEADER_SIZE          (sizeof(uint32) + sizeof(uint32) + sizeof(uint8))
+
+/*Maximum number of bytes of a varint encoding one counter difference*/
+#define FLOUKA_DELTA_VARINT_MAXIMUM_SIZE  (((sizeof(uint32) * 8) + 6) / 7)
+
+/***************************************************************************************************
+ *
+ *                                          T Y P E S
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_deltaEncoder_s
+ *
+ * Structure Description:
+ * This structure represents the delta encoder class type, one is instantiated for every client,
+ * and it remembers the values last sent to that client.
+ **************************************************************************************************/
+struct flouka_deltaEncoder
+{
+    /*Points to the statistics collector object the snapshots are taken from*/
+    flouka_s* flouka_Ptr;
+    /*Points to the function that will be used to allocate the list of the last values again when
+      the statistics collector object grows*/
+    AllocFuncPtr allocationFunction_Ptr;
+    /*Points to the function that will be used to release the allocated memory*/
+    DeallocFuncPtr deallocationFunction_Ptr;
+    /*Holds the values of the counters in the last message sent to the client*/
+    uint32* lastValuesList_Ptr;
+    /*Holds the snapshot being encoded, every encoder takes the snapshots into its own list, so that
+      the encoders of the different clients never share a snapshot buffer*/
+    uint32* valuesList_Ptr;
+    /*Holds the number of counters*/
+    uint32 countersCount;
+    /*Indicates whether the client holds the values of lastValuesList_Ptr*/
+    bool isSynchronized;
+#ifdef DEBUG
+    uint32 initializationPattern;
+#endif /**/
+};
+
+/***************************************************************************************************
+ *
+ *                      I N T E R N A L   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+STATIC INLINE uint8* DeltaEncoder_encodeVarint(uint8* buffer_Ptr,
+                                               uint32 difference)
+{
+    uint32 value;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Zigzag encode the difference, so that small negative differences are small numbers too.
+     * 2. Write the value seven bits at a time, the least significant group first.
+     * 3. Return the buffer pointer after advancing it by the size of bytes encoded.
+     */
+    value = (difference << 1) ^ (uint32) (((int32) difference) >> ((sizeof(difference) * 8) - 1));
+
+    while(value >= 0x80)
+    {
+        *buffer_Ptr = (uint8) (value | 0x80);
+        buffer_Ptr++;
+        value >>= 7;
+    }
+    *buffer_Ptr = (uint8) value;
+    buffer_Ptr++;
+
+    return (buffer_Ptr);
+}
+
+STATIC uint32 DeltaEncoder_encodeFull(flouka_deltaEncoder_s* deltaEncoder_Ptr,
+                                      const uint32* valuesList_Ptr,
+                                      uint8* counters_Ptr)
+{
+    uint32 countersSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Copy the counters as is after the header, and remember them as the last values sent.
+     * 2. Return the size of the message.
+     */
+    countersSize = deltaEncoder_Ptr->countersCount * sizeof(*valuesList_Ptr);
+    memcpy(counters_Ptr, valuesList_Ptr, countersSize);
+    memcpy(deltaEncoder_Ptr->lastValuesList_Ptr, valuesList_Ptr, countersSize);
+
+    return (FLOUKA_DELTA_HEADER_SIZE + countersSize);
+}
+
+STATIC uint32 DeltaEncoder_encodeDelta(flouka_deltaEncoder_s* deltaEncoder_Ptr,
+                                       const uint32* valuesList_Ptr,
+                                       uint8* counters_Ptr)
+{
+    uint32 i;
+    uint8* bitmap_Ptr;
+    uint8* varint_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Clear the changed counters bitmap.
+     * 2. For every changed counter, set its bit, encode the difference after the bitmap, and
+     *    remember the new value as the last value sent.
+     * 3. Return the size of the message.
+     */
+    bitmap_Ptr = counters_Ptr;
+    varint_Ptr = bitmap_Ptr + ((deltaEncoder_Ptr->countersCount + 7) / 8);
+    memset(bitmap_Ptr, 0, (deltaEncoder_Ptr->countersCount + 7) / 8);
+
+    for(i = 0; i < deltaEncoder_Ptr->countersCount; i++)
+    {
+        if(valuesList_Ptr[i] != deltaEncoder_Ptr->lastValuesList_Ptr[i])
+        {
+            bitmap_Ptr[i / 8] |= (uint8) (1 << (i % 8));
+            varint_Ptr = DeltaEncoder_encodeVarint(varint_Ptr,
+                                                   valuesList_Ptr[i]
+                                                   - deltaEncoder_Ptr->lastValuesList_Ptr[i]);
+            deltaEncoder_Ptr->lastValuesList_Ptr[i] = valuesList_Ptr[i];
+        }
+    }
+
+    return (FLOUKA_DELTA_HEADER_SIZE + (uint32) (varint_Ptr - counters_Ptr));
+}
+
+STATIC uint32 DeltaEncoder_getMaximumSize(uint32 countersCount)
+{
+    uint32 fullSize;
+    uint32 deltaSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the size of the bigger of a full message, and a delta message where all the given
+     *    counters changed by the largest possible difference.
+     */
+    fullSize = countersCount * sizeof(uint32);
+    deltaSize = ((countersCount + 7) / 8) + (countersCount * FLOUKA_DELTA_VARINT_MAXIMUM_SIZE);
+
+    return (FLOUKA_DELTA_HEADER_SIZE + ((fullSize > deltaSize) ? fullSize : deltaSize));
+}
+
+STATIC void DeltaEncoder_resize(flouka_deltaEncoder_s* deltaEncoder_Ptr,
+                                uint32 allocatedMessageBufferSize)
+{
+    uint32 countersCount;
+    uint32* lastValuesList_Ptr;
+    uint32* valuesList_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Follow the growth of the statistics collector object (see flouka_grow), the lists of the
+     *    last values and of the snapshot are allocated again, and the next message is a full one.
+     * 2. Keep the current number of counters if the message of the new number does not fit in the
+     *    given buffer (the object grew after the buffer was sized), the new counters are sent in a
+     *    later message, whose buffer is sized for them.
+     */
+    countersCount = flouka_getStatisticsSize(deltaEncoder_Ptr->flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF())
+                    / sizeof(*deltaEncoder_Ptr->lastValuesList_Ptr);
+    if((countersCount > deltaEncoder_Ptr->countersCount)
+       && (DeltaEncoder_getMaximumSize(countersCount) <= allocatedMessageBufferSize))
+    {
+        lastValuesList_Ptr = (uint32*) deltaEncoder_Ptr->allocationFunction_Ptr(countersCount
+                        * sizeof(*lastValuesList_Ptr));
+        valuesList_Ptr = (uint32*) deltaEncoder_Ptr->allocationFunction_Ptr(countersCount
+                        * sizeof(*valuesList_Ptr));
+        deltaEncoder_Ptr->deallocationFunction_Ptr(deltaEncoder_Ptr->lastValuesList_Ptr);
+        deltaEncoder_Ptr->deallocationFunction_Ptr(deltaEncoder_Ptr->valuesList_Ptr);
+        deltaEncoder_Ptr->lastValuesList_Ptr = lastValuesList_Ptr;
+        deltaEncoder_Ptr->valuesList_Ptr = valuesList_Ptr;
+        deltaEncoder_Ptr->countersCount = countersCount;
+        deltaEncoder_Ptr->isSynchronized = FALSE;
+    }
+}
+
+/***************************************************************************************************
+ *
+ *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+flouka_status_e flouka_deltaEncoderInit(flouka_deltaEncoder_s** deltaEncoder_Pointer_Ptr,
+                                        flouka_s* flouka_Ptr,
+                                        AllocFuncPtr allocationFunction_Ptr,
+                                        DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                        FILE_AND_LINE_FOR_TYPE())
+{
+    flouka_deltaEncoder_s* deltaEncoder_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the deltaEncoder_Ptr (Must be NULL).
+     * 2. Validate the flouka_Ptr (not NULL).
+     * 3. Validate the allocation function pointer (not NULL).
+     * 4. Validate the deallocation function pointer (not NULL).
+     */
+    ASSERT((NULL == *deltaEncoder_Pointer_Ptr),
+                    "FLOUKA:  *deltaEncoder_Ptr pointer is not NULL, it is expected to initialize a NULL pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != allocationFunction_Ptr),
+                    "FLOUKA:  allocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != deallocationFunction_Ptr),
+                    "FLOUKA:  deallocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate the delta encoder object, the list of the last values sent, and the list of the
+     *    snapshot.
+     * 2. Mark the encoder as not synchronized, so that the first message is a full one.
+     */
+    deltaEncoder_Ptr = (flouka_deltaEncoder_s*) allocationFunction_Ptr(sizeof(*deltaEncoder_Ptr));
+    deltaEncoder_Ptr->flouka_Ptr = flouka_Ptr;
+    deltaEncoder_Ptr->allocationFunction_Ptr = allocationFunction_Ptr;
+    deltaEncoder_Ptr->deallocationFunction_Ptr = deallocationFunction_Ptr;
+    deltaEncoder_Ptr->countersCount
+                    = flouka_getStatisticsSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_CALL())
+                                    / sizeof(*deltaEncoder_Ptr->lastValuesList_Ptr);
+    deltaEncoder_Ptr->lastValuesList_Ptr
+                    = (uint32*) allocationFunction_Ptr(deltaEncoder_Ptr->countersCount
+                                    * sizeof(*deltaEncoder_Ptr->lastValuesList_Ptr));
+    deltaEncoder_Ptr->valuesList_Ptr
+                    = (uint32*) allocationFunction_Ptr(deltaEncoder_Ptr->countersCount
+                                    * sizeof(*deltaEncoder_Ptr->valuesList_Ptr));
+    deltaEncoder_Ptr->isSynchronized = FALSE;
+#ifdef DEBUG
+    deltaEncoder_Ptr->initializationPattern = FLOUKA_DELTA_INITIALIZATION_PATTEREN;
+#endif /*DEBUG*/
+
+    *deltaEncoder_Pointer_Ptr = deltaEncoder_Ptr;
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+void flouka_deltaEncoderDestroy(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    DeallocFuncPtr deallocationFunctionPointer;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the deltaEncoder_Ptr (not NULL).
+     * 2. Validate the deltaEncoder_Ptr (already initialized).
+     */
+    ASSERT((NULL != deltaEncoder_Ptr),
+                    "FLOUKA:  Invalid delta encoder pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_DELTA_INITIALIZATION_PATTEREN == deltaEncoder_Ptr->initializationPattern),
+                    "FLOUKA:  Invalid delta encoder pointer passed (either not initialized pointer, or incorrect, non-null pointer)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Deallocate the lists of the last values sent and of the snapshot, and the delta encoder
+     *    itself.
+     */
+    deallocationFunctionPointer = deltaEncoder_Ptr->deallocationFunction_Ptr;
+    deallocationFunctionPointer(deltaEncoder_Ptr->lastValuesList_Ptr);
+    deallocationFunctionPointer(deltaEncoder_Ptr->valuesList_Ptr);
+    deallocationFunctionPointer((void*) deltaEncoder_Ptr);
+}
+
+uint32 flouka_deltaEncoderGetMaximumSize(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA()
+                                         FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != deltaEncoder_Ptr),
+                    "FLOUKA:  Invalid delta encoder pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the maximum size of a message (see DeltaEncoder_getMaximumSize) for the current
+     *    number of counters of the statistics collector object (the encoder follows it on the
+     *    next encoding).
+     */
+    return (DeltaEncoder_getMaximumSize(flouka_getStatisticsSize(deltaEncoder_Ptr->flouka_Ptr COMMA()
+                                                                 FILE_AND_LINE_FOR_CALL())
+                                        / sizeof(*deltaEncoder_Ptr->lastValuesList_Ptr)));
+}
+
+void flouka_deltaEncoderResynchronize(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA()
+                                      FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != deltaEncoder_Ptr),
+                    "FLOUKA:  Invalid delta encoder pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    deltaEncoder_Ptr->isSynchronized = FALSE;
+}
+
+uint32 flouka_deltaEncoderEncode(flouka_deltaEncoder_s* deltaEncoder_Ptr,
+                                 uint8* messageBuffer_Ptr,
+                                 uint32 allocatedMessageBufferSize COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 messageSize;
+    uint8 messageType;
+    flouka_snapshotInfo_s snapshotInfo;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the deltaEncoder_Ptr (not NULL).
+     * 2. Validate the messageBuffer_Ptr (not NULL).
+     */
+    ASSERT((NULL != deltaEncoder_Ptr),
+                    "FLOUKA:  Invalid delta encoder pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != messageBuffer_Ptr),
+                    "FLOUKA:  NULL was passed as the message buffer pointer",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Follow the growth of the statistics collector object (see DeltaEncoder_resize), return zero
+     *    (nothing encoded) if the message of the current number of counters does not fit in the
+     *    given buffer, and take a snapshot of the statistics into the list of the encoder.
+     * 2. Encode the changed counters if the encoder is synchronized, and fall back to a full
+     *    message if the delta message turns out to be bigger (most of the counters changed).
+     * 3. Encode a full message if the encoder is not synchronized.
+     * 4. Fill in the header, and return the size of the message.
+     */
+    DeltaEncoder_resize(deltaEncoder_Ptr, allocatedMessageBufferSize);
+    if(DeltaEncoder_getMaximumSize(deltaEncoder_Ptr->countersCount) > allocatedMessageBufferSize)
+    {
+        return (0);
+    }
+    flouka_copySnapshot(deltaEncoder_Ptr->flouka_Ptr,
+                        (uint8*) deltaEncoder_Ptr->valuesList_Ptr,
+                        deltaEncoder_Ptr->countersCount * sizeof(*deltaEncoder_Ptr->valuesList_Ptr),
+                        &snapshotInfo COMMA()
+                        FILE_AND_LINE_FOR_CALL());
+
+    messageType = FLOUKA_DELTA_MESSAGE_TYPE_FULL;
+    if(TRUE == deltaEncoder_Ptr->isSynchronized)
+    {
+        messageType = FLOUKA_DELTA_MESSAGE_TYPE_DELTA;
+        messageSize = DeltaEncoder_encodeDelta(deltaEncoder_Ptr,
+                                               deltaEncoder_Ptr->valuesList_Ptr,
+                                               messageBuffer_Ptr + FLOUKA_DELTA_HEADER_SIZE);
+        if(messageSize > (FLOUKA_DELTA_HEADER_SIZE
+                          + (deltaEncoder_Ptr->countersCount * sizeof(*deltaEncoder_Ptr->lastValuesList_Ptr))))
+        {
+            messageType = FLOUKA_DELTA_MESSAGE_TYPE_FULL;
+        }
+    }
+
+    if(FLOUKA_DELTA_MESSAGE_TYPE_FULL == messageType)
+    {
+        messageSize = DeltaEncoder_encodeFull(deltaEncoder_Ptr,
+                                              deltaEncoder_Ptr->valuesList_Ptr,
+                                              messageBuffer_Ptr + FLOUKA_DELTA_HEADER_SIZE);
+        deltaEncoder_Ptr->isSynchronized = TRUE;
+    }
+
+    memcpy(messageBuffer_Ptr, &messageSize, sizeof(messageSize));
+    memcpy(messageBuffer_Ptr + sizeof(messageSize),
+           &(snapshotInfo.sequenceNumber),
+           sizeof(snapshotInfo.sequenceNumber));
+    messageBuffer_Ptr[sizeof(messageSize) + sizeof(snapshotInfo.sequenceNumber)] = messageType;
+
+    return (messageSize);
+}
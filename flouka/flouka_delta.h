@@ -0,0 +1,143 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_DELTA_H_
+#define FLOUKA_DELTA_H_
+
+/***************************************************************************************************
+ *
+ * The delta encoder sends to a client only the counters that changed since the last message sent
+ * to the same client, one encoder shall be created for every connected client.
+ *
+ * Message format (all the fields are in the host byte order, like the statistics buffer):
+ *
+ *   uint32    messageSize        Size of the whole message in bytes, including this field.
+ *   uint32    sequenceNumber     Sequence number of the snapshot the message is taken from.
+ *   uint8     messageType        FLOUKA_DELTA_MESSAGE_TYPE_FULL or FLOUKA_DELTA_MESSAGE_TYPE_DELTA.
+ *
+ *   FULL:     uint32[totalCountersCount] counter values, the same as the statistics buffer.
+ *
+ *   DELTA:    uint8[(totalCountersCount + 7) / 8] changed counters bitmap (bit i % 8 of byte i / 8
+ *             is set if counter i changed), followed by one varint for every changed counter in
+ *             the counter IDs order. The varint holds the difference between the new and the old
+ *             value (new - old, as a signed number) zigzag encoded (0, -1, 1, -2 ... are encoded
+ *             as 0, 1, 2, 3 ...), seven bits per byte with the least significant group first, and
+ *             the most significant bit of a byte set when more bytes follow.
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+#define FLOUKA_DELTA_MESSAGE_TYPE_FULL    (0)
+#define FLOUKA_DELTA_MESSAGE_TYPE_DELTA   (1)
+
+typedef struct flouka_deltaEncoder flouka_deltaEncoder_s;
+
+/***************************************************************************************************
+ *  Name        : flouka_deltaEncoderInit
+ *
+ *  Arguments   : flouka_deltaEncoder_s**   deltaEncoder_Pointer_Ptr,
+ *                flouka_s*                 flouka_Ptr,
+ *                AllocFuncPtr              allocationFunction_Ptr,
+ *                DeallocFuncPtr            deallocationFunction_Ptr
+ *
+ *  Description : This function creates a delta encoder for one client of the given statistics
+ *                collector object, the first message encoded is always a full one.
+ *
+ *  Returns     : flouka_status_e
+ **************************************************************************************************/
+flouka_status_e flouka_deltaEncoderInit(flouka_deltaEncoder_s** deltaEncoder_Pointer_Ptr,
+                                        flouka_s* flouka_Ptr,
+                                        AllocFuncPtr allocationFunction_Ptr,
+                                        DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_deltaEncoderDestroy
+ *
+ *  Arguments   : flouka_deltaEncoder_s*    deltaEncoder_Ptr
+ *
+ *  Description : This function releases all memory allocated by the delta encoder.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_deltaEncoderDestroy(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_deltaEncoderGetMaximumSize
+ *
+ *  Arguments   : flouka_deltaEncoder_s*    deltaEncoder_Ptr
+ *
+ *  Description : This function returns the size of the buffer which needs to be allocated for
+ *                encoding any message (full or delta), for the current number of counters of the
+ *                statistics collector object, it does not change the encoder.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+uint32 flouka_deltaEncoderGetMaximumSize(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_deltaEncoderResynchronize
+ *
+ *  Arguments   : flouka_deltaEncoder_s*    deltaEncoder_Ptr
+ *
+ *  Description : This function forgets the values last sent to the client, so that the next
+ *                message encoded is a full one, it shall be called whenever the client requests a
+ *                full snapshot or loses track of the values (ex. reconnects).
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_deltaEncoderResynchronize(flouka_deltaEncoder_s* deltaEncoder_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_deltaEncoderEncode
+ *
+ *  Arguments   : flouka_deltaEncoder_s*    deltaEncoder_Ptr,
+ *                uint8*                    messageBuffer_Ptr,
+ *                uint32                    allocatedMessageBufferSize
+ *
+ *  Description : This function takes a snapshot of the statistics (see flouka_copySnapshot), and
+ *                encodes the counters that changed since the last message into the given buffer,
+ *                a full message is encoded instead if it is not bigger than the delta one, or if
+ *                the encoder is not synchronized yet. The buffer shall be sized by
+ *                flouka_deltaEncoderGetMaximumSize, counters added by flouka_grow after that are
+ *                encoded once a message of them fits in the given buffer.
+ *
+ *  Returns     : uint32 (the size of the encoded message in bytes, zero if the buffer is too small)
+ **************************************************************************************************/
+uint32 flouka_deltaEncoderEncode(flouka_deltaEncoder_s* deltaEncoder_Ptr,
+                                 uint8* messageBuffer_Ptr,
+                                 uint32 allocatedMessageBufferSize COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+#endif /* FLOUKA_DELTA_H_ */
@@ -0,0 +1,248 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_INDEX_H_
+#define FLOUKA_INDEX_H_
+
+/***************************************************************************************************
+ *
+ * The indexed information (see flouka_getIndexedInformation) describes the same groups, sub groups
+ * and counters as the information filled by flouka_getInformation, but in a layout that allows a
+ * reader to look up any of them by its ID without parsing the whole buffer.
+ *
+ * Layout (every integer is a 32-bit little-endian unsigned integer, whatever the host is, and every
+ * offset is from the start of the buffer unless stated otherwise):
+ *
+ *   Header (FLOUKA_INDEX_HEADER_SIZE bytes):
+ *     0    magic                 FLOUKA_INDEX_MAGIC.
+ *     4    version               FLOUKA_INDEX_VERSION.
+ *     8    headerSize            Size of the header in bytes.
+ *     12   totalSize             Size of the whole buffer in bytes.
+ *     16   schemaGeneration      The schema generation (see flouka_getSchemaGeneration).
+ *     20   groups table          count, records offset, record size.
+ *     32   sub groups table      count, records offset, record size.
+ *     44   counters table        count, records offset, record size.
+ *     56   stringTableOffset     Offset of the string table.
+ *     60   stringTableSize       Size of the string table in bytes.
+ *     64   families table        count, records offset, record size.
+ *     76   members table         count, records offset, record size.
+ *     88   instances table       count, records offset, record size.
+ *
+ *   Records, one per ID (the record of ID i is at records offset + (i * record size)):
+ *     group:       name, description.
+ *     sub group:   group ID, name, description.
+ *     counter:     sub group ID, unit, name, description.
+ *     family:      group ID, first counter ID, members count, instances count, first member,
+ *                  first instance, name, description.
+ *     member:      family ID, unit, name, description.
+ *     instance:    family ID, first counter ID, label.
+ *
+ *   The members and the instances of a family are consecutive records of their tables, starting at
+ *   the first member and the first instance of the family record, there is an instance record for
+ *   every slot of the family, the label of a free slot is empty, and the counter of a member of an
+ *   instance is the first counter ID of the instance plus the index of the member (the counters of
+ *   the families are not assigned counters, their records have FLOUKA_UNASSIGNED_ID as their sub
+ *   group ID).
+ *
+ *   String table: the strings (null terminated), every string field of a record is the offset of
+ *   the string from the start of the string table. Every distinct string (ex. a unit, or a
+ *   description shared by many counters) is stored once, and all the records using it have the
+ *   same offset, so a reader may decode the string table once and look up the strings by their
+ *   offsets, the labels of the instances follow the other strings.
+ *
+ * The records of the IDs that are not assigned yet have empty strings, and their parent ID (the
+ * group ID of a sub group, or the sub group ID of a counter) is FLOUKA_UNASSIGNED_ID.
+ *
+ * A reader shall use the record sizes of the header, so that newer versions may add fields at the
+ * end of the records.
+ *
+ **************************************************************************************************/
+
+#include <flouka_common.h>
+
+/*Value of the magic field*/
+#define FLOUKA_INDEX_MAGIC                      (0x464C4B49LU)
+
+/*Value of the version field, it is changed whenever the layout is changed in an incompatible way*/
+#define FLOUKA_INDEX_VERSION                    (1)
+
+/*Size of every integer of the indexed information in bytes*/
+#define FLOUKA_INDEX_FIELD_SIZE                 (4)
+
+/*Offsets of the header fields*/
+#define FLOUKA_INDEX_HEADER_MAGIC               (0)
+#define FLOUKA_INDEX_HEADER_VERSION             (4)
+#define FLOUKA_INDEX_HEADER_HEADER_SIZE         (8)
+#define FLOUKA_INDEX_HEADER_TOTAL_SIZE          (12)
+#define FLOUKA_INDEX_HEADER_SCHEMA_GENERATION   (16)
+#define FLOUKA_INDEX_HEADER_STRING_TABLE_OFFSET (56)
+#define FLOUKA_INDEX_HEADER_STRING_TABLE_SIZE   (60)
+#define FLOUKA_INDEX_HEADER_SIZE                (100)
+
+/*Offsets of the tables descriptors in the header, and of the fields of every descriptor*/
+#define FLOUKA_INDEX_TABLE_GROUPS               (20)
+#define FLOUKA_INDEX_TABLE_SUB_GROUPS           (32)
+#define FLOUKA_INDEX_TABLE_COUNTERS             (44)
+#define FLOUKA_INDEX_TABLE_FAMILIES             (64)
+#define FLOUKA_INDEX_TABLE_MEMBERS              (76)
+#define FLOUKA_INDEX_TABLE_INSTANCES            (88)
+#define FLOUKA_INDEX_TABLE_COUNT                (0)
+#define FLOUKA_INDEX_TABLE_RECORDS_OFFSET       (4)
+#define FLOUKA_INDEX_TABLE_RECORD_SIZE          (8)
+
+/*Offsets of the fields of a group record*/
+#define FLOUKA_INDEX_GROUP_NAME                 (0)
+#define FLOUKA_INDEX_GROUP_DESCRIPTION          (4)
+#define FLOUKA_INDEX_GROUP_RECORD_SIZE          (8)
+
+/*Offsets of the fields of a sub group record*/
+#define FLOUKA_INDEX_SUB_GROUP_GROUP_ID         (0)
+#define FLOUKA_INDEX_SUB_GROUP_NAME             (4)
+#define FLOUKA_INDEX_SUB_GROUP_DESCRIPTION      (8)
+#define FLOUKA_INDEX_SUB_GROUP_RECORD_SIZE      (12)
+
+/*Offsets of the fields of a counter record*/
+#define FLOUKA_INDEX_COUNTER_SUB_GROUP_ID       (0)
+#define FLOUKA_INDEX_COUNTER_UNIT               (4)
+#define FLOUKA_INDEX_COUNTER_NAME               (8)
+#define FLOUKA_INDEX_COUNTER_DESCRIPTION        (12)
+#define FLOUKA_INDEX_COUNTER_RECORD_SIZE        (16)
+
+/*Offsets of the fields of a family record*/
+#define FLOUKA_INDEX_FAMILY_GROUP_ID            (0)
+#define FLOUKA_INDEX_FAMILY_FIRST_COUNTER_ID    (4)
+#define FLOUKA_INDEX_FAMILY_MEMBERS_COUNT       (8)
+#define FLOUKA_INDEX_FAMILY_INSTANCES_COUNT     (12)
+#define FLOUKA_INDEX_FAMILY_FIRST_MEMBER        (16)
+#define FLOUKA_INDEX_FAMILY_FIRST_INSTANCE      (20)
+#define FLOUKA_INDEX_FAMILY_NAME                (24)
+#define FLOUKA_INDEX_FAMILY_DESCRIPTION         (28)
+#define FLOUKA_INDEX_FAMILY_RECORD_SIZE         (32)
+
+/*Offsets of the fields of a member record*/
+#define FLOUKA_INDEX_MEMBER_FAMILY_ID           (0)
+#define FLOUKA_INDEX_MEMBER_UNIT                (4)
+#define FLOUKA_INDEX_MEMBER_NAME                (8)
+#define FLOUKA_INDEX_MEMBER_DESCRIPTION         (12)
+#define FLOUKA_INDEX_MEMBER_RECORD_SIZE         (16)
+
+/*Offsets of the fields of an instance record*/
+#define FLOUKA_INDEX_INSTANCE_FAMILY_ID         (0)
+#define FLOUKA_INDEX_INSTANCE_FIRST_COUNTER_ID  (4)
+#define FLOUKA_INDEX_INSTANCE_LABEL             (8)
+#define FLOUKA_INDEX_INSTANCE_RECORD_SIZE       (12)
+
+/***************************************************************************************************
+ *  Name        : flouka_indexGetUint32
+ *
+ *  Arguments   : const uint8*    index_Ptr,
+ *                uint32          offset
+ *
+ *  Description : This function returns the little-endian integer at the given offset.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+STATIC INLINE uint32 flouka_indexGetUint32(const uint8* index_Ptr,
+                                           uint32 offset)
+{
+    return ((uint32) index_Ptr[offset]
+                    | ((uint32) index_Ptr[offset + 1] << 8)
+                    | ((uint32) index_Ptr[offset + 2] << 16)
+                    | ((uint32) index_Ptr[offset + 3] << 24));
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_indexGetCount
+ *
+ *  Arguments   : const uint8*    index_Ptr,
+ *                uint32          table
+ *
+ *  Description : This function returns the number of records of the given table
+ *                (FLOUKA_INDEX_TABLE_GROUPS, FLOUKA_INDEX_TABLE_SUB_GROUPS,
+ *                FLOUKA_INDEX_TABLE_COUNTERS, FLOUKA_INDEX_TABLE_FAMILIES,
+ *                FLOUKA_INDEX_TABLE_MEMBERS or FLOUKA_INDEX_TABLE_INSTANCES).
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+STATIC INLINE uint32 flouka_indexGetCount(const uint8* index_Ptr,
+                                          uint32 table)
+{
+    return (flouka_indexGetUint32(index_Ptr, table + FLOUKA_INDEX_TABLE_COUNT));
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_indexGetField
+ *
+ *  Arguments   : const uint8*    index_Ptr,
+ *                uint32          table,
+ *                uint32          ID,
+ *                uint32          field
+ *
+ *  Description : This function returns the given field (ex. FLOUKA_INDEX_COUNTER_SUB_GROUP_ID) of
+ *                the record of the given ID in the given table, the ID must be less than the count
+ *                of the table.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+STATIC INLINE uint32 flouka_indexGetField(const uint8* index_Ptr,
+                                          uint32 table,
+                                          uint32 ID,
+                                          uint32 field)
+{
+    return (flouka_indexGetUint32(index_Ptr,
+                                  flouka_indexGetUint32(index_Ptr, table + FLOUKA_INDEX_TABLE_RECORDS_OFFSET)
+                                  + (ID * flouka_indexGetUint32(index_Ptr, table + FLOUKA_INDEX_TABLE_RECORD_SIZE))
+                                  + field));
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_indexGetString
+ *
+ *  Arguments   : const uint8*    index_Ptr,
+ *                uint32          table,
+ *                uint32          ID,
+ *                uint32          field
+ *
+ *  Description : This function returns the string of the given string field (ex.
+ *                FLOUKA_INDEX_COUNTER_NAME) of the record of the given ID in the given table, the
+ *                string points inside the buffer.
+ *
+ *  Returns     : const char*
+ **************************************************************************************************/
+STATIC INLINE const char* flouka_indexGetString(const uint8* index_Ptr,
+                                                uint32 table,
+                                                uint32 ID,
+                                                uint32 field)
+{
+    return ((const char*) &(index_Ptr[flouka_indexGetUint32(index_Ptr, FLOUKA_INDEX_HEADER_STRING_TABLE_OFFSET)
+                                      + flouka_indexGetField(index_Ptr, table, ID, field)]));
+}
+
+#endif /* FLOUKA_INDEX_H_ */
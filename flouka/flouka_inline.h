@@ -0,0 +1,246 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_INLINE_H_
+#define FLOUKA_INLINE_H_
+
+/***************************************************************************************************
+ *
+ * This header is optional, it allows the release build of the application to update the counters
+ * without a function call, it is used by flouka_wrapper.h when FLOUKA_INLINE_FAST_PATH is defined
+ * and DEBUG is not defined (the DEBUG build always calls the library to get the assertions).
+ *
+ * The inline functions only do a plain update of the list of counters, whenever the object is
+ * initialized with an option that needs more than that (ex. sharding, or atomic updates), they call
+ * the library function instead.
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_fastPath_s
+ *
+ * Structure Description:
+ * This structure is the first member of the statistics collector object, it is the only part of
+ * the object that is visible to the user of the library, and it must not be changed by the user.
+ **************************************************************************************************/
+typedef struct flouka_fastPath
+{
+    /*Points to the list of counters*/
+    uint32* counterValuesList_Ptr;
+    /*Non-zero when the counters cannot be updated with a plain read-modify-write*/
+    uint32 slowPathFlags;
+} flouka_fastPath_s;
+
+#ifndef DEBUG
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineIncrementCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID
+ *
+ *  Description : This function is the inline version of flouka_incrementCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineIncrementCounter(flouka_s* flouka_Ptr,
+                                                 uint32 counterID)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID]++;
+    }
+    else
+    {
+        flouka_incrementCounter(flouka_Ptr, counterID);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineDecrementCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID
+ *
+ *  Description : This function is the inline version of flouka_decrementCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineDecrementCounter(flouka_s* flouka_Ptr,
+                                                 uint32 counterID)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID]--;
+    }
+    else
+    {
+        flouka_decrementCounter(flouka_Ptr, counterID);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineIncreaseCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID,
+ *                uint32      delta
+ *
+ *  Description : This function is the inline version of flouka_increaseCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineIncreaseCounter(flouka_s* flouka_Ptr,
+                                                uint32 counterID,
+                                                uint32 delta)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID] += delta;
+    }
+    else
+    {
+        flouka_increaseCounter(flouka_Ptr, counterID, delta);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineDecreaseCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID,
+ *                uint32      delta
+ *
+ *  Description : This function is the inline version of flouka_decreaseCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineDecreaseCounter(flouka_s* flouka_Ptr,
+                                                uint32 counterID,
+                                                uint32 delta)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID] -= delta;
+    }
+    else
+    {
+        flouka_decreaseCounter(flouka_Ptr, counterID, delta);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineSetCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID,
+ *                uint32      value
+ *
+ *  Description : This function is the inline version of flouka_setCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineSetCounter(flouka_s* flouka_Ptr,
+                                           uint32 counterID,
+                                           uint32 value)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID] = value;
+    }
+    else
+    {
+        flouka_setCounter(flouka_Ptr, counterID, value);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineResetCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID
+ *
+ *  Description : This function is the inline version of flouka_resetCounter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+STATIC INLINE void flouka_inlineResetCounter(flouka_s* flouka_Ptr,
+                                             uint32 counterID)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        fastPath_Ptr->counterValuesList_Ptr[counterID] = 0;
+    }
+    else
+    {
+        flouka_resetCounter(flouka_Ptr, counterID);
+    }
+}
+
+/***************************************************************************************************
+ *  Name        : flouka_inlineGetCounter
+ *
+ *  Arguments   : flouka_s*    flouka_Ptr,
+ *                uint32      counterID
+ *
+ *  Description : This function is the inline version of flouka_getCounter.
+ *
+ *  Returns     : uint32
+ **************************************************************************************************/
+STATIC INLINE uint32 flouka_inlineGetCounter(flouka_s* flouka_Ptr,
+                                             uint32 counterID)
+{
+    flouka_fastPath_s* fastPath_Ptr = (flouka_fastPath_s*) flouka_Ptr;
+
+    if(0 == fastPath_Ptr->slowPathFlags)
+    {
+        return (fastPath_Ptr->counterValuesList_Ptr[counterID]);
+    }
+    return (flouka_getCounter(flouka_Ptr, counterID));
+}
+
+#endif /*DEBUG*/
+
+#endif /* FLOUKA_INLINE_H_ */
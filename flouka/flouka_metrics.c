@@ -0,0 +1,773 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ *
+ *                                       I N C L U D E S
+ *
+ **************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flouka.h"
+#include "flouka_index.h"
+#include "flouka_metrics.h"
+
+/***************************************************************************************************
+ *
+ *                                         M A C R O S
+ *
+ **************************************************************************************************/
+
+/*This macro is used to verify that the metrics exporter is initialized properly.*/
+#define FLOUKA_METRICS_INITIALIZATION_PATTEREN  (0x65876587)
+
+/*Prefix of the name of every metric*/
+#define FLOUKA_METRICS_NAME_PREFIX              "flouka_"
+
+/*Last line of the text*/
+#define FLOUKA_METRICS_END                      "# EOF\n"
+
+/***************************************************************************************************
+ *
+ *                                          T Y P E S
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_MetricsWriter_s
+ *
+ * Structure Description:
+ * This structure appends to the text being rendered, or only counts its size if there is no text
+ * yet (the text is rendered twice, once to get its size, and once to fill it).
+ **************************************************************************************************/
+typedef struct flouka_MetricsWriter
+{
+    /*Points to the text, NULL if only the size is counted*/
+    uint8* text_Ptr;
+    /*Holds the size of the text written so far*/
+    uint32 size;
+} flouka_MetricsWriter_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_MetricsSample_s
+ *
+ * Structure Description:
+ * This structure holds the metric name of one counter, the counters are sorted by it so that the
+ * samples of every metric are rendered together.
+ **************************************************************************************************/
+typedef struct flouka_MetricsSample
+{
+    /*Points to the metric name of the counter*/
+    const char* name_Ptr;
+    /*Holds the ID of the counter*/
+    uint32 counterID;
+    /*Holds the index record of the family member of the counter, FLOUKA_UNASSIGNED_ID if the
+      counter is not reserved by a family*/
+    uint32 memberRecord;
+    /*Holds the index record of the family instance of the counter*/
+    uint32 instanceRecord;
+} flouka_MetricsSample_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_metricsExporter_s
+ *
+ * Structure Description:
+ * This structure represents the metrics exporter class type.
+ **************************************************************************************************/
+struct flouka_metricsExporter
+{
+    /*Points to the statistics collector object the snapshots are taken from*/
+    flouka_s* flouka_Ptr;
+    /*Points to the function that will be used to allocate the text*/
+    AllocFuncPtr allocationFunction_Ptr;
+    /*Points to the function that will be used to release the allocated memory*/
+    DeallocFuncPtr deallocationFunction_Ptr;
+    /*Points to the rendered text, NULL until it is rendered the first time*/
+    uint8* text_Ptr;
+    /*Holds the size of the rendered text*/
+    uint32 textSize;
+    /*Holds the schema generation the text is rendered from*/
+    uint32 schemaGeneration;
+    /*Holds the offset of the value slot of every counter in the text (indexed by the counter ID),
+      zero if the counter is not assigned (it is not rendered)*/
+    uint32* valueOffsetList_Ptr;
+    /*Holds the snapshot of the values*/
+    uint32* valuesList_Ptr;
+    /*Holds the number of counters, the lists are allocated again if the object grows*/
+    uint32 countersCount;
+    /*Holds the number of the rendered (assigned) counters*/
+    uint32 samplesCount;
+#ifdef DEBUG
+    uint32 initializationPattern;
+#endif /**/
+};
+
+/***************************************************************************************************
+ *
+ *                                      V A R I A B L E S
+ *
+ **************************************************************************************************/
+
+/*The two digits of every number below 100, used to convert the values two digits at a time*/
+STATIC const char g_flouka_metricsDigitPairs[] =
+                "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+
+/***************************************************************************************************
+ *
+ *                      I N T E R N A L   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+STATIC INLINE uint8* Metrics_formatNumber(uint8* end_Ptr,
+                                          uint32 value)
+{
+    uint32 pairIndex;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Write the decimal digits of the value backwards from the given end, two digits at a time.
+     * 2. Return the first digit written.
+     */
+    while(value >= 100)
+    {
+        pairIndex = (value % 100) * 2;
+        value /= 100;
+        end_Ptr -= 2;
+        end_Ptr[0] = (uint8) g_flouka_metricsDigitPairs[pairIndex];
+        end_Ptr[1] = (uint8) g_flouka_metricsDigitPairs[pairIndex + 1];
+    }
+    if(value >= 10)
+    {
+        end_Ptr -= 2;
+        end_Ptr[0] = (uint8) g_flouka_metricsDigitPairs[value * 2];
+        end_Ptr[1] = (uint8) g_flouka_metricsDigitPairs[(value * 2) + 1];
+    }
+    else
+    {
+        end_Ptr--;
+        end_Ptr[0] = (uint8) ('0' + value);
+    }
+
+    return (end_Ptr);
+}
+
+STATIC INLINE void MetricsWriter_putText(flouka_MetricsWriter_s* writer_Ptr,
+                                         const void* text_Ptr,
+                                         uint32 textSize)
+{
+    if(NULL != writer_Ptr->text_Ptr)
+    {
+        memcpy(writer_Ptr->text_Ptr + writer_Ptr->size, text_Ptr, textSize);
+    }
+    writer_Ptr->size += textSize;
+}
+
+STATIC INLINE void MetricsWriter_putString(flouka_MetricsWriter_s* writer_Ptr,
+                                           const char* string_Ptr)
+{
+    MetricsWriter_putText(writer_Ptr, string_Ptr, strlen(string_Ptr));
+}
+
+STATIC void MetricsWriter_putEscaped(flouka_MetricsWriter_s* writer_Ptr,
+                                     const char* string_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Write the string, escaping the backslashes, the double quotes and the new lines (the
+     *    escaping of the label values and the help text).
+     */
+    for(; '\0' != *string_Ptr; string_Ptr++)
+    {
+        switch(*string_Ptr)
+        {
+            case '\\':
+                MetricsWriter_putText(writer_Ptr, "\\\\", 2);
+                break;
+            case '"':
+                MetricsWriter_putText(writer_Ptr, "\\\"", 2);
+                break;
+            case '\n':
+                MetricsWriter_putText(writer_Ptr, "\\n", 2);
+                break;
+            default:
+                MetricsWriter_putText(writer_Ptr, string_Ptr, 1);
+                break;
+        }
+    }
+}
+
+STATIC void MetricsWriter_putName(flouka_MetricsWriter_s* writer_Ptr,
+                                  const char* counterName_Ptr)
+{
+    char character;
+    bool isSeparatorPending;
+    bool isEmpty;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Write the prefix, and then the letters (in lower case) and the digits of the counter name,
+     *    with one underscore for every run of other characters between them (the runs at the start
+     *    and at the end are dropped), so that the name is a valid metric name.
+     */
+    MetricsWriter_putString(writer_Ptr, FLOUKA_METRICS_NAME_PREFIX);
+    isSeparatorPending = FALSE;
+    isEmpty = TRUE;
+    for(; '\0' != *counterName_Ptr; counterName_Ptr++)
+    {
+        character = *counterName_Ptr;
+        if((character >= 'A') && (character <= 'Z'))
+        {
+            character = (char) (character - 'A' + 'a');
+        }
+        if(((character < 'a') || (character > 'z')) && ((character < '0') || (character > '9')))
+        {
+            isSeparatorPending = TRUE;
+            continue;
+        }
+        if((TRUE == isSeparatorPending) && (FALSE == isEmpty))
+        {
+            MetricsWriter_putText(writer_Ptr, "_", 1);
+        }
+        MetricsWriter_putText(writer_Ptr, &character, 1);
+        isSeparatorPending = FALSE;
+        isEmpty = FALSE;
+    }
+}
+
+STATIC int Metrics_compareSamples(const void* first_Ptr,
+                                  const void* second_Ptr)
+{
+    int comparison;
+    const flouka_MetricsSample_s* firstSample_Ptr;
+    const flouka_MetricsSample_s* secondSample_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Order the samples by their metric names, and then by their counter IDs.
+     */
+    firstSample_Ptr = (const flouka_MetricsSample_s*) first_Ptr;
+    secondSample_Ptr = (const flouka_MetricsSample_s*) second_Ptr;
+    comparison = strcmp(firstSample_Ptr->name_Ptr, secondSample_Ptr->name_Ptr);
+    if(0 != comparison)
+    {
+        return (comparison);
+    }
+    return ((firstSample_Ptr->counterID < secondSample_Ptr->counterID) ? -1 : 1);
+}
+
+STATIC uint32 MetricsExporter_collectSamples(const uint8* index_Ptr,
+                                             uint32 countersCount,
+                                             flouka_MetricsSample_s* sampleList_Ptr,
+                                             flouka_MetricsWriter_s* writer_Ptr)
+{
+    uint32 i;
+    uint32 j;
+    uint32 samplesCount;
+    uint32 familyID;
+    uint32 membersCount;
+    uint32 memberRecord;
+    uint32 firstCounterID;
+    const char* memberName_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Add a sample for every assigned counter, with its metric name, the unassigned counters
+     *    are not rendered.
+     * 2. Add a sample for every described member of every added family instance, with the metric
+     *    name of the member (the instances of a family share the metric names of its members).
+     * 3. Only count the samples and the size of their names if there is no list of samples yet.
+     * 4. Return the number of samples.
+     */
+    samplesCount = 0;
+    for(i = 0; i < countersCount; i++)
+    {
+        if(FLOUKA_UNASSIGNED_ID == flouka_indexGetField(index_Ptr,
+                                                        FLOUKA_INDEX_TABLE_COUNTERS,
+                                                        i,
+                                                        FLOUKA_INDEX_COUNTER_SUB_GROUP_ID))
+        {
+            continue;
+        }
+        if(NULL != sampleList_Ptr)
+        {
+            sampleList_Ptr[samplesCount].name_Ptr = (const char*) (writer_Ptr->text_Ptr + writer_Ptr->size);
+            sampleList_Ptr[samplesCount].counterID = i;
+            sampleList_Ptr[samplesCount].memberRecord = FLOUKA_UNASSIGNED_ID;
+            sampleList_Ptr[samplesCount].instanceRecord = FLOUKA_UNASSIGNED_ID;
+        }
+        samplesCount++;
+        MetricsWriter_putName(writer_Ptr,
+                              flouka_indexGetString(index_Ptr,
+                                                    FLOUKA_INDEX_TABLE_COUNTERS,
+                                                    i,
+                                                    FLOUKA_INDEX_COUNTER_NAME));
+        MetricsWriter_putText(writer_Ptr, "", 1);
+    }
+
+    for(i = 0; i < flouka_indexGetCount(index_Ptr, FLOUKA_INDEX_TABLE_INSTANCES); i++)
+    {
+        if('\0' == flouka_indexGetString(index_Ptr,
+                                         FLOUKA_INDEX_TABLE_INSTANCES,
+                                         i,
+                                         FLOUKA_INDEX_INSTANCE_LABEL)[0])
+        {
+            continue;
+        }
+        familyID = flouka_indexGetField(index_Ptr,
+                                        FLOUKA_INDEX_TABLE_INSTANCES,
+                                        i,
+                                        FLOUKA_INDEX_INSTANCE_FAMILY_ID);
+        firstCounterID = flouka_indexGetField(index_Ptr,
+                                              FLOUKA_INDEX_TABLE_INSTANCES,
+                                              i,
+                                              FLOUKA_INDEX_INSTANCE_FIRST_COUNTER_ID);
+        membersCount = flouka_indexGetField(index_Ptr,
+                                            FLOUKA_INDEX_TABLE_FAMILIES,
+                                            familyID,
+                                            FLOUKA_INDEX_FAMILY_MEMBERS_COUNT);
+        memberRecord = flouka_indexGetField(index_Ptr,
+                                            FLOUKA_INDEX_TABLE_FAMILIES,
+                                            familyID,
+                                            FLOUKA_INDEX_FAMILY_FIRST_MEMBER);
+        for(j = 0; j < membersCount; j++)
+        {
+            memberName_Ptr = flouka_indexGetString(index_Ptr,
+                                                   FLOUKA_INDEX_TABLE_MEMBERS,
+                                                   memberRecord + j,
+                                                   FLOUKA_INDEX_MEMBER_NAME);
+            if('\0' == memberName_Ptr[0])
+            {
+                continue;
+            }
+            if(NULL != sampleList_Ptr)
+            {
+                sampleList_Ptr[samplesCount].name_Ptr = (const char*) (writer_Ptr->text_Ptr + writer_Ptr->size);
+                sampleList_Ptr[samplesCount].counterID = firstCounterID + j;
+                sampleList_Ptr[samplesCount].memberRecord = memberRecord + j;
+                sampleList_Ptr[samplesCount].instanceRecord = i;
+            }
+            samplesCount++;
+            MetricsWriter_putName(writer_Ptr, memberName_Ptr);
+            MetricsWriter_putText(writer_Ptr, "", 1);
+        }
+    }
+
+    return (samplesCount);
+}
+
+STATIC void MetricsExporter_writeText(flouka_metricsExporter_s* metricsExporter_Ptr,
+                                      const uint8* index_Ptr,
+                                      const flouka_MetricsSample_s* sampleList_Ptr,
+                                      flouka_MetricsWriter_s* writer_Ptr)
+{
+    uint32 i;
+    uint32 counterID;
+    uint32 subgroupID = 0;
+    uint32 familyID = 0;
+    uint32 groupID;
+    uint32 memberRecord;
+    const char* description_Ptr;
+    const char* unit_Ptr;
+    uint8 number[FLOUKA_METRICS_VALUE_DIGITS];
+    uint8* numberEnd_Ptr;
+    uint8* digits_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Write the type and the help of every metric before its first sample.
+     * 2. Write every sample with its labels, and a value slot filled with zeros, and remember the
+     *    offset of the slot (only when the text is filled), the sample of a family member is
+     *    labeled by the family and the instance instead of the sub group, and it is described by
+     *    the member.
+     * 3. Write the end of the text.
+     */
+    for(i = 0; i < metricsExporter_Ptr->samplesCount; i++)
+    {
+        counterID = sampleList_Ptr[i].counterID;
+        memberRecord = sampleList_Ptr[i].memberRecord;
+        if(FLOUKA_UNASSIGNED_ID == memberRecord)
+        {
+            subgroupID = flouka_indexGetField(index_Ptr,
+                                              FLOUKA_INDEX_TABLE_COUNTERS,
+                                              counterID,
+                                              FLOUKA_INDEX_COUNTER_SUB_GROUP_ID);
+            groupID = flouka_indexGetField(index_Ptr,
+                                           FLOUKA_INDEX_TABLE_SUB_GROUPS,
+                                           subgroupID,
+                                           FLOUKA_INDEX_SUB_GROUP_GROUP_ID);
+            description_Ptr = flouka_indexGetString(index_Ptr,
+                                                    FLOUKA_INDEX_TABLE_COUNTERS,
+                                                    counterID,
+                                                    FLOUKA_INDEX_COUNTER_DESCRIPTION);
+            unit_Ptr = flouka_indexGetString(index_Ptr,
+                                             FLOUKA_INDEX_TABLE_COUNTERS,
+                                             counterID,
+                                             FLOUKA_INDEX_COUNTER_UNIT);
+        }
+        else
+        {
+            familyID = flouka_indexGetField(index_Ptr,
+                                            FLOUKA_INDEX_TABLE_MEMBERS,
+                                            memberRecord,
+                                            FLOUKA_INDEX_MEMBER_FAMILY_ID);
+            groupID = flouka_indexGetField(index_Ptr,
+                                           FLOUKA_INDEX_TABLE_FAMILIES,
+                                           familyID,
+                                           FLOUKA_INDEX_FAMILY_GROUP_ID);
+            description_Ptr = flouka_indexGetString(index_Ptr,
+                                                    FLOUKA_INDEX_TABLE_MEMBERS,
+                                                    memberRecord,
+                                                    FLOUKA_INDEX_MEMBER_DESCRIPTION);
+            unit_Ptr = flouka_indexGetString(index_Ptr,
+                                             FLOUKA_INDEX_TABLE_MEMBERS,
+                                             memberRecord,
+                                             FLOUKA_INDEX_MEMBER_UNIT);
+        }
+
+        if((0 == i) || (0 != strcmp(sampleList_Ptr[i].name_Ptr, sampleList_Ptr[i - 1].name_Ptr)))
+        {
+            MetricsWriter_putString(writer_Ptr, "# TYPE ");
+            MetricsWriter_putString(writer_Ptr, sampleList_Ptr[i].name_Ptr);
+            MetricsWriter_putString(writer_Ptr, " gauge\n# HELP ");
+            MetricsWriter_putString(writer_Ptr, sampleList_Ptr[i].name_Ptr);
+            MetricsWriter_putString(writer_Ptr, " ");
+            MetricsWriter_putEscaped(writer_Ptr, description_Ptr);
+            MetricsWriter_putString(writer_Ptr, "\n");
+        }
+
+        MetricsWriter_putString(writer_Ptr, sampleList_Ptr[i].name_Ptr);
+        MetricsWriter_putString(writer_Ptr, "{group=\"");
+        MetricsWriter_putEscaped(writer_Ptr,
+                                 flouka_indexGetString(index_Ptr,
+                                                       FLOUKA_INDEX_TABLE_GROUPS,
+                                                       groupID,
+                                                       FLOUKA_INDEX_GROUP_NAME));
+        if(FLOUKA_UNASSIGNED_ID == memberRecord)
+        {
+            MetricsWriter_putString(writer_Ptr, "\",sub_group=\"");
+            MetricsWriter_putEscaped(writer_Ptr,
+                                     flouka_indexGetString(index_Ptr,
+                                                           FLOUKA_INDEX_TABLE_SUB_GROUPS,
+                                                           subgroupID,
+                                                           FLOUKA_INDEX_SUB_GROUP_NAME));
+        }
+        else
+        {
+            MetricsWriter_putString(writer_Ptr, "\",family=\"");
+            MetricsWriter_putEscaped(writer_Ptr,
+                                     flouka_indexGetString(index_Ptr,
+                                                           FLOUKA_INDEX_TABLE_FAMILIES,
+                                                           familyID,
+                                                           FLOUKA_INDEX_FAMILY_NAME));
+            MetricsWriter_putString(writer_Ptr, "\",instance=\"");
+            MetricsWriter_putEscaped(writer_Ptr,
+                                     flouka_indexGetString(index_Ptr,
+                                                           FLOUKA_INDEX_TABLE_INSTANCES,
+                                                           sampleList_Ptr[i].instanceRecord,
+                                                           FLOUKA_INDEX_INSTANCE_LABEL));
+        }
+        MetricsWriter_putString(writer_Ptr, "\",unit=\"");
+        MetricsWriter_putEscaped(writer_Ptr, unit_Ptr);
+        MetricsWriter_putString(writer_Ptr, "\",counter_id=\"");
+        numberEnd_Ptr = number + sizeof(number);
+        digits_Ptr = Metrics_formatNumber(numberEnd_Ptr, counterID);
+        MetricsWriter_putText(writer_Ptr, digits_Ptr, (uint32) (numberEnd_Ptr - digits_Ptr));
+        MetricsWriter_putString(writer_Ptr, "\"} ");
+
+        if(NULL != writer_Ptr->text_Ptr)
+        {
+            metricsExporter_Ptr->valueOffsetList_Ptr[counterID] = writer_Ptr->size;
+        }
+        memset(number, '0', sizeof(number));
+        MetricsWriter_putText(writer_Ptr, number, sizeof(number));
+        MetricsWriter_putString(writer_Ptr, "\n");
+    }
+    MetricsWriter_putString(writer_Ptr, FLOUKA_METRICS_END);
+}
+
+STATIC void MetricsExporter_render(flouka_metricsExporter_s* metricsExporter_Ptr)
+{
+    uint32 indexSize;
+    uint32 countersCount;
+    uint8* index_Ptr;
+    char* names_Ptr;
+    flouka_MetricsWriter_s writer;
+    flouka_MetricsSample_s* sampleList_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Get the indexed information, and remember its schema generation.
+     * 2. Allocate the lists of the value slots and the values again if the object grew.
+     * 3. Make the metric name of every sample (counting them and the size of their names first),
+     *    and sort the samples by their metric names.
+     * 4. Write the text (counting its size first) in place of the previous one.
+     * 5. Release the names and the sorted counters.
+     */
+    flouka_getIndexedInformation(metricsExporter_Ptr->flouka_Ptr,
+                                 &index_Ptr,
+                                 &indexSize COMMA()
+                                 FILE_AND_LINE_FOR_REF());
+    metricsExporter_Ptr->schemaGeneration
+                    = flouka_indexGetUint32(index_Ptr, FLOUKA_INDEX_HEADER_SCHEMA_GENERATION);
+
+    countersCount = flouka_indexGetCount(index_Ptr, FLOUKA_INDEX_TABLE_COUNTERS);
+    if(countersCount > metricsExporter_Ptr->countersCount)
+    {
+        metricsExporter_Ptr->deallocationFunction_Ptr(metricsExporter_Ptr->valueOffsetList_Ptr);
+        metricsExporter_Ptr->deallocationFunction_Ptr(metricsExporter_Ptr->valuesList_Ptr);
+        metricsExporter_Ptr->valueOffsetList_Ptr
+                        = (uint32*) metricsExporter_Ptr->allocationFunction_Ptr(countersCount
+                                        * sizeof(*metricsExporter_Ptr->valueOffsetList_Ptr));
+        metricsExporter_Ptr->valuesList_Ptr
+                        = (uint32*) metricsExporter_Ptr->allocationFunction_Ptr(countersCount
+                                        * sizeof(*metricsExporter_Ptr->valuesList_Ptr));
+        metricsExporter_Ptr->countersCount = countersCount;
+    }
+    memset(metricsExporter_Ptr->valueOffsetList_Ptr,
+           0,
+           metricsExporter_Ptr->countersCount * sizeof(*metricsExporter_Ptr->valueOffsetList_Ptr));
+
+    writer.text_Ptr = NULL;
+    writer.size = 0;
+    metricsExporter_Ptr->samplesCount = MetricsExporter_collectSamples(index_Ptr,
+                                                                       countersCount,
+                                                                       NULL,
+                                                                       &writer);
+    names_Ptr = (char*) metricsExporter_Ptr->allocationFunction_Ptr(writer.size);
+    sampleList_Ptr = (flouka_MetricsSample_s*) metricsExporter_Ptr->allocationFunction_Ptr(
+                    metricsExporter_Ptr->samplesCount * sizeof(*sampleList_Ptr));
+    writer.text_Ptr = (uint8*) names_Ptr;
+    writer.size = 0;
+    MetricsExporter_collectSamples(index_Ptr, countersCount, sampleList_Ptr, &writer);
+    qsort(sampleList_Ptr,
+          metricsExporter_Ptr->samplesCount,
+          sizeof(*sampleList_Ptr),
+          Metrics_compareSamples);
+
+    writer.text_Ptr = NULL;
+    writer.size = 0;
+    MetricsExporter_writeText(metricsExporter_Ptr, index_Ptr, sampleList_Ptr, &writer);
+    if(NULL != metricsExporter_Ptr->text_Ptr)
+    {
+        metricsExporter_Ptr->deallocationFunction_Ptr(metricsExporter_Ptr->text_Ptr);
+    }
+    metricsExporter_Ptr->text_Ptr = (uint8*) metricsExporter_Ptr->allocationFunction_Ptr(writer.size);
+    metricsExporter_Ptr->textSize = writer.size;
+    writer.text_Ptr = metricsExporter_Ptr->text_Ptr;
+    writer.size = 0;
+    MetricsExporter_writeText(metricsExporter_Ptr, index_Ptr, sampleList_Ptr, &writer);
+
+    metricsExporter_Ptr->deallocationFunction_Ptr(sampleList_Ptr);
+    metricsExporter_Ptr->deallocationFunction_Ptr(names_Ptr);
+}
+
+/***************************************************************************************************
+ *
+ *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+flouka_status_e flouka_metricsExporterInit(flouka_metricsExporter_s** metricsExporter_Pointer_Ptr,
+                                           flouka_s* flouka_Ptr,
+                                           AllocFuncPtr allocationFunction_Ptr,
+                                           DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                           FILE_AND_LINE_FOR_TYPE())
+{
+    flouka_metricsExporter_s* metricsExporter_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the metricsExporter_Ptr (Must be NULL).
+     * 2. Validate the flouka_Ptr (not NULL).
+     * 3. Validate the allocation function pointer (not NULL).
+     * 4. Validate the deallocation function pointer (not NULL).
+     */
+    ASSERT((NULL == *metricsExporter_Pointer_Ptr),
+                    "FLOUKA:  *metricsExporter_Ptr pointer is not NULL, it is expected to initialize a NULL pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != allocationFunction_Ptr),
+                    "FLOUKA:  allocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != deallocationFunction_Ptr),
+                    "FLOUKA:  deallocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Allocate the metrics exporter object, the list of the value slots, and the snapshot of
+     *    the values, the text itself is allocated when it is rendered.
+     */
+    metricsExporter_Ptr = (flouka_metricsExporter_s*) allocationFunction_Ptr(sizeof(*metricsExporter_Ptr));
+    metricsExporter_Ptr->flouka_Ptr = flouka_Ptr;
+    metricsExporter_Ptr->allocationFunction_Ptr = allocationFunction_Ptr;
+    metricsExporter_Ptr->deallocationFunction_Ptr = deallocationFunction_Ptr;
+    metricsExporter_Ptr->text_Ptr = NULL;
+    metricsExporter_Ptr->textSize = 0;
+    metricsExporter_Ptr->schemaGeneration = 0;
+    metricsExporter_Ptr->samplesCount = 0;
+    metricsExporter_Ptr->countersCount
+                    = flouka_getStatisticsSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_CALL())
+                                    / sizeof(*metricsExporter_Ptr->valuesList_Ptr);
+    metricsExporter_Ptr->valueOffsetList_Ptr
+                    = (uint32*) allocationFunction_Ptr(metricsExporter_Ptr->countersCount
+                                    * sizeof(*metricsExporter_Ptr->valueOffsetList_Ptr));
+    metricsExporter_Ptr->valuesList_Ptr
+                    = (uint32*) allocationFunction_Ptr(metricsExporter_Ptr->countersCount
+                                    * sizeof(*metricsExporter_Ptr->valuesList_Ptr));
+#ifdef DEBUG
+    metricsExporter_Ptr->initializationPattern = FLOUKA_METRICS_INITIALIZATION_PATTEREN;
+#endif /*DEBUG*/
+
+    *metricsExporter_Pointer_Ptr = metricsExporter_Ptr;
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+void flouka_metricsExporterDestroy(flouka_metricsExporter_s* metricsExporter_Ptr COMMA()
+                                   FILE_AND_LINE_FOR_TYPE())
+{
+    DeallocFuncPtr deallocationFunctionPointer;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the metricsExporter_Ptr (not NULL).
+     * 2. Validate the metricsExporter_Ptr (already initialized).
+     */
+    ASSERT((NULL != metricsExporter_Ptr),
+                    "FLOUKA:  Invalid metrics exporter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_METRICS_INITIALIZATION_PATTEREN == metricsExporter_Ptr->initializationPattern),
+                    "FLOUKA:  Invalid metrics exporter pointer passed (either not initialized pointer, or incorrect, non-null pointer)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Deallocate the text (if rendered), the list of the value slots, the snapshot of the
+     *    values, and the metrics exporter itself.
+     */
+    deallocationFunctionPointer = metricsExporter_Ptr->deallocationFunction_Ptr;
+    if(NULL != metricsExporter_Ptr->text_Ptr)
+    {
+        deallocationFunctionPointer(metricsExporter_Ptr->text_Ptr);
+    }
+    deallocationFunctionPointer(metricsExporter_Ptr->valueOffsetList_Ptr);
+    deallocationFunctionPointer(metricsExporter_Ptr->valuesList_Ptr);
+    deallocationFunctionPointer((void*) metricsExporter_Ptr);
+}
+
+void flouka_metricsExporterRender(flouka_metricsExporter_s* metricsExporter_Ptr,
+                                  uint8** textBufferPointer_Ptr,
+                                  uint32* textBufferSize_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    uint32 schemaGeneration;
+    uint8* slot_Ptr;
+    uint8* digits_Ptr;
+    flouka_snapshotInfo_s snapshotInfo;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the metricsExporter_Ptr (not NULL).
+     * 2. Validate the output pointers (not NULL).
+     */
+    ASSERT((NULL != metricsExporter_Ptr),
+                    "FLOUKA:  Invalid metrics exporter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != textBufferPointer_Ptr) && (NULL != textBufferSize_Ptr),
+                    "FLOUKA:  NULL was passed as the text buffer pointer or size",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Render the text if it was never rendered, or the schema changed since it was rendered.
+     * 2. Take a snapshot of the statistics.
+     * 3. Write the digits of every rendered value at the end of its slot, and fill the rest of the
+     *    slot with zeros (the text around the slots is never changed).
+     * 4. Return the text and its size.
+     */
+    schemaGeneration = flouka_getSchemaGeneration(metricsExporter_Ptr->flouka_Ptr COMMA()
+                                                  FILE_AND_LINE_FOR_CALL());
+    if((NULL == metricsExporter_Ptr->text_Ptr) || (metricsExporter_Ptr->schemaGeneration != schemaGeneration))
+    {
+        MetricsExporter_render(metricsExporter_Ptr);
+    }
+
+    flouka_copySnapshot(metricsExporter_Ptr->flouka_Ptr,
+                        (uint8*) metricsExporter_Ptr->valuesList_Ptr,
+                        metricsExporter_Ptr->countersCount * sizeof(uint32),
+                        &snapshotInfo COMMA()
+                        FILE_AND_LINE_FOR_CALL());
+
+    for(i = 0; i < metricsExporter_Ptr->countersCount; i++)
+    {
+        if(0 == metricsExporter_Ptr->valueOffsetList_Ptr[i])
+        {
+            continue;
+        }
+        slot_Ptr = metricsExporter_Ptr->text_Ptr + metricsExporter_Ptr->valueOffsetList_Ptr[i];
+        digits_Ptr = Metrics_formatNumber(slot_Ptr + FLOUKA_METRICS_VALUE_DIGITS,
+                                          metricsExporter_Ptr->valuesList_Ptr[i]);
+        memset(slot_Ptr, '0', (size_t) (digits_Ptr - slot_Ptr));
+    }
+
+    *textBufferPointer_Ptr = metricsExporter_Ptr->text_Ptr;
+    *textBufferSize_Ptr = metricsExporter_Ptr->textSize;
+}
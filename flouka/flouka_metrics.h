@@ -0,0 +1,123 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_METRICS_H_
+#define FLOUKA_METRICS_H_
+
+/***************************************************************************************************
+ *
+ * The metrics exporter renders the counters as OpenMetrics text (the text format scraped by
+ * Prometheus), so that the scrapers read the statistics without decoding the binary buffers.
+ *
+ * The text is rendered from the indexed information (see flouka_index.h) once, and again only when
+ * the schema generation changes (see flouka_getSchemaGeneration), every value has a slot of
+ * FLOUKA_METRICS_VALUE_DIGITS digits in it (padded with leading zeros), so that a scrape only
+ * takes a snapshot and writes the digits of every value in its slot.
+ *
+ * Every counter is a sample of the gauge named after the counter ("flouka_" followed by the name
+ * in lower case, with every run of other characters than letters and digits replaced by one
+ * underscore), so that the counters with the same name (ex. in different sub groups) are samples
+ * of the same metric, labeled with their group, sub group, unit and counter ID:
+ *
+ *   # TYPE flouka_bytes_transmitted gauge
+ *   # HELP flouka_bytes_transmitted <description of the first counter of the metric>
+ *   flouka_bytes_transmitted{group="...",sub_group="...",unit="...",counter_id="0"} 00...01000
+ *   ...
+ *   # EOF
+ *
+ * The counters of an added family instance are samples of the gauges named after the members of
+ * the family, labeled with the family name and the instance label instead of the sub group:
+ *
+ *   flouka_bytes_received{group="...",family="...",instance="...",unit="...",counter_id="5"} 00...
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+/*Number of the digits of every value, enough for the biggest counter value*/
+#define FLOUKA_METRICS_VALUE_DIGITS       (((sizeof(uint32) * 5) + 1) / 2)
+
+/*Content type of the text*/
+#define FLOUKA_METRICS_CONTENT_TYPE       "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+typedef struct flouka_metricsExporter flouka_metricsExporter_s;
+
+/***************************************************************************************************
+ *  Name        : flouka_metricsExporterInit
+ *
+ *  Arguments   : flouka_metricsExporter_s**    metricsExporter_Pointer_Ptr,
+ *                flouka_s*                     flouka_Ptr,
+ *                AllocFuncPtr                  allocationFunction_Ptr,
+ *                DeallocFuncPtr                deallocationFunction_Ptr
+ *
+ *  Description : This function creates a metrics exporter for the given statistics collector
+ *                object, the text is rendered on the first call of flouka_metricsExporterRender.
+ *
+ *  Returns     : flouka_status_e
+ **************************************************************************************************/
+flouka_status_e flouka_metricsExporterInit(flouka_metricsExporter_s** metricsExporter_Pointer_Ptr,
+                                           flouka_s* flouka_Ptr,
+                                           AllocFuncPtr allocationFunction_Ptr,
+                                           DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_metricsExporterDestroy
+ *
+ *  Arguments   : flouka_metricsExporter_s*     metricsExporter_Ptr
+ *
+ *  Description : This function releases all memory allocated by the metrics exporter.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_metricsExporterDestroy(flouka_metricsExporter_s* metricsExporter_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_metricsExporterRender
+ *
+ *  Arguments   : flouka_metricsExporter_s*     metricsExporter_Ptr,
+ *                uint8**                       textBufferPointer_Ptr,
+ *                uint32*                       textBufferSize_Ptr
+ *
+ *  Description : This function takes a snapshot of the statistics (see flouka_copySnapshot), and
+ *                returns the text with the values of the snapshot and its size, the text is
+ *                rendered again first if the schema changed since it was last rendered.
+ *
+ *                The text is owned by the exporter, and it is valid until the next call.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_metricsExporterRender(flouka_metricsExporter_s* metricsExporter_Ptr,
+                                  uint8** textBufferPointer_Ptr,
+                                  uint32* textBufferSize_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+#endif /* FLOUKA_METRICS_H_ */
@@ -0,0 +1,174 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+#ifndef FLOUKA_SCHEMA_H_
+#define FLOUKA_SCHEMA_H_
+
+/***************************************************************************************************
+ *
+ * This header is optional, it allows the groups, sub groups and counters to be described once, in
+ * a list macro (X-macro), from which the IDs, and the constant tables assigned by
+ * flouka_assignSchema are generated at compile time, instead of assigning them one by one.
+ *
+ * The list macro takes the three macros every entry is expanded with, and holds the groups, then
+ * the sub groups, and then the counters (an entry may only refer to the entries before it):
+ *
+ *   #define APP_SCHEMA(GROUP, SUB_GROUP, COUNTER)                                              \
+ *       GROUP(GROUP_ID_TRANSMISSION, "Transmission", "Transmission path")                    \
+ *       SUB_GROUP(SUB_GROUP_ID_TX_CONNECTION1, GROUP_ID_TRANSMISSION,                        \
+ *                 "Connection 1", "Transmission connection 1")                               \
+ *       COUNTER(COUNTER_ID_TX_BYTES1, SUB_GROUP_ID_TX_CONNECTION1,                           \
+ *               "Byte(s)", "Bytes", "Number of bytes transmitted")
+ *
+ *   FLOUKA_DECLARE_SCHEMA(APP_SCHEMA, APP)    (in a header, or before the IDs are used)
+ *   FLOUKA_DEFINE_SCHEMA(APP_SCHEMA, APP)     (in one source file)
+ *
+ *   FLOUKA_INIT(APP_GROUPS_COUNT, APP_SUB_GROUPS_COUNT, APP_COUNTERS_COUNT, ...);
+ *   FLOUKA_ASSIGN_SCHEMA(&APP_schema);
+ *
+ * FLOUKA_DECLARE_SCHEMA generates the enumerations of the IDs (numbered in the order of the
+ * list, ending with APP_GROUPS_COUNT, APP_SUB_GROUPS_COUNT and APP_COUNTERS_COUNT), and fails the
+ * compilation if an ID is defined twice, if the parent of a sub group is not a group of the
+ * schema, if the parent of a counter is not a sub group of the schema, or if a string is not a
+ * non empty string literal. FLOUKA_DEFINE_SCHEMA generates the constant descriptor tables and the
+ * APP_schema structure (see flouka_schema_s) pointing at them.
+ *
+ * The IDs must be plain identifiers (they are pasted to name the checks), and the schema must hold
+ * at least one group, one sub group and one counter. The families (see flouka_assignFamily) are
+ * assigned at run time, after the schema, from the counters beyond APP_COUNTERS_COUNT.
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+/*These macros expand an entry of the given type to nothing*/
+#define FLOUKA_SCHEMA_SKIP_GROUP(groupID, groupName, groupDescription)
+#define FLOUKA_SCHEMA_SKIP_SUB_GROUP(subgroupID, groupID, subgroupName, subgroupDescription)
+#define FLOUKA_SCHEMA_SKIP_COUNTER(counterID, subgroupID, unit, counterName, counterDescription)
+
+/*These macros expand an entry to its ID, as an enumerator*/
+#define FLOUKA_SCHEMA_GROUP_ID(groupID, groupName, groupDescription)                               \
+    groupID,
+#define FLOUKA_SCHEMA_SUB_GROUP_ID(subgroupID, groupID, subgroupName, subgroupDescription)         \
+    subgroupID,
+#define FLOUKA_SCHEMA_COUNTER_ID(counterID, subgroupID, unit, counterName, counterDescription)     \
+    counterID,
+
+/*These macros expand a group and a sub group to an enumerator that marks its ID as a parent, so
+  that the checks below can tell the IDs of the groups from those of the sub groups and counters
+  (the enumerators of the IDs are all plain integers)*/
+#define FLOUKA_SCHEMA_GROUP_PARENT(groupID, groupName, groupDescription)                           \
+    groupID##_isGroup,
+#define FLOUKA_SCHEMA_SUB_GROUP_PARENT(subgroupID, groupID, subgroupName, subgroupDescription)     \
+    subgroupID##_isSubGroup,
+
+/*These macros expand an entry to a member of the check structure, the size of the member is
+  negative (a compilation error) if a string is empty, the strings must be literals (they are
+  concatenated to ""), and the parent must be a group (or a sub group) of the schema, otherwise
+  its mark is not defined (a compilation error)*/
+#define FLOUKA_SCHEMA_CHECK_GROUP(groupID, groupName, groupDescription)                            \
+    char groupID##_isValid[((sizeof("" groupName) > 1) && (sizeof("" groupDescription) > 1))       \
+                           ? 1 : -1];
+#define FLOUKA_SCHEMA_CHECK_SUB_GROUP(subgroupID, groupID, subgroupName, subgroupDescription)      \
+    char subgroupID##_isValid[((sizeof("" subgroupName) > 1)                                       \
+                               && (sizeof("" subgroupDescription) > 1)                             \
+                               && (groupID##_isGroup >= 0))                                        \
+                              ? 1 : -1];
+#define FLOUKA_SCHEMA_CHECK_COUNTER(counterID, subgroupID, unit, counterName, counterDescription)  \
+    char counterID##_isValid[((sizeof("" unit) > 1) && (sizeof("" counterName) > 1)                \
+                              && (sizeof("" counterDescription) > 1)                               \
+                              && (subgroupID##_isSubGroup >= 0))                                   \
+                             ? 1 : -1];
+
+/*These macros expand an entry to its descriptor, as an element of a constant table*/
+#define FLOUKA_SCHEMA_GROUP_DESCRIPTOR(groupID, groupName, groupDescription)                       \
+    {(uint32) (groupID), (groupName), (groupDescription)},
+#define FLOUKA_SCHEMA_SUB_GROUP_DESCRIPTOR(subgroupID, groupID, subgroupName, subgroupDescription) \
+    {(uint32) (subgroupID), (uint32) (groupID), (subgroupName), (subgroupDescription)},
+#define FLOUKA_SCHEMA_COUNTER_DESCRIPTOR(counterID, subgroupID, unit, name, description)           \
+    {(uint32) (counterID), (uint32) (subgroupID), (unit), (name), (description)},
+
+/**************************************************************************************************/
+#define FLOUKA_DECLARE_SCHEMA(schema, prefix)                                                      \
+typedef enum prefix##_GroupID                                                                      \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_GROUP_ID, FLOUKA_SCHEMA_SKIP_SUB_GROUP, FLOUKA_SCHEMA_SKIP_COUNTER)       \
+    prefix##_GROUPS_COUNT                                                                          \
+} prefix##_GroupID_e;                                                                              \
+typedef enum prefix##_SubGroupID                                                                   \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_SKIP_GROUP, FLOUKA_SCHEMA_SUB_GROUP_ID, FLOUKA_SCHEMA_SKIP_COUNTER)       \
+    prefix##_SUB_GROUPS_COUNT                                                                      \
+} prefix##_SubGroupID_e;                                                                           \
+typedef enum prefix##_CounterID                                                                    \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_SKIP_GROUP, FLOUKA_SCHEMA_SKIP_SUB_GROUP, FLOUKA_SCHEMA_COUNTER_ID)       \
+    prefix##_COUNTERS_COUNT                                                                        \
+} prefix##_CounterID_e;                                                                            \
+typedef enum prefix##_SchemaParent                                                                 \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_GROUP_PARENT, FLOUKA_SCHEMA_SUB_GROUP_PARENT, FLOUKA_SCHEMA_SKIP_COUNTER) \
+    prefix##_SCHEMA_PARENTS_COUNT                                                                  \
+} prefix##_SchemaParent_e;                                                                         \
+typedef struct prefix##_SchemaCheck                                                                \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_CHECK_GROUP, FLOUKA_SCHEMA_CHECK_SUB_GROUP, FLOUKA_SCHEMA_CHECK_COUNTER)  \
+} prefix##_SchemaCheck_s;
+/**************************************************************************************************/
+#define FLOUKA_DEFINE_SCHEMA(schema, prefix)                                                       \
+STATIC const flouka_groupDescriptor_s prefix##_groupList[] =                                       \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_GROUP_DESCRIPTOR,                                                         \
+           FLOUKA_SCHEMA_SKIP_SUB_GROUP,                                                           \
+           FLOUKA_SCHEMA_SKIP_COUNTER)                                                             \
+};                                                                                                 \
+STATIC const flouka_subGroupDescriptor_s prefix##_subGroupList[] =                                 \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_SKIP_GROUP,                                                               \
+           FLOUKA_SCHEMA_SUB_GROUP_DESCRIPTOR,                                                     \
+           FLOUKA_SCHEMA_SKIP_COUNTER)                                                             \
+};                                                                                                 \
+STATIC const flouka_counterDescriptor_s prefix##_counterList[] =                                   \
+{                                                                                                  \
+    schema(FLOUKA_SCHEMA_SKIP_GROUP,                                                               \
+           FLOUKA_SCHEMA_SKIP_SUB_GROUP,                                                           \
+           FLOUKA_SCHEMA_COUNTER_DESCRIPTOR)                                                       \
+};                                                                                                 \
+STATIC const flouka_schema_s prefix##_schema =                                                     \
+{                                                                                                  \
+    prefix##_groupList,                                                                            \
+    prefix##_GROUPS_COUNT,                                                                         \
+    prefix##_subGroupList,                                                                         \
+    prefix##_SUB_GROUPS_COUNT,                                                                     \
+    prefix##_counterList,                                                                          \
+    prefix##_COUNTERS_COUNT                                                                        \
+};
+/**************************************************************************************************/
+
+#endif /* FLOUKA_SCHEMA_H_ */
@@ -0,0 +1,1661 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ *
+ *                                       I N C L U D E S
+ *
+ **************************************************************************************************/
+/*Needed for the credentials of the peer of a local socket (struct ucred)*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /*_GNU_SOURCE*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+
+#include "flouka.h"
+#include "flouka_delta.h"
+#include "flouka_metrics.h"
+#include "flouka_server.h"
+
+/***************************************************************************************************
+ *
+ *                                         M A C R O S
+ *
+ **************************************************************************************************/
+
+/*This macro is used to verify that the statistics server is initialized properly.*/
+#define FLOUKA_SERVER_INITIALIZATION_PATTEREN   (0x56785678)
+
+/*Size of the requests read from a client before their responses are sent (the biggest request is
+  the head of an HTTP request, the biggest binary request is a projection of
+  FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT selectors, 1 + 49 uint32 bytes)*/
+#define FLOUKA_SERVER_REQUESTS_SIZE             (1024)
+
+/*Size of the subscribe request without the counter IDs (request, interval and counters count)*/
+#define FLOUKA_SERVER_SUBSCRIBE_HEADER_SIZE     (sizeof(uint8) + (2 * sizeof(uint32)))
+
+/*Size of the projection request without the selectors (request and selectors count)*/
+#define FLOUKA_SERVER_PROJECTION_HEADER_SIZE    (sizeof(uint8) + sizeof(uint32))
+
+/*Size of one selector of the projection request (type, first ID and last ID)*/
+#define FLOUKA_SERVER_SELECTOR_SIZE             (3 * sizeof(uint32))
+
+/*Number of the fields of the pushed message before the counter values*/
+#define FLOUKA_SERVER_PUSH_HEADER_FIELDS_COUNT  (5)
+
+/*Number of the slots of the timer wheel, the subscriptions are distributed on the slots by their
+  due time, and the wheel moves one slot every tick*/
+#define FLOUKA_SERVER_TIMER_SLOTS_COUNT         (256)
+
+/*Duration of one tick of the timer wheel, the subscription intervals are rounded up to ticks*/
+#define FLOUKA_SERVER_TIMER_TICK_MILLISECONDS   (10)
+
+/*Number of socket events handled by one wait*/
+#define FLOUKA_SERVER_EVENTS_COUNT              (64)
+
+/*Number of connections waiting to be accepted*/
+#define FLOUKA_SERVER_LISTEN_BACKLOG            (128)
+
+/*This macro marks a client slot that is not connected*/
+#define FLOUKA_SERVER_NO_SOCKET                 (-1)
+
+/*Number of the fields of the header sent before a response (the frame of the statistics)*/
+#define FLOUKA_SERVER_HEADER_FIELDS_COUNT       (4)
+
+/*Responses of this size or bigger are sent without copying them to the socket (MSG_ZEROCOPY), the
+  smaller ones are cheaper to copy than to pin and to wait for their completion*/
+#define FLOUKA_SERVER_ZERO_COPY_SIZE            (16 * 1024)
+
+/*The zero copy sends are numbered by the kernel with 32-bit numbers*/
+#define FLOUKA_SERVER_ZERO_COPY_ID_MASK         (0xFFFFFFFF)
+
+/*Size of the memory receiving the completions of the zero copy sends*/
+#define FLOUKA_SERVER_COMPLETION_SIZE           (128)
+
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define FLOUKA_SERVER_ZERO_COPY
+#endif /*SO_ZEROCOPY && MSG_ZEROCOPY*/
+
+/*The HTTP request head ends with an empty line*/
+#define FLOUKA_SERVER_HTTP_HEAD_END             "\r\n\r\n"
+
+/*The HTTP method and path of the metrics, the path is followed by a space or a query*/
+#define FLOUKA_SERVER_HTTP_METHOD               "GET "
+#define FLOUKA_SERVER_HTTP_PATH                 "/metrics"
+
+/*Maximum size of the HTTP response head*/
+#define FLOUKA_SERVER_HTTP_HEAD_SIZE            (256)
+
+/***************************************************************************************************
+ *
+ *                                          T Y P E S
+ *
+ **************************************************************************************************/
+
+typedef enum flouka_ServerTransport
+{
+    /*The binary requests over TCP*/
+    FLOUKA_SERVER_TRANSPORT_TCP = 0,
+    /*The binary requests over the local socket*/
+    FLOUKA_SERVER_TRANSPORT_LOCAL = 1,
+    /*The HTTP requests of the metrics over TCP (see flouka_metrics.h)*/
+    FLOUKA_SERVER_TRANSPORT_HTTP = 2,
+    FLOUKA_SERVER_TRANSPORTS_COUNT = 3
+} flouka_ServerTransport_e;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_ServerClient_s
+ *
+ * Structure Description:
+ * This structure holds the state of one connected client of the statistics server.
+ **************************************************************************************************/
+typedef struct flouka_ServerClient
+{
+    /*Holds the socket of the client, FLOUKA_SERVER_NO_SOCKET if the slot is not used*/
+    int32 socket;
+    /*Holds the transport the client is connected to*/
+    flouka_ServerTransport_e transport;
+    /*Holds the descriptor passed to the client with the response, FLOUKA_SERVER_NO_SOCKET if none*/
+    int32 passedDescriptor;
+    /*Holds the socket events the server waits for (EPOLLIN and/or EPOLLOUT)*/
+    uint32 events;
+    /*Holds the requests read from the client and not answered yet*/
+    uint8 requestList[FLOUKA_SERVER_REQUESTS_SIZE];
+    /*Holds the number of bytes in requestList*/
+    uint32 requestsCount;
+    /*Points to the response being sent, it is kept allocated for the next responses*/
+    uint8* response_Ptr;
+    /*Holds the size of the memory allocated for the response*/
+    uint32 responseCapacity;
+    /*Holds the size of the response being sent, zero if no response is being sent*/
+    uint32 responseSize;
+    /*Holds the number of bytes of the header and the response that are sent already*/
+    uint32 responseSentSize;
+    /*Holds the header sent before the response (if any), the header and the response are sent
+      together, without copying them to one buffer*/
+    uint32 headerList[FLOUKA_SERVER_HEADER_FIELDS_COUNT];
+    /*Holds the size of the header in bytes, zero if the response has no header*/
+    uint32 headerSize;
+    /*TRUE if the socket of the client accepts the zero copy sends*/
+    bool isZeroCopy;
+    /*Holds the number of the zero copy sends, and the number of the completed ones, the response
+      memory is not changed until all the zero copy sends from it are completed*/
+    uint32 zeroCopySendsCount;
+    uint32 zeroCopyCompletionsCount;
+    /*Points to the delta encoder of the client, NULL until the first delta request*/
+    flouka_deltaEncoder_s* deltaEncoder_Ptr;
+    /*Holds the push interval in timer ticks, zero if the client is not subscribed*/
+    uint32 intervalTicks;
+    /*Holds the number of full turns of the timer wheel left before the push is due*/
+    uint32 timerRounds;
+    /*Holds the slot of the timer wheel the client is in*/
+    uint32 timerSlotIndex;
+    /*Points to the next and previous subscribed clients in the same slot of the timer wheel*/
+    struct flouka_ServerClient* timerNext_Ptr;
+    struct flouka_ServerClient* timerPrevious_Ptr;
+    /*TRUE if a push is due, it is sent as soon as the previous response is sent*/
+    bool isPushPending;
+    /*Holds the number of pushes that were due while a push was pending already*/
+    uint32 coalescedCount;
+    /*Holds the number of the subscribed counters, zero if all the counters are subscribed*/
+    uint32 subscribedCountersCount;
+    /*Holds the IDs of the subscribed counters*/
+    uint32 subscribedCounterList[FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT];
+} flouka_ServerClient_s;
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_server_s
+ *
+ * Structure Description:
+ * This structure represents the statistics server class type.
+ **************************************************************************************************/
+struct flouka_server
+{
+    /*Points to the statistics collector object the responses are taken from*/
+    flouka_s* flouka_Ptr;
+    /*Points to the function that will be used to allocate the responses*/
+    AllocFuncPtr allocationFunction_Ptr;
+    /*Points to the function that will be used to release the allocated memory*/
+    DeallocFuncPtr deallocationFunction_Ptr;
+    /*Holds the listening socket of every transport, FLOUKA_SERVER_NO_SOCKET if the server does not
+      listen on the transport*/
+    int32 listenSocketList[FLOUKA_SERVER_TRANSPORTS_COUNT];
+    /*Points to the metrics exporter of the HTTP clients, NULL if the server does not listen on HTTP*/
+    flouka_metricsExporter_s* metricsExporter_Ptr;
+    /*Holds the epoll instance waiting for the listening socket and the clients sockets*/
+    int32 epollDescriptor;
+    /*Holds the slots of the clients*/
+    flouka_ServerClient_s* clientList_Ptr;
+    /*Holds the number of slots of the clients*/
+    uint32 maximumClientsCount;
+    /*Holds the subscribed clients, every slot is a list of the clients due on the same tick*/
+    flouka_ServerClient_s* timerSlotList[FLOUKA_SERVER_TIMER_SLOTS_COUNT];
+    /*Holds the index of the slot of the current tick*/
+    uint32 timerSlotIndex;
+    /*Holds the time (milliseconds) of the current tick*/
+    uint32 timerTime;
+    /*Holds the number of the subscribed clients*/
+    uint32 subscriptionsCount;
+    /*Holds a copy of the counters, taken once per tick, and shared by all the pushes of the tick*/
+    uint32* snapshotValuesList_Ptr;
+    /*Holds the number of counters in snapshotValuesList_Ptr*/
+    uint32 snapshotValuesCount;
+    /*Describes the copy of the counters*/
+    flouka_snapshotInfo_s snapshotInfo;
+    /*TRUE if the copy of the counters was taken during the current tick*/
+    bool isSnapshotTaken;
+#ifdef DEBUG
+    uint32 initializationPattern;
+#endif /**/
+};
+
+/***************************************************************************************************
+ *
+ *                      I N T E R N A L   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+STATIC uint32 Server_getTime(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint32) now.tv_sec * 1000) + ((uint32) now.tv_nsec / 1000000));
+}
+
+STATIC void Server_startTimer(flouka_server_s* server_Ptr,
+                              flouka_ServerClient_s* client_Ptr)
+{
+    uint32 slotIndex;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Find the slot of the tick the push is due on, and the number of full turns of the wheel
+     *    before it.
+     * 2. Add the client to the head of the list of the slot.
+     */
+    slotIndex = (server_Ptr->timerSlotIndex + client_Ptr->intervalTicks) % FLOUKA_SERVER_TIMER_SLOTS_COUNT;
+    client_Ptr->timerRounds = (client_Ptr->intervalTicks - 1) / FLOUKA_SERVER_TIMER_SLOTS_COUNT;
+    client_Ptr->timerSlotIndex = slotIndex;
+    client_Ptr->timerPrevious_Ptr = NULL;
+    client_Ptr->timerNext_Ptr = server_Ptr->timerSlotList[slotIndex];
+    if(NULL != client_Ptr->timerNext_Ptr)
+    {
+        client_Ptr->timerNext_Ptr->timerPrevious_Ptr = client_Ptr;
+    }
+    server_Ptr->timerSlotList[slotIndex] = client_Ptr;
+}
+
+STATIC void Server_stopTimer(flouka_server_s* server_Ptr,
+                             flouka_ServerClient_s* client_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Remove the client from the list of its slot.
+     */
+    if(NULL == client_Ptr->timerPrevious_Ptr)
+    {
+        server_Ptr->timerSlotList[client_Ptr->timerSlotIndex] = client_Ptr->timerNext_Ptr;
+    }
+    else
+    {
+        client_Ptr->timerPrevious_Ptr->timerNext_Ptr = client_Ptr->timerNext_Ptr;
+    }
+    if(NULL != client_Ptr->timerNext_Ptr)
+    {
+        client_Ptr->timerNext_Ptr->timerPrevious_Ptr = client_Ptr->timerPrevious_Ptr;
+    }
+    client_Ptr->timerNext_Ptr = NULL;
+    client_Ptr->timerPrevious_Ptr = NULL;
+}
+
+STATIC void Server_closeClient(flouka_server_s* server_Ptr,
+                               flouka_ServerClient_s* client_Ptr)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Stop waiting for the socket of the client, and close it.
+     * 2. Cancel the subscription of the client (if any).
+     * 3. Release the response and the delta encoder of the client, and free its slot.
+     */
+    epoll_ctl(server_Ptr->epollDescriptor, EPOLL_CTL_DEL, client_Ptr->socket, NULL);
+    close(client_Ptr->socket);
+    if(0 != client_Ptr->intervalTicks)
+    {
+        Server_stopTimer(server_Ptr, client_Ptr);
+        server_Ptr->subscriptionsCount--;
+    }
+    if(NULL != client_Ptr->response_Ptr)
+    {
+        server_Ptr->deallocationFunction_Ptr(client_Ptr->response_Ptr);
+    }
+    if(NULL != client_Ptr->deltaEncoder_Ptr)
+    {
+        flouka_deltaEncoderDestroy(client_Ptr->deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    }
+    memset(client_Ptr, 0, sizeof(*client_Ptr));
+    client_Ptr->socket = FLOUKA_SERVER_NO_SOCKET;
+}
+
+STATIC bool Server_isPeerTrusted(flouka_ServerClient_s* client_Ptr)
+{
+    struct ucred peerCredentials;
+    socklen_t peerCredentialsSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return TRUE only if the peer of the local socket of the client runs as the same user as
+     *    the server, or as the super user, since the descriptor of the shared memory segment gives
+     *    access to all the counters (the abstract socket namespace has no file permissions).
+     */
+    peerCredentialsSize = sizeof(peerCredentials);
+    if(0 != getsockopt(client_Ptr->socket, SOL_SOCKET, SO_PEERCRED, &peerCredentials, &peerCredentialsSize))
+    {
+        return (FALSE);
+    }
+    return ((0 == peerCredentials.uid) || (geteuid() == peerCredentials.uid));
+}
+
+STATIC uint8* Server_reserveResponse(flouka_server_s* server_Ptr,
+                                     flouka_ServerClient_s* client_Ptr,
+                                     uint32 responseSize)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Grow the response memory of the client if it is smaller than the response.
+     * 2. Return the response memory.
+     */
+    if(client_Ptr->responseCapacity < responseSize)
+    {
+        if(NULL != client_Ptr->response_Ptr)
+        {
+            server_Ptr->deallocationFunction_Ptr(client_Ptr->response_Ptr);
+        }
+        client_Ptr->response_Ptr = (uint8*) server_Ptr->allocationFunction_Ptr(responseSize);
+        client_Ptr->responseCapacity = responseSize;
+    }
+    client_Ptr->responseSize = responseSize;
+    client_Ptr->responseSentSize = 0;
+    client_Ptr->headerSize = 0;
+    return (client_Ptr->response_Ptr);
+}
+
+STATIC void Server_takeSnapshot(flouka_server_s* server_Ptr)
+{
+    uint32 bufferSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Take one snapshot per tick into the buffer of the server (the buffers of flouka_getSnapshot
+     *    belong to the application), so that all the pushes of the same tick cost one pass over the
+     *    counters, the buffer is allocated again if the statistics collector object grew.
+     */
+    if(TRUE == server_Ptr->isSnapshotTaken)
+    {
+        return;
+    }
+    bufferSize = flouka_getStatisticsSize(server_Ptr->flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    if(server_Ptr->snapshotValuesCount < (bufferSize / sizeof(*server_Ptr->snapshotValuesList_Ptr)))
+    {
+        if(NULL != server_Ptr->snapshotValuesList_Ptr)
+        {
+            server_Ptr->deallocationFunction_Ptr(server_Ptr->snapshotValuesList_Ptr);
+        }
+        server_Ptr->snapshotValuesList_Ptr = (uint32*) server_Ptr->allocationFunction_Ptr(bufferSize);
+        server_Ptr->snapshotValuesCount = bufferSize / sizeof(*server_Ptr->snapshotValuesList_Ptr);
+    }
+    flouka_copySnapshot(server_Ptr->flouka_Ptr,
+                        (uint8*) server_Ptr->snapshotValuesList_Ptr,
+                        bufferSize,
+                        &(server_Ptr->snapshotInfo) COMMA()
+                        FILE_AND_LINE_FOR_REF());
+    server_Ptr->isSnapshotTaken = TRUE;
+}
+
+STATIC void Server_buildPush(flouka_server_s* server_Ptr,
+                             flouka_ServerClient_s* client_Ptr)
+{
+    uint32 i;
+    uint32 countersCount;
+    uint32 messageSize;
+    uint32* message_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Take the snapshot of the tick (if not taken yet).
+     * 2. Fill the pushed message (see flouka_server.h) with the subscribed counters.
+     * 3. Clear the pending push and the number of the coalesced pushes.
+     */
+    Server_takeSnapshot(server_Ptr);
+
+    countersCount = client_Ptr->subscribedCountersCount;
+    if(0 == countersCount)
+    {
+        countersCount = server_Ptr->snapshotValuesCount;
+    }
+    messageSize = (FLOUKA_SERVER_PUSH_HEADER_FIELDS_COUNT + countersCount) * sizeof(*message_Ptr);
+    message_Ptr = (uint32*) Server_reserveResponse(server_Ptr, client_Ptr, messageSize);
+
+    message_Ptr[0] = messageSize;
+    message_Ptr[1] = server_Ptr->snapshotInfo.sequenceNumber;
+    message_Ptr[2] = server_Ptr->snapshotInfo.timestampSeconds;
+    message_Ptr[3] = server_Ptr->snapshotInfo.timestampNanoseconds;
+    message_Ptr[4] = client_Ptr->coalescedCount;
+    message_Ptr += FLOUKA_SERVER_PUSH_HEADER_FIELDS_COUNT;
+    if(0 == client_Ptr->subscribedCountersCount)
+    {
+        memcpy(message_Ptr, server_Ptr->snapshotValuesList_Ptr, countersCount * sizeof(*message_Ptr));
+    }
+    else
+    {
+        for(i = 0; i < countersCount; i++)
+        {
+            message_Ptr[i] = server_Ptr->snapshotValuesList_Ptr[client_Ptr->subscribedCounterList[i]];
+        }
+    }
+
+    client_Ptr->isPushPending = FALSE;
+    client_Ptr->coalescedCount = 0;
+}
+
+STATIC bool Server_subscribe(flouka_server_s* server_Ptr,
+                             flouka_ServerClient_s* client_Ptr,
+                             const uint8* request_Ptr)
+{
+    uint32 i;
+    uint32 intervalMilliseconds;
+    uint32 countersCount;
+    uint32 totalCountersCount;
+    uint32 counterList[FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT];
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read the subscription (see flouka_server.h), and return FALSE if it is invalid (too many
+     *    counters, or an invalid counter ID).
+     * 2. Cancel the previous subscription of the client (if any), with its pending push.
+     * 3. Start the timer of the new subscription (unless the interval is zero), the wheel starts
+     *    from the current time if there were no subscriptions.
+     */
+    memcpy(&intervalMilliseconds, request_Ptr + sizeof(uint8), sizeof(intervalMilliseconds));
+    memcpy(&countersCount, request_Ptr + sizeof(uint8) + sizeof(uint32), sizeof(countersCount));
+    if(countersCount > FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT)
+    {
+        return (FALSE);
+    }
+    totalCountersCount = flouka_getStatisticsSize(server_Ptr->flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF())
+                    / sizeof(uint32);
+    memcpy(counterList, request_Ptr + FLOUKA_SERVER_SUBSCRIBE_HEADER_SIZE, countersCount * sizeof(uint32));
+    for(i = 0; i < countersCount; i++)
+    {
+        if(counterList[i] >= totalCountersCount)
+        {
+            return (FALSE);
+        }
+    }
+
+    if(0 != client_Ptr->intervalTicks)
+    {
+        Server_stopTimer(server_Ptr, client_Ptr);
+        server_Ptr->subscriptionsCount--;
+        client_Ptr->intervalTicks = 0;
+    }
+    client_Ptr->isPushPending = FALSE;
+    client_Ptr->coalescedCount = 0;
+    if(0 == intervalMilliseconds)
+    {
+        return (TRUE);
+    }
+
+    if(0 == server_Ptr->subscriptionsCount)
+    {
+        server_Ptr->timerTime = Server_getTime();
+        server_Ptr->isSnapshotTaken = FALSE;
+    }
+    server_Ptr->subscriptionsCount++;
+    client_Ptr->intervalTicks = (intervalMilliseconds + FLOUKA_SERVER_TIMER_TICK_MILLISECONDS - 1)
+                    / FLOUKA_SERVER_TIMER_TICK_MILLISECONDS;
+    client_Ptr->subscribedCountersCount = countersCount;
+    memcpy(client_Ptr->subscribedCounterList, counterList, countersCount * sizeof(uint32));
+    Server_startTimer(server_Ptr, client_Ptr);
+    return (TRUE);
+}
+
+STATIC bool Server_selectCounters(flouka_server_s* server_Ptr,
+                                  const uint32* selector_Ptr,
+                                  uint32* pairList_Ptr,
+                                  uint32* countersCount_Ptr)
+{
+    uint32 i;
+    uint32 j;
+    uint32 counterID;
+    uint32 countersCount;
+    uint32 totalCountersCount;
+    uint32* pair_Ptr;
+    const uint32* counterIDList_Ptr;
+    flouka_status_e status;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return FALSE if the selector is invalid (unknown type, or invalid IDs range).
+     * 2. Go over the counters of every group, sub group, or counter in the range, using the
+     *    membership index of the object (see flouka_getGroupCounters), and count them.
+     * 3. Write the ID and the value of every selected counter, unless only counting
+     *    (pairList_Ptr is NULL).
+     */
+    if(selector_Ptr[1] > selector_Ptr[2])
+    {
+        return (FALSE);
+    }
+    totalCountersCount = flouka_getStatisticsSize(server_Ptr->flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF())
+                    / sizeof(uint32);
+
+    for(i = selector_Ptr[1]; i <= selector_Ptr[2]; i++)
+    {
+        switch(selector_Ptr[0])
+        {
+            case FLOUKA_SELECTOR_GROUPS:
+                status = flouka_getGroupCounters(server_Ptr->flouka_Ptr,
+                                                 i,
+                                                 &counterIDList_Ptr,
+                                                 &countersCount COMMA()
+                                                 FILE_AND_LINE_FOR_REF());
+                break;
+            case FLOUKA_SELECTOR_SUB_GROUPS:
+                status = flouka_getSubGroupCounters(server_Ptr->flouka_Ptr,
+                                                    i,
+                                                    &counterIDList_Ptr,
+                                                    &countersCount COMMA()
+                                                    FILE_AND_LINE_FOR_REF());
+                break;
+            case FLOUKA_SELECTOR_COUNTERS:
+                counterID = i;
+                counterIDList_Ptr = &counterID;
+                countersCount = 1;
+                status = (i < totalCountersCount) ? FLOUKA_STATUS_SUCCESS : FLOUKA_STATUS_FAILURE;
+                break;
+            default:
+                status = FLOUKA_STATUS_FAILURE;
+                break;
+        }
+        if(FLOUKA_STATUS_SUCCESS != status)
+        {
+            return (FALSE);
+        }
+
+        if(NULL != pairList_Ptr)
+        {
+            pair_Ptr = pairList_Ptr + (2 * (*countersCount_Ptr));
+            for(j = 0; j < countersCount; j++)
+            {
+                pair_Ptr[2 * j] = counterIDList_Ptr[j];
+                pair_Ptr[(2 * j) + 1] = flouka_getCounter(server_Ptr->flouka_Ptr,
+                                                          counterIDList_Ptr[j] COMMA()
+                                                          FILE_AND_LINE_FOR_REF());
+            }
+        }
+        *countersCount_Ptr += countersCount;
+    }
+    return (TRUE);
+}
+
+STATIC bool Server_project(flouka_server_s* server_Ptr,
+                           flouka_ServerClient_s* client_Ptr,
+                           const uint8* request_Ptr)
+{
+    uint32 i;
+    uint32 selectorsCount;
+    uint32 countersCount;
+    uint32 messageSize;
+    uint32* message_Ptr;
+    uint32 selectorList[FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT][3];
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read the selectors (see flouka_server.h), and return FALSE if they are invalid.
+     * 2. Count the selected counters.
+     * 3. Fill the response with the IDs and the values of the selected counters.
+     */
+    memcpy(&selectorsCount, request_Ptr + sizeof(uint8), sizeof(selectorsCount));
+    if(selectorsCount > FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT)
+    {
+        return (FALSE);
+    }
+    memcpy(selectorList,
+           request_Ptr + FLOUKA_SERVER_PROJECTION_HEADER_SIZE,
+           selectorsCount * FLOUKA_SERVER_SELECTOR_SIZE);
+
+    countersCount = 0;
+    for(i = 0; i < selectorsCount; i++)
+    {
+        if(FALSE == Server_selectCounters(server_Ptr, selectorList[i], NULL, &countersCount))
+        {
+            return (FALSE);
+        }
+    }
+
+    messageSize = (2 + (2 * countersCount)) * sizeof(*message_Ptr);
+    message_Ptr = (uint32*) Server_reserveResponse(server_Ptr, client_Ptr, messageSize);
+    message_Ptr[0] = messageSize;
+    message_Ptr[1] = countersCount;
+    countersCount = 0;
+    for(i = 0; i < selectorsCount; i++)
+    {
+        Server_selectCounters(server_Ptr, selectorList[i], &(message_Ptr[2]), &countersCount);
+    }
+    return (TRUE);
+}
+
+STATIC bool Server_buildResponse(flouka_server_s* server_Ptr,
+                                 flouka_ServerClient_s* client_Ptr,
+                                 const uint8* request_Ptr)
+{
+    uint8 request;
+    uint8* buffer_Ptr;
+    uint32 bufferSize;
+    uint32 schemaGeneration;
+    uint32 segmentSize;
+    int32 sharedMemoryDescriptor;
+    struct stat fileStatus;
+    flouka_snapshotInfo_s snapshotInfo;
+    flouka_s* flouka_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Copy the response of the request to the response memory of the client, so that the
+     *    response does not change (or get released) while it is being sent.
+     * 2. Return FALSE if the client shall be closed (terminate or invalid request).
+     */
+    flouka_Ptr = server_Ptr->flouka_Ptr;
+    request = request_Ptr[0];
+    switch(request)
+    {
+        case FLOUKA_REQUEST_INFORMATION:
+            do
+            {
+                /*The information may grow between taking its size and copying it, so retry*/
+                bufferSize = flouka_getInformationSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF())
+                                + LENGTH_HEADER_SIZE;
+                client_Ptr->responseSize = flouka_getInformation(flouka_Ptr,
+                                                                 Server_reserveResponse(server_Ptr,
+                                                                                        client_Ptr,
+                                                                                        bufferSize),
+                                                                 bufferSize COMMA()
+                                                                 FILE_AND_LINE_FOR_REF());
+            } while(0 == client_Ptr->responseSize);
+            break;
+        case FLOUKA_REQUEST_STATISTICS:
+        case FLOUKA_REQUEST_FRAMED_STATISTICS:
+            bufferSize = flouka_getStatisticsSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+            flouka_copySnapshot(flouka_Ptr,
+                                Server_reserveResponse(server_Ptr, client_Ptr, bufferSize),
+                                bufferSize,
+                                &snapshotInfo COMMA()
+                                FILE_AND_LINE_FOR_REF());
+            if(FLOUKA_REQUEST_FRAMED_STATISTICS == request)
+            {
+                client_Ptr->headerList[0] = sizeof(client_Ptr->headerList) + bufferSize;
+                client_Ptr->headerList[1] = snapshotInfo.sequenceNumber;
+                client_Ptr->headerList[2] = snapshotInfo.timestampSeconds;
+                client_Ptr->headerList[3] = snapshotInfo.timestampNanoseconds;
+                client_Ptr->headerSize = sizeof(client_Ptr->headerList);
+            }
+            break;
+        case FLOUKA_REQUEST_FULL_STATISTICS:
+        case FLOUKA_REQUEST_DELTA_STATISTICS:
+            if(NULL == client_Ptr->deltaEncoder_Ptr)
+            {
+                flouka_deltaEncoderInit(&(client_Ptr->deltaEncoder_Ptr),
+                                        flouka_Ptr,
+                                        server_Ptr->allocationFunction_Ptr,
+                                        server_Ptr->deallocationFunction_Ptr COMMA()
+                                        FILE_AND_LINE_FOR_REF());
+            }
+            if(FLOUKA_REQUEST_FULL_STATISTICS == request)
+            {
+                flouka_deltaEncoderResynchronize(client_Ptr->deltaEncoder_Ptr COMMA()
+                                                 FILE_AND_LINE_FOR_REF());
+            }
+            bufferSize = flouka_deltaEncoderGetMaximumSize(client_Ptr->deltaEncoder_Ptr COMMA()
+                                                           FILE_AND_LINE_FOR_REF());
+            buffer_Ptr = Server_reserveResponse(server_Ptr, client_Ptr, bufferSize);
+            client_Ptr->responseSize = flouka_deltaEncoderEncode(client_Ptr->deltaEncoder_Ptr,
+                                                                 buffer_Ptr,
+                                                                 bufferSize COMMA()
+                                                                 FILE_AND_LINE_FOR_REF());
+            break;
+        case FLOUKA_REQUEST_SCHEMA_GENERATION:
+            schemaGeneration = flouka_getSchemaGeneration(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+            memcpy(Server_reserveResponse(server_Ptr, client_Ptr, sizeof(schemaGeneration)),
+                   &schemaGeneration,
+                   sizeof(schemaGeneration));
+            break;
+        case FLOUKA_REQUEST_INDEXED_INFORMATION:
+            flouka_getIndexedInformation(flouka_Ptr,
+                                         &buffer_Ptr,
+                                         &bufferSize COMMA()
+                                         FILE_AND_LINE_FOR_REF());
+            memcpy(Server_reserveResponse(server_Ptr, client_Ptr, bufferSize), buffer_Ptr, bufferSize);
+            break;
+        case FLOUKA_REQUEST_SUBSCRIBE:
+            return (Server_subscribe(server_Ptr, client_Ptr, request_Ptr));
+        case FLOUKA_REQUEST_PROJECTION:
+            return (Server_project(server_Ptr, client_Ptr, request_Ptr));
+        case FLOUKA_REQUEST_SHARED_MEMORY:
+            sharedMemoryDescriptor = flouka_getSharedMemoryDescriptor(flouka_Ptr COMMA()
+                                                                      FILE_AND_LINE_FOR_REF());
+            if((FLOUKA_SERVER_TRANSPORT_LOCAL != client_Ptr->transport) || (sharedMemoryDescriptor < 0)
+               || (FALSE == Server_isPeerTrusted(client_Ptr))
+               || (0 != fstat(sharedMemoryDescriptor, &fileStatus)))
+            {
+                return (FALSE);
+            }
+            segmentSize = (uint32) fileStatus.st_size;
+            memcpy(Server_reserveResponse(server_Ptr, client_Ptr, sizeof(segmentSize)),
+                   &segmentSize,
+                   sizeof(segmentSize));
+            client_Ptr->passedDescriptor = sharedMemoryDescriptor;
+            break;
+        default:
+            return (FALSE);
+    }
+    return (TRUE);
+}
+
+STATIC bool Server_buildHttpResponse(flouka_server_s* server_Ptr,
+                                     flouka_ServerClient_s* client_Ptr,
+                                     const uint8* request_Ptr,
+                                     uint32 requestSize)
+{
+    uint8* buffer_Ptr;
+    uint8* text_Ptr;
+    uint32 textSize;
+    uint32 pathEnd;
+    int headSize;
+    char head[FLOUKA_SERVER_HTTP_HEAD_SIZE];
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return FALSE (the client is closed) if the request is not a complete GET request.
+     * 2. Render the metrics of the counters if the metrics path is requested, and copy the head
+     *    and the text to the response memory of the client, the connection is kept alive.
+     * 3. Respond with "not found" to any other path.
+     */
+    if((requestSize < (sizeof(FLOUKA_SERVER_HTTP_METHOD) - 1) + (sizeof(FLOUKA_SERVER_HTTP_HEAD_END) - 1))
+       || (0 != memcmp(request_Ptr, FLOUKA_SERVER_HTTP_METHOD, sizeof(FLOUKA_SERVER_HTTP_METHOD) - 1))
+       || (0 != memcmp(&(request_Ptr[requestSize - (sizeof(FLOUKA_SERVER_HTTP_HEAD_END) - 1)]),
+                       FLOUKA_SERVER_HTTP_HEAD_END,
+                       sizeof(FLOUKA_SERVER_HTTP_HEAD_END) - 1)))
+    {
+        return (FALSE);
+    }
+
+    request_Ptr += sizeof(FLOUKA_SERVER_HTTP_METHOD) - 1;
+    pathEnd = sizeof(FLOUKA_SERVER_HTTP_PATH) - 1;
+    if((0 != memcmp(request_Ptr, FLOUKA_SERVER_HTTP_PATH, pathEnd))
+       || ((' ' != request_Ptr[pathEnd]) && ('?' != request_Ptr[pathEnd])))
+    {
+        headSize = snprintf(head,
+                            sizeof(head),
+                            "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        buffer_Ptr = Server_reserveResponse(server_Ptr, client_Ptr, (uint32) headSize);
+        memcpy(buffer_Ptr, head, (size_t) headSize);
+        return (TRUE);
+    }
+
+    flouka_metricsExporterRender(server_Ptr->metricsExporter_Ptr,
+                                 &text_Ptr,
+                                 &textSize COMMA()
+                                 FILE_AND_LINE_FOR_REF());
+    headSize = snprintf(head,
+                        sizeof(head),
+                        "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %lu\r\n\r\n",
+                        FLOUKA_METRICS_CONTENT_TYPE,
+                        textSize);
+    buffer_Ptr = Server_reserveResponse(server_Ptr, client_Ptr, (uint32) headSize + textSize);
+    memcpy(buffer_Ptr, head, (size_t) headSize);
+    memcpy(&(buffer_Ptr[headSize]), text_Ptr, textSize);
+    return (TRUE);
+}
+
+STATIC bool Server_receiveRequests(flouka_ServerClient_s* client_Ptr)
+{
+    ssize_t receivedSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read as many requests as there is room for, without blocking.
+     * 2. Return FALSE if the client closed the connection, or the connection failed.
+     */
+    receivedSize = recv(client_Ptr->socket,
+                        &(client_Ptr->requestList[client_Ptr->requestsCount]),
+                        FLOUKA_SERVER_REQUESTS_SIZE - client_Ptr->requestsCount,
+                        0);
+    if(receivedSize > 0)
+    {
+        client_Ptr->requestsCount += (uint32) receivedSize;
+        return (TRUE);
+    }
+    return ((receivedSize < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)));
+}
+
+STATIC bool Server_sendResponse(flouka_ServerClient_s* client_Ptr)
+{
+    int flags;
+    int descriptor;
+    bool isZeroCopySend;
+    ssize_t sentSize;
+    uint32 responseSentSize;
+    uint8 control[CMSG_SPACE(sizeof(int))];
+    struct iovec vectorList[2];
+    struct msghdr message;
+    struct cmsghdr* controlMessage_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Send as much of the pending header and response as possible without blocking, both in
+     *    one call.
+     * 2. Pass the descriptor of the response (if any) with the first part of it that is sent.
+     * 3. Send the big responses without copying them (if the socket accepts it), and count the
+     *    zero copy sends, falling back to a normal send if the kernel cannot pin more memory.
+     * 4. Mark the response as sent once all of it is sent.
+     * 5. Return FALSE if the connection failed.
+     */
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = vectorList;
+    while(client_Ptr->responseSentSize < (client_Ptr->headerSize + client_Ptr->responseSize))
+    {
+        message.msg_control = NULL;
+        message.msg_controllen = 0;
+        if(FLOUKA_SERVER_NO_SOCKET != client_Ptr->passedDescriptor)
+        {
+            memset(control, 0, sizeof(control));
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            controlMessage_Ptr = CMSG_FIRSTHDR(&message);
+            controlMessage_Ptr->cmsg_level = SOL_SOCKET;
+            controlMessage_Ptr->cmsg_type = SCM_RIGHTS;
+            controlMessage_Ptr->cmsg_len = CMSG_LEN(sizeof(int));
+            descriptor = (int) client_Ptr->passedDescriptor;
+            memcpy(CMSG_DATA(controlMessage_Ptr), &descriptor, sizeof(descriptor));
+        }
+
+        message.msg_iovlen = 0;
+        if(client_Ptr->responseSentSize < client_Ptr->headerSize)
+        {
+            vectorList[0].iov_base = ((uint8*) client_Ptr->headerList) + client_Ptr->responseSentSize;
+            vectorList[0].iov_len = client_Ptr->headerSize - client_Ptr->responseSentSize;
+            message.msg_iovlen++;
+            responseSentSize = 0;
+        }
+        else
+        {
+            responseSentSize = client_Ptr->responseSentSize - client_Ptr->headerSize;
+        }
+        vectorList[message.msg_iovlen].iov_base = client_Ptr->response_Ptr + responseSentSize;
+        vectorList[message.msg_iovlen].iov_len = client_Ptr->responseSize - responseSentSize;
+        message.msg_iovlen++;
+
+        flags = MSG_NOSIGNAL;
+        isZeroCopySend = FALSE;
+#ifdef FLOUKA_SERVER_ZERO_COPY
+        if((TRUE == client_Ptr->isZeroCopy) && (client_Ptr->responseSize >= FLOUKA_SERVER_ZERO_COPY_SIZE))
+        {
+            flags |= MSG_ZEROCOPY;
+            isZeroCopySend = TRUE;
+        }
+#endif /*FLOUKA_SERVER_ZERO_COPY*/
+        sentSize = sendmsg(client_Ptr->socket, &message, flags);
+        if((sentSize < 0) && (ENOBUFS == errno) && (TRUE == isZeroCopySend))
+        {
+            isZeroCopySend = FALSE;
+            sentSize = sendmsg(client_Ptr->socket, &message, MSG_NOSIGNAL);
+        }
+        if(sentSize < 0)
+        {
+            return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno));
+        }
+        if(TRUE == isZeroCopySend)
+        {
+            client_Ptr->zeroCopySendsCount = (client_Ptr->zeroCopySendsCount + 1)
+                            & FLOUKA_SERVER_ZERO_COPY_ID_MASK;
+        }
+        client_Ptr->passedDescriptor = FLOUKA_SERVER_NO_SOCKET;
+        client_Ptr->responseSentSize += (uint32) sentSize;
+    }
+    client_Ptr->responseSize = 0;
+    client_Ptr->responseSentSize = 0;
+    client_Ptr->headerSize = 0;
+    return (TRUE);
+}
+
+STATIC bool Server_receiveCompletions(flouka_ServerClient_s* client_Ptr)
+{
+    int socketError;
+    socklen_t socketErrorSize;
+    uint8 control[FLOUKA_SERVER_COMPLETION_SIZE];
+    struct msghdr message;
+    struct cmsghdr* controlMessage_Ptr;
+    struct sock_extended_err* extendedError_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read all the completions of the zero copy sends from the error queue of the socket, every
+     *    completion covers a range of the sends, and they are completed in order.
+     * 2. Return FALSE if the error queue holds anything else, or the socket has an error.
+     */
+    while(TRUE)
+    {
+        memset(&message, 0, sizeof(message));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if(recvmsg(client_Ptr->socket, &message, MSG_ERRQUEUE) < 0)
+        {
+            if((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                break;
+            }
+            return (FALSE);
+        }
+
+        for(controlMessage_Ptr = CMSG_FIRSTHDR(&message);
+            NULL != controlMessage_Ptr;
+            controlMessage_Ptr = CMSG_NXTHDR(&message, controlMessage_Ptr))
+        {
+            if((SOL_IP != controlMessage_Ptr->cmsg_level)
+               || (IP_RECVERR != controlMessage_Ptr->cmsg_type))
+            {
+                continue;
+            }
+            extendedError_Ptr = (struct sock_extended_err*) CMSG_DATA(controlMessage_Ptr);
+            if((0 != extendedError_Ptr->ee_errno)
+               || (SO_EE_ORIGIN_ZEROCOPY != extendedError_Ptr->ee_origin))
+            {
+                return (FALSE);
+            }
+            client_Ptr->zeroCopyCompletionsCount = ((uint32) extendedError_Ptr->ee_data + 1)
+                            & FLOUKA_SERVER_ZERO_COPY_ID_MASK;
+        }
+    }
+
+    socketError = 0;
+    socketErrorSize = sizeof(socketError);
+    getsockopt(client_Ptr->socket, SOL_SOCKET, SO_ERROR, &socketError, &socketErrorSize);
+    return (0 == socketError);
+}
+
+STATIC uint32 Server_getHttpRequestSize(flouka_ServerClient_s* client_Ptr)
+{
+    uint32 i;
+    uint32 headEndSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the size of the head of the first HTTP request (up to and including the empty
+     *    line), the body of the request (if any) is not read, since only GET is served.
+     * 2. Return the size of all the read bytes if the head is longer than the request memory, so
+     *    that it is rejected, or zero if the head is not read completely yet.
+     */
+    headEndSize = sizeof(FLOUKA_SERVER_HTTP_HEAD_END) - 1;
+    for(i = 0; (i + headEndSize) <= client_Ptr->requestsCount; i++)
+    {
+        if(0 == memcmp(&(client_Ptr->requestList[i]), FLOUKA_SERVER_HTTP_HEAD_END, headEndSize))
+        {
+            return (i + headEndSize);
+        }
+    }
+    return ((FLOUKA_SERVER_REQUESTS_SIZE == client_Ptr->requestsCount) ? client_Ptr->requestsCount : 0);
+}
+
+STATIC uint32 Server_getRequestSize(flouka_ServerClient_s* client_Ptr)
+{
+    uint32 headerSize;
+    uint32 itemSize;
+    uint32 maximumItemsCount;
+    uint32 itemsCount;
+    uint32 requestSize;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the size of the first request read from the client, or zero if it is not read
+     *    completely yet (all the binary requests are one byte, except the subscribe and the projection
+     *    requests, whose header ends with the number of the items that follow it).
+     */
+    if(0 == client_Ptr->requestsCount)
+    {
+        return (0);
+    }
+    if(FLOUKA_SERVER_TRANSPORT_HTTP == client_Ptr->transport)
+    {
+        return (Server_getHttpRequestSize(client_Ptr));
+    }
+    switch(client_Ptr->requestList[0])
+    {
+        case FLOUKA_REQUEST_SUBSCRIBE:
+            headerSize = FLOUKA_SERVER_SUBSCRIBE_HEADER_SIZE;
+            itemSize = sizeof(uint32);
+            maximumItemsCount = FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT;
+            break;
+        case FLOUKA_REQUEST_PROJECTION:
+            headerSize = FLOUKA_SERVER_PROJECTION_HEADER_SIZE;
+            itemSize = FLOUKA_SERVER_SELECTOR_SIZE;
+            maximumItemsCount = FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT;
+            break;
+        default:
+            return (sizeof(uint8));
+    }
+    if(client_Ptr->requestsCount < headerSize)
+    {
+        return (0);
+    }
+    memcpy(&itemsCount, &(client_Ptr->requestList[headerSize - sizeof(uint32)]), sizeof(itemsCount));
+    if(itemsCount > maximumItemsCount)
+    {
+        /*Invalid, it is rejected without reading the items*/
+        return (headerSize);
+    }
+    requestSize = headerSize + (itemsCount * itemSize);
+    return ((client_Ptr->requestsCount < requestSize) ? 0 : requestSize);
+}
+
+STATIC void Server_serveClient(flouka_server_s* server_Ptr,
+                               flouka_ServerClient_s* client_Ptr,
+                               uint32 events)
+{
+    uint32 requestSize;
+    uint32 neededEvents;
+    struct epoll_event event;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Read the completions of the zero copy sends, and the new requests of the client (if any).
+     * 2. Send the pending response, and then the pending push (if any), or answer the next request
+     *    once the previous response is sent (and its zero copy sends are completed), until a
+     *    response cannot be sent without blocking, or there are no more complete requests.
+     * 3. Wait for the socket to be writable if a response is pending, and to be readable only if
+     *    there is room for more requests (a client that does not read its responses is not read).
+     * 4. Close the client if its connection failed, or it requested to terminate (or sent an
+     *    invalid request).
+     */
+    if((0 != (events & EPOLLERR)) && (FALSE == Server_receiveCompletions(client_Ptr)))
+    {
+        Server_closeClient(server_Ptr, client_Ptr);
+        return;
+    }
+    if((0 != (events & EPOLLIN)) && (FALSE == Server_receiveRequests(client_Ptr)))
+    {
+        Server_closeClient(server_Ptr, client_Ptr);
+        return;
+    }
+    if((0 != (events & EPOLLHUP)) && (0 == (events & EPOLLIN)))
+    {
+        Server_closeClient(server_Ptr, client_Ptr);
+        return;
+    }
+
+    while(TRUE)
+    {
+        if(FALSE == Server_sendResponse(client_Ptr))
+        {
+            Server_closeClient(server_Ptr, client_Ptr);
+            return;
+        }
+        if((0 != client_Ptr->responseSize)
+           || (client_Ptr->zeroCopySendsCount != client_Ptr->zeroCopyCompletionsCount))
+        {
+            break;
+        }
+        if(TRUE == client_Ptr->isPushPending)
+        {
+            Server_buildPush(server_Ptr, client_Ptr);
+            continue;
+        }
+
+        requestSize = Server_getRequestSize(client_Ptr);
+        if(0 == requestSize)
+        {
+            break;
+        }
+        if(FLOUKA_SERVER_TRANSPORT_HTTP == client_Ptr->transport)
+        {
+            if(FALSE == Server_buildHttpResponse(server_Ptr, client_Ptr, client_Ptr->requestList, requestSize))
+            {
+                Server_closeClient(server_Ptr, client_Ptr);
+                return;
+            }
+        }
+        else if(FALSE == Server_buildResponse(server_Ptr, client_Ptr, client_Ptr->requestList))
+        {
+            Server_closeClient(server_Ptr, client_Ptr);
+            return;
+        }
+        client_Ptr->requestsCount -= requestSize;
+        memmove(&(client_Ptr->requestList[0]),
+                &(client_Ptr->requestList[requestSize]),
+                client_Ptr->requestsCount);
+    }
+
+    neededEvents = 0;
+    if(0 != client_Ptr->responseSize)
+    {
+        neededEvents |= EPOLLOUT;
+    }
+    if(client_Ptr->requestsCount < FLOUKA_SERVER_REQUESTS_SIZE)
+    {
+        neededEvents |= EPOLLIN;
+    }
+    if(neededEvents != client_Ptr->events)
+    {
+        event.events = neededEvents;
+        event.data.ptr = client_Ptr;
+        epoll_ctl(server_Ptr->epollDescriptor, EPOLL_CTL_MOD, client_Ptr->socket, &event);
+        client_Ptr->events = neededEvents;
+    }
+}
+
+STATIC void Server_advanceTimers(flouka_server_s* server_Ptr)
+{
+    uint32 now;
+    flouka_ServerClient_s* client_Ptr;
+    flouka_ServerClient_s* nextClient_Ptr;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Move the timer wheel one slot for every tick passed since the last move.
+     * 2. For every client in the slot that is due on this turn of the wheel, start its timer again,
+     *    and push the statistics to it (or count the push as coalesced if the previous push is
+     *    not sent yet, the pending push then carries the latest values).
+     */
+    now = Server_getTime();
+    while((0 != server_Ptr->subscriptionsCount)
+          && ((now - server_Ptr->timerTime) >= FLOUKA_SERVER_TIMER_TICK_MILLISECONDS))
+    {
+        server_Ptr->timerTime += FLOUKA_SERVER_TIMER_TICK_MILLISECONDS;
+        server_Ptr->timerSlotIndex = (server_Ptr->timerSlotIndex + 1) % FLOUKA_SERVER_TIMER_SLOTS_COUNT;
+        server_Ptr->isSnapshotTaken = FALSE;
+
+        client_Ptr = server_Ptr->timerSlotList[server_Ptr->timerSlotIndex];
+        while(NULL != client_Ptr)
+        {
+            nextClient_Ptr = client_Ptr->timerNext_Ptr;
+            if(0 != client_Ptr->timerRounds)
+            {
+                client_Ptr->timerRounds--;
+            }
+            else
+            {
+                Server_stopTimer(server_Ptr, client_Ptr);
+                Server_startTimer(server_Ptr, client_Ptr);
+                if(TRUE == client_Ptr->isPushPending)
+                {
+                    client_Ptr->coalescedCount++;
+                }
+                client_Ptr->isPushPending = TRUE;
+                Server_serveClient(server_Ptr, client_Ptr, 0);
+            }
+            client_Ptr = nextClient_Ptr;
+        }
+    }
+}
+
+STATIC int Server_getWaitTime(flouka_server_s* server_Ptr,
+                              int32 timeoutMilliseconds)
+{
+    uint32 elapsedTime;
+    uint32 waitTime;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return the given timeout if there are no subscriptions.
+     * 2. Otherwise, return the time left to the next tick, if it is shorter than the timeout.
+     */
+    if(0 == server_Ptr->subscriptionsCount)
+    {
+        return ((int) timeoutMilliseconds);
+    }
+    elapsedTime = Server_getTime() - server_Ptr->timerTime;
+    waitTime = (elapsedTime >= FLOUKA_SERVER_TIMER_TICK_MILLISECONDS) ?
+                    0 : (FLOUKA_SERVER_TIMER_TICK_MILLISECONDS - elapsedTime);
+    if((timeoutMilliseconds < 0) || (waitTime < (uint32) timeoutMilliseconds))
+    {
+        return ((int) waitTime);
+    }
+    return ((int) timeoutMilliseconds);
+}
+
+STATIC flouka_status_e Server_listen(flouka_server_s* server_Ptr,
+                                     flouka_ServerTransport_e transport,
+                                     const struct sockaddr* address_Ptr,
+                                     socklen_t addressSize)
+{
+    int32 option;
+    int32 listenSocket;
+    struct epoll_event event;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Create a non-blocking listening socket of the family of the given address, bind it to the
+     *    address (reusing the TCP ports left in TIME_WAIT by a previous run), and listen.
+     * 2. Wait for its connections with the epoll instance of the server, and keep it as the
+     *    listening socket of the given transport.
+     * 3. Fail (closing the socket) if any of the steps failed.
+     */
+    listenSocket = socket(address_Ptr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listenSocket < 0)
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+    if(AF_INET == address_Ptr->sa_family)
+    {
+        option = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if((0 != bind(listenSocket, address_Ptr, addressSize))
+       || (0 != listen(listenSocket, FLOUKA_SERVER_LISTEN_BACKLOG))
+       || (0 != epoll_ctl(server_Ptr->epollDescriptor, EPOLL_CTL_ADD, listenSocket, &event)))
+    {
+        close(listenSocket);
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    server_Ptr->listenSocketList[transport] = listenSocket;
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+STATIC void Server_acceptClients(flouka_server_s* server_Ptr,
+                                 flouka_ServerTransport_e transport)
+{
+#ifdef FLOUKA_SERVER_ZERO_COPY
+    int option;
+#endif /*FLOUKA_SERVER_ZERO_COPY*/
+    int32 clientSocket;
+    uint32 i;
+    flouka_ServerClient_s* client_Ptr;
+    struct epoll_event event;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Accept all the pending connections of the listening socket of the given transport.
+     * 2. Give every new client a free slot and wait for its requests, or close its connection if
+     *    there are no free slots.
+     * 3. Enable the zero copy sends on the socket of the client (if the kernel supports them, and
+     *    the client is not local).
+     */
+    while(TRUE)
+    {
+        clientSocket = accept(server_Ptr->listenSocketList[transport], NULL, NULL);
+        if(clientSocket < 0)
+        {
+            return;
+        }
+        fcntl(clientSocket, F_SETFL, O_NONBLOCK);
+
+        client_Ptr = NULL;
+        for(i = 0; i < server_Ptr->maximumClientsCount; i++)
+        {
+            if(FLOUKA_SERVER_NO_SOCKET == server_Ptr->clientList_Ptr[i].socket)
+            {
+                client_Ptr = &(server_Ptr->clientList_Ptr[i]);
+                break;
+            }
+        }
+
+        event.events = EPOLLIN;
+        event.data.ptr = client_Ptr;
+        if((NULL == client_Ptr)
+           || (0 != epoll_ctl(server_Ptr->epollDescriptor, EPOLL_CTL_ADD, clientSocket, &event)))
+        {
+            close(clientSocket);
+            continue;
+        }
+        client_Ptr->socket = clientSocket;
+        client_Ptr->events = EPOLLIN;
+        client_Ptr->transport = transport;
+        client_Ptr->passedDescriptor = FLOUKA_SERVER_NO_SOCKET;
+#ifdef FLOUKA_SERVER_ZERO_COPY
+        option = 1;
+        client_Ptr->isZeroCopy = (FLOUKA_SERVER_TRANSPORT_LOCAL != transport)
+                        && (0 == setsockopt(clientSocket, SOL_SOCKET, SO_ZEROCOPY, &option, sizeof(option)));
+#endif /*FLOUKA_SERVER_ZERO_COPY*/
+    }
+}
+
+/***************************************************************************************************
+ *
+ *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+flouka_status_e flouka_serverInit(flouka_server_s** server_Pointer_Ptr,
+                                  flouka_s* flouka_Ptr,
+                                  uint16 listenPort,
+                                  uint32 maximumClientsCount,
+                                  AllocFuncPtr allocationFunction_Ptr,
+                                  DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                  FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    int32 epollDescriptor;
+    struct sockaddr_in serverAddress;
+    flouka_server_s* server_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the server_Ptr (Must be NULL).
+     * 2. Validate the flouka_Ptr (not NULL).
+     * 3. Validate the maximum number of clients (non-zero).
+     * 4. Validate the allocation function pointer (not NULL).
+     * 5. Validate the deallocation function pointer (not NULL).
+     */
+    ASSERT((NULL == *server_Pointer_Ptr),
+                    "FLOUKA:  *server_Ptr pointer is not NULL, it is expected to initialize a NULL pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != flouka_Ptr),
+                    "FLOUKA:  Invalid statistics counter pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((maximumClientsCount > 0),
+                    "FLOUKA:  Maximum number of clients cannot be zero",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != allocationFunction_Ptr),
+                    "FLOUKA:  allocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != deallocationFunction_Ptr),
+                    "FLOUKA:  deallocation function cannot be NULL",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Create the epoll instance.
+     * 2. Allocate the server object, it listens on none of the transports yet.
+     * 3. Listen on the given TCP port (all the interfaces).
+     * 4. Allocate the slots of the clients (all free).
+     * 5. Fail (releasing what was created) if the epoll instance or the listening socket cannot be
+     *    created.
+     */
+    epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if(epollDescriptor < 0)
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    server_Ptr = (flouka_server_s*) allocationFunction_Ptr(sizeof(*server_Ptr));
+    memset(server_Ptr, 0, sizeof(*server_Ptr));
+    server_Ptr->flouka_Ptr = flouka_Ptr;
+    server_Ptr->allocationFunction_Ptr = allocationFunction_Ptr;
+    server_Ptr->deallocationFunction_Ptr = deallocationFunction_Ptr;
+    server_Ptr->epollDescriptor = epollDescriptor;
+    for(i = 0; i < FLOUKA_SERVER_TRANSPORTS_COUNT; i++)
+    {
+        server_Ptr->listenSocketList[i] = FLOUKA_SERVER_NO_SOCKET;
+    }
+
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+    serverAddress.sin_port = htons(listenPort);
+    if(FLOUKA_STATUS_SUCCESS != Server_listen(server_Ptr,
+                                              FLOUKA_SERVER_TRANSPORT_TCP,
+                                              (struct sockaddr*) &serverAddress,
+                                              sizeof(serverAddress)))
+    {
+        close(epollDescriptor);
+        deallocationFunction_Ptr((void*) server_Ptr);
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    server_Ptr->maximumClientsCount = maximumClientsCount;
+    server_Ptr->clientList_Ptr = (flouka_ServerClient_s*) allocationFunction_Ptr(maximumClientsCount
+                    * sizeof(*server_Ptr->clientList_Ptr));
+    memset(server_Ptr->clientList_Ptr, 0, maximumClientsCount * sizeof(*server_Ptr->clientList_Ptr));
+    for(i = 0; i < maximumClientsCount; i++)
+    {
+        server_Ptr->clientList_Ptr[i].socket = FLOUKA_SERVER_NO_SOCKET;
+    }
+#ifdef DEBUG
+    server_Ptr->initializationPattern = FLOUKA_SERVER_INITIALIZATION_PATTEREN;
+#endif /*DEBUG*/
+
+    *server_Pointer_Ptr = server_Ptr;
+    return (FLOUKA_STATUS_SUCCESS);
+}
+
+flouka_status_e flouka_serverListenLocal(flouka_server_s* server_Ptr,
+                                         const char* localSocketName_Ptr COMMA()
+                                         FILE_AND_LINE_FOR_TYPE())
+{
+    socklen_t addressSize;
+    struct sockaddr_un serverAddress;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the server_Ptr (not NULL, and not listening locally already).
+     * 2. Validate the localSocketName_Ptr (not NULL, and fits in the socket address).
+     */
+    ASSERT((NULL != server_Ptr),
+                    "FLOUKA:  Invalid server pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_SERVER_NO_SOCKET == server_Ptr->listenSocketList[FLOUKA_SERVER_TRANSPORT_LOCAL]),
+                    "FLOUKA:  The server is listening locally already",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != localSocketName_Ptr),
+                    "FLOUKA:  NULL was passed as the local socket name",
+                    fileName,
+                    lineNumber);
+    ASSERT((strlen(localSocketName_Ptr) < sizeof(serverAddress.sun_path)),
+                    "FLOUKA:  The local socket name is too long",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Listen on the local socket named in the abstract namespace (the first byte of the path
+     *    is zero), so that nothing is created on the file system, and the name is released with
+     *    the socket, fail if the name is used already.
+     */
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sun_family = AF_UNIX;
+    memcpy(&(serverAddress.sun_path[1]), localSocketName_Ptr, strlen(localSocketName_Ptr));
+    addressSize = (socklen_t) (offsetof(struct sockaddr_un, sun_path) + 1 + strlen(localSocketName_Ptr));
+
+    return (Server_listen(server_Ptr,
+                          FLOUKA_SERVER_TRANSPORT_LOCAL,
+                          (struct sockaddr*) &serverAddress,
+                          addressSize));
+}
+
+flouka_status_e flouka_serverListenHttp(flouka_server_s* server_Ptr,
+                                        uint16 httpPort COMMA()
+                                        FILE_AND_LINE_FOR_TYPE())
+{
+    struct sockaddr_in serverAddress;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the server_Ptr (not NULL, and not listening on HTTP already).
+     */
+    ASSERT((NULL != server_Ptr),
+                    "FLOUKA:  Invalid server pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_SERVER_NO_SOCKET == server_Ptr->listenSocketList[FLOUKA_SERVER_TRANSPORT_HTTP]),
+                    "FLOUKA:  The server is listening on HTTP already",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Listen on the given TCP port of the loopback interface only.
+     * 2. Create the metrics exporter shared by all the HTTP clients (the text is rendered on the
+     *    first request).
+     */
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    serverAddress.sin_port = htons(httpPort);
+    if(FLOUKA_STATUS_SUCCESS != Server_listen(server_Ptr,
+                                              FLOUKA_SERVER_TRANSPORT_HTTP,
+                                              (struct sockaddr*) &serverAddress,
+                                              sizeof(serverAddress)))
+    {
+        return (FLOUKA_STATUS_FAILURE);
+    }
+
+    return (flouka_metricsExporterInit(&(server_Ptr->metricsExporter_Ptr),
+                                       server_Ptr->flouka_Ptr,
+                                       server_Ptr->allocationFunction_Ptr,
+                                       server_Ptr->deallocationFunction_Ptr COMMA()
+                                       FILE_AND_LINE_FOR_CALL()));
+}
+
+void flouka_serverDestroy(flouka_server_s* server_Ptr COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 i;
+    DeallocFuncPtr deallocationFunctionPointer;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the server_Ptr (not NULL).
+     * 2. Validate the server_Ptr (already initialized).
+     */
+    ASSERT((NULL != server_Ptr),
+                    "FLOUKA:  Invalid server pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((FLOUKA_SERVER_INITIALIZATION_PATTEREN == server_Ptr->initializationPattern),
+                    "FLOUKA:  Invalid server pointer passed (either not initialized pointer, or incorrect, non-null pointer)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Close all the connected clients.
+     * 2. Close the epoll instance and the listening sockets.
+     * 3. Destroy the metrics exporter (if any).
+     * 4. Deallocate the copy of the counters, the slots of the clients, and the server itself.
+     */
+    for(i = 0; i < server_Ptr->maximumClientsCount; i++)
+    {
+        if(FLOUKA_SERVER_NO_SOCKET != server_Ptr->clientList_Ptr[i].socket)
+        {
+            Server_closeClient(server_Ptr, &(server_Ptr->clientList_Ptr[i]));
+        }
+    }
+    close(server_Ptr->epollDescriptor);
+    for(i = 0; i < FLOUKA_SERVER_TRANSPORTS_COUNT; i++)
+    {
+        if(FLOUKA_SERVER_NO_SOCKET != server_Ptr->listenSocketList[i])
+        {
+            close(server_Ptr->listenSocketList[i]);
+        }
+    }
+    if(NULL != server_Ptr->metricsExporter_Ptr)
+    {
+        flouka_metricsExporterDestroy(server_Ptr->metricsExporter_Ptr COMMA() FILE_AND_LINE_FOR_CALL());
+    }
+
+    deallocationFunctionPointer = server_Ptr->deallocationFunction_Ptr;
+    if(NULL != server_Ptr->snapshotValuesList_Ptr)
+    {
+        deallocationFunctionPointer(server_Ptr->snapshotValuesList_Ptr);
+    }
+    deallocationFunctionPointer(server_Ptr->clientList_Ptr);
+    deallocationFunctionPointer((void*) server_Ptr);
+}
+
+flouka_status_e flouka_serverPoll(flouka_server_s* server_Ptr,
+                                  int32 timeoutMilliseconds COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    int32 i;
+    int32 eventsCount;
+    uint32 transport;
+    struct epoll_event eventList[FLOUKA_SERVER_EVENTS_COUNT];
+
+    ASSERT((NULL != server_Ptr),
+                    "FLOUKA:  Invalid server pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Wait for the sockets up to the given time, or up to the next tick of the timer wheel.
+     * 2. Accept the new clients if a listening socket is readable (both listening sockets are
+     *    tried, they do not block).
+     * 3. Serve every client whose socket is ready (skipping the clients closed meanwhile).
+     * 4. Push the statistics to the subscriptions that are due.
+     */
+    eventsCount = epoll_wait(server_Ptr->epollDescriptor,
+                             eventList,
+                             FLOUKA_SERVER_EVENTS_COUNT,
+                             Server_getWaitTime(server_Ptr, timeoutMilliseconds));
+    if(eventsCount < 0)
+    {
+        return ((EINTR == errno) ? FLOUKA_STATUS_SUCCESS : FLOUKA_STATUS_FAILURE);
+    }
+
+    for(i = 0; i < eventsCount; i++)
+    {
+        if(NULL == eventList[i].data.ptr)
+        {
+            for(transport = 0; transport < FLOUKA_SERVER_TRANSPORTS_COUNT; transport++)
+            {
+                if(FLOUKA_SERVER_NO_SOCKET != server_Ptr->listenSocketList[transport])
+                {
+                    Server_acceptClients(server_Ptr, (flouka_ServerTransport_e) transport);
+                }
+            }
+        }
+        else if(FLOUKA_SERVER_NO_SOCKET != ((flouka_ServerClient_s*) eventList[i].data.ptr)->socket)
+        {
+            Server_serveClient(server_Ptr,
+                               (flouka_ServerClient_s*) eventList[i].data.ptr,
+                               eventList[i].events);
+        }
+    }
+    Server_advanceTimers(server_Ptr);
+    return (FLOUKA_STATUS_SUCCESS);
+}
@@ -0,0 +1,259 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_SERVER_H_
+#define FLOUKA_SERVER_H_
+
+/***************************************************************************************************
+ *
+ * The statistics server serves the statistics of one statistics collector object over TCP (and
+ * optionally a local socket, and HTTP) to many clients (collectors) at once, it uses non-blocking sockets
+ * and epoll, and all its work is done by the thread calling flouka_serverPoll, which shall not be
+ * one of the application threads that update the counters (the counters are never locked while a
+ * response is sent).
+ *
+ * Protocol:
+ * Every request is a single byte (flouka_request_e), and the client may send a request before the
+ * response of the previous one is received, the requests of a client are answered in order, and a
+ * client that does not read its responses only delays itself (its requests are not read until its
+ * pending response is sent).
+ *
+ * Subscription:
+ * The FLOUKA_REQUEST_SUBSCRIBE request byte is followed by (all the fields are in the host byte
+ * order, like the statistics buffer):
+ *
+ *   uint32    intervalMilliseconds   Push interval, zero cancels the subscription of the client.
+ *   uint32    countersCount          Number of the counter IDs that follow, zero for all counters
+ *                                    (at most FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT).
+ *   uint32[countersCount]            IDs of the counters to push, in the order they are pushed.
+ *
+ * The subscribe request has no response, instead the server pushes the following message every
+ * interval (a new subscription replaces the previous one of the same client):
+ *
+ *   uint32    messageSize            Size of the whole message in bytes, including this field.
+ *   uint32    sequenceNumber         Sequence number of the snapshot (see flouka_getSnapshot).
+ *   uint32    timestampSeconds       Time of the snapshot (see flouka_snapshotInfo_s).
+ *   uint32    timestampNanoseconds
+ *   uint32    coalescedCount         Number of pushes skipped since the previous message, because
+ *                                    the client did not read fast enough (the client never gets
+ *                                    more than one message behind, it gets the latest values).
+ *   uint32[]                         Values of the subscribed counters.
+ *
+ * The pushed messages are sent between the responses (never in the middle of one).
+ *
+ * Projection:
+ * The FLOUKA_REQUEST_PROJECTION request byte is followed by:
+ *
+ *   uint32    selectorsCount         Number of the selectors that follow (at most
+ *                                    FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT).
+ *   selectorsCount times:
+ *   uint32    selectorType           flouka_selector_e.
+ *   uint32    firstID                First and last (inclusive) IDs of the selected groups, sub
+ *   uint32    lastID                 groups or counters.
+ *
+ * The response holds the selected counters, in the order of the selectors (the counters of a group
+ * or a sub group are in the order of flouka_getGroupCounters), a counter selected twice is sent
+ * twice, and an invalid selector closes the client:
+ *
+ *   uint32    messageSize            Size of the whole message in bytes, including this field.
+ *   uint32    countersCount          Number of the selected counters.
+ *   countersCount times:
+ *   uint32    counterID
+ *   uint32    value
+ *
+ * Framed statistics:
+ * The response of FLOUKA_REQUEST_FRAMED_STATISTICS is the statistics buffer (see
+ * flouka_copySnapshot) preceded by:
+ *
+ *   uint32    messageSize            Size of the whole message in bytes, including this field.
+ *   uint32    sequenceNumber         Sequence number of the snapshot.
+ *   uint32    timestampSeconds       Time of the snapshot (see flouka_snapshotInfo_s).
+ *   uint32    timestampNanoseconds
+ *
+ * The snapshot is taken directly into the memory of the response, and the frame and the snapshot
+ * are sent together in one call, the big statistics buffers are sent without copying them to the
+ * socket (MSG_ZEROCOPY) where the kernel supports it.
+ *
+ * Local socket:
+ * The server may also listen on a local (Unix domain) socket in the abstract namespace (see
+ * flouka_serverListenLocal), which serves the same requests to the collectors on the same host
+ * without the cost of TCP. The response of FLOUKA_REQUEST_SHARED_MEMORY, which is accepted only
+ * from the local socket, and only from a peer running as the same user as the server (or as the
+ * super user, see SO_PEERCRED), is:
+ *
+ *   uint32    segmentSize            Size of the shared memory segment in bytes.
+ *
+ * and it comes with a read only descriptor of the shared memory segment the counters are exported
+ * to (SCM_RIGHTS), the collector maps the segment and reads the counters from it without any
+ * system call (see flouka_sharedMemoryConnect), the client is closed if the counters are not
+ * exported.
+ *
+ * Metrics (HTTP):
+ * The server may also listen on an HTTP port of the loopback interface (see
+ * flouka_serverListenHttp), which answers "GET /metrics" with the text of all the counters in the
+ * OpenMetrics format (see flouka_metrics.h), so that a Prometheus compatible scraper (or a sidecar
+ * forwarding to one) reads the counters without a custom collector, any other path is not found,
+ * and any other request closes the client.
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+/*Maximum number of counter IDs in one subscription*/
+#define FLOUKA_SERVER_SUBSCRIPTION_COUNTERS_COUNT   (32)
+
+/*Maximum number of selectors in one projection*/
+#define FLOUKA_SERVER_PROJECTION_SELECTORS_COUNT    (16)
+
+typedef enum flouka_request
+{
+    /*Closes the connection of the client*/
+    FLOUKA_REQUEST_TERMINATE = 0,
+    /*The response is the information (see flouka_getInformation)*/
+    FLOUKA_REQUEST_INFORMATION = 1,
+    /*The response is the statistics buffer (see flouka_getSnapshot)*/
+    FLOUKA_REQUEST_STATISTICS = 2,
+    /*The response is a delta message (see flouka_delta.h)*/
+    FLOUKA_REQUEST_DELTA_STATISTICS = 3,
+    /*The response is a full delta message (see flouka_delta.h)*/
+    FLOUKA_REQUEST_FULL_STATISTICS = 4,
+    /*The response is the schema generation (see flouka_getSchemaGeneration)*/
+    FLOUKA_REQUEST_SCHEMA_GENERATION = 5,
+    /*The response is the indexed information (see flouka_index.h)*/
+    FLOUKA_REQUEST_INDEXED_INFORMATION = 6,
+    /*Followed by the subscription, the statistics are then pushed periodically (see above)*/
+    FLOUKA_REQUEST_SUBSCRIBE = 7,
+    /*Followed by the selectors, the response is the selected counters only (see above)*/
+    FLOUKA_REQUEST_PROJECTION = 8,
+    /*The response is the statistics buffer preceded by its frame (see above)*/
+    FLOUKA_REQUEST_FRAMED_STATISTICS = 9,
+    /*The response is the size of the shared memory segment, with its descriptor (see above)*/
+    FLOUKA_REQUEST_SHARED_MEMORY = 10
+} flouka_request_e;
+
+typedef enum flouka_selector
+{
+    /*Selects all the counters of the groups in the range*/
+    FLOUKA_SELECTOR_GROUPS = 0,
+    /*Selects all the counters of the sub groups in the range*/
+    FLOUKA_SELECTOR_SUB_GROUPS = 1,
+    /*Selects the counters in the range*/
+    FLOUKA_SELECTOR_COUNTERS = 2
+} flouka_selector_e;
+
+typedef struct flouka_server flouka_server_s;
+
+/***************************************************************************************************
+ *  Name        : flouka_serverInit
+ *
+ *  Arguments   : flouka_server_s**     server_Pointer_Ptr,
+ *                flouka_s*             flouka_Ptr,
+ *                uint16                listenPort,
+ *                uint32                maximumClientsCount,
+ *                AllocFuncPtr          allocationFunction_Ptr,
+ *                DeallocFuncPtr        deallocationFunction_Ptr
+ *
+ *  Description : This function creates a statistics server for the given statistics collector
+ *                object, listening on the given TCP port (all the interfaces), the connections
+ *                above the maximum number of clients are closed as soon as they are accepted.
+ *
+ *  Returns     : flouka_status_e
+ **************************************************************************************************/
+flouka_status_e flouka_serverInit(flouka_server_s** server_Pointer_Ptr,
+                                  flouka_s* flouka_Ptr,
+                                  uint16 listenPort,
+                                  uint32 maximumClientsCount,
+                                  AllocFuncPtr allocationFunction_Ptr,
+                                  DeallocFuncPtr deallocationFunction_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_serverListenLocal
+ *
+ *  Arguments   : flouka_server_s*      server_Ptr,
+ *                const char*           localSocketName_Ptr
+ *
+ *  Description : This function makes the statistics server listen on a local socket too, with the
+ *                given name in the abstract namespace (nothing is created on the file system), the
+ *                local clients share the maximum number of clients with the TCP clients.
+ *
+ *  Returns     : flouka_status_e (failure if the socket cannot be created or the name is used)
+ **************************************************************************************************/
+flouka_status_e flouka_serverListenLocal(flouka_server_s* server_Ptr,
+                                         const char* localSocketName_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_serverListenHttp
+ *
+ *  Arguments   : flouka_server_s*      server_Ptr,
+ *                uint16                httpPort
+ *
+ *  Description : This function makes the statistics server serve the metrics of the counters over
+ *                HTTP too, on the given port of the loopback interface only, the HTTP clients
+ *                share the maximum number of clients with the other clients.
+ *
+ *  Returns     : flouka_status_e (failure if the socket cannot be created or the port is used)
+ **************************************************************************************************/
+flouka_status_e flouka_serverListenHttp(flouka_server_s* server_Ptr,
+                                        uint16 httpPort COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_serverDestroy
+ *
+ *  Arguments   : flouka_server_s*      server_Ptr
+ *
+ *  Description : This function closes the connections of all the clients and the listening socket,
+ *                and releases all memory allocated by the statistics server.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_serverDestroy(flouka_server_s* server_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_serverPoll
+ *
+ *  Arguments   : flouka_server_s*      server_Ptr,
+ *                int32                 timeoutMilliseconds
+ *
+ *  Description : This function waits up to the given time (-1 waits forever) for the clients, and
+ *                then accepts the new clients, reads their requests, and sends their responses as
+ *                far as it can without blocking, it shall be called in a loop by the thread
+ *                dedicated to the server, the wait ends earlier when a subscription is due.
+ *
+ *  Returns     : flouka_status_e (failure only if waiting for the clients failed)
+ **************************************************************************************************/
+flouka_status_e flouka_serverPoll(flouka_server_s* server_Ptr,
+                                  int32 timeoutMilliseconds COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+#endif /* FLOUKA_SERVER_H_ */
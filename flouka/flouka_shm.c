@@ -0,0 +1,385 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+/***************************************************************************************************
+ *
+ *                                       I N C L U D E S
+ *
+ **************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "flouka.h"
+#include "flouka_shm.h"
+#include "flouka_server.h"
+
+/***************************************************************************************************
+ *
+ *                      I N T E R N A L   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+STATIC INLINE uint32 SharedMemory_beginRead(const flouka_sharedMemoryHeader_s* header_Ptr)
+{
+    uint32 changeSequence;
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Wait until no publish is in progress, and return the change sequence.
+     */
+    do
+    {
+        changeSequence = __atomic_load_n(&(header_Ptr->changeSequence), __ATOMIC_ACQUIRE);
+    } while(0 != (changeSequence & 1));
+
+    return (changeSequence);
+}
+
+STATIC INLINE bool SharedMemory_endRead(const flouka_sharedMemoryHeader_s* header_Ptr,
+                                        uint32 changeSequence)
+{
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Return whether no publish started since SharedMemory_beginRead was called.
+     */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (changeSequence == __atomic_load_n(&(header_Ptr->changeSequence), __ATOMIC_RELAXED));
+}
+
+/***************************************************************************************************
+ *
+ *                     I N T E R F A C E   F U N C T I O N   D E F I N I T I O N S
+ *
+ **************************************************************************************************/
+
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryAttach(const char* sharedMemoryName_Ptr COMMA()
+                                                             FILE_AND_LINE_FOR_TYPE())
+{
+    int32 fileDescriptor;
+    const flouka_sharedMemoryHeader_s* header_Ptr;
+
+    ASSERT((NULL != sharedMemoryName_Ptr),
+                    "FLOUKA:  NULL was passed as the shared memory name",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Open the segment, map it, and close it (the mapping stays valid).
+     */
+    fileDescriptor = shm_open(sharedMemoryName_Ptr, O_RDONLY, 0);
+    if(fileDescriptor < 0)
+    {
+        return (NULL);
+    }
+    header_Ptr = flouka_sharedMemoryAttachDescriptor(fileDescriptor COMMA() FILE_AND_LINE_FOR_CALL());
+    close(fileDescriptor);
+
+    return (header_Ptr);
+}
+
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryAttachDescriptor(int32 fileDescriptor COMMA()
+                                                                       FILE_AND_LINE_FOR_TYPE())
+{
+    struct stat fileStatus;
+    const flouka_sharedMemoryHeader_s* header_Ptr;
+
+    ASSERT((fileDescriptor >= 0),
+                    "FLOUKA:  Invalid shared memory descriptor passed",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Map all of the segment (read only).
+     * 2. Unmap it and return NULL unless it is ready (the magic is written last by the creator), and
+     *    it has the same version and the size it was created with.
+     */
+    if((0 != fstat(fileDescriptor, &fileStatus))
+       || ((size_t) fileStatus.st_size < sizeof(*header_Ptr)))
+    {
+        return (NULL);
+    }
+    header_Ptr = (const flouka_sharedMemoryHeader_s*) mmap(NULL,
+                                                           (size_t) fileStatus.st_size,
+                                                           PROT_READ,
+                                                           MAP_SHARED,
+                                                           fileDescriptor,
+                                                           0);
+    if(MAP_FAILED == (void*) header_Ptr)
+    {
+        return (NULL);
+    }
+
+    if((FLOUKA_SHARED_MEMORY_MAGIC != __atomic_load_n(&(header_Ptr->magic), __ATOMIC_ACQUIRE))
+       || (FLOUKA_SHARED_MEMORY_VERSION != header_Ptr->version)
+       || ((uint32) fileStatus.st_size != header_Ptr->segmentSize))
+    {
+        munmap((void*) header_Ptr, (size_t) fileStatus.st_size);
+        return (NULL);
+    }
+
+    return (header_Ptr);
+}
+
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryConnect(const char* localSocketName_Ptr COMMA()
+                                                              FILE_AND_LINE_FOR_TYPE())
+{
+    uint8 request;
+    int receivedDescriptor;
+    int32 clientSocket;
+    int32 fileDescriptor;
+    uint32 segmentSize;
+    uint32 receivedSize;
+    ssize_t size;
+    socklen_t addressSize;
+    uint8 control[CMSG_SPACE(sizeof(int))];
+    struct sockaddr_un address;
+    struct iovec vector;
+    struct msghdr message;
+    struct cmsghdr* controlMessage_Ptr;
+    const flouka_sharedMemoryHeader_s* header_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the localSocketName_Ptr (not NULL, and fits in the socket address).
+     */
+    ASSERT((NULL != localSocketName_Ptr),
+                    "FLOUKA:  NULL was passed as the local socket name",
+                    fileName,
+                    lineNumber);
+    ASSERT((strlen(localSocketName_Ptr) < sizeof(address.sun_path)),
+                    "FLOUKA:  The local socket name is too long",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Connect to the local socket of the statistics server (in the abstract namespace, see
+     *    flouka_serverListenLocal), and request the shared memory segment.
+     * 2. Receive the size of the segment, the descriptor of the segment comes with it.
+     * 3. Close the connection, map the segment, and close the descriptor (the mapping stays valid).
+     * 4. Return NULL if any of the steps failed.
+     */
+    clientSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(clientSocket < 0)
+    {
+        return (NULL);
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(&(address.sun_path[1]), localSocketName_Ptr, strlen(localSocketName_Ptr));
+    addressSize = (socklen_t) (offsetof(struct sockaddr_un, sun_path) + 1 + strlen(localSocketName_Ptr));
+    request = FLOUKA_REQUEST_SHARED_MEMORY;
+    if((0 != connect(clientSocket, (struct sockaddr*) &address, addressSize))
+       || ((ssize_t) sizeof(request) != send(clientSocket, &request, sizeof(request), MSG_NOSIGNAL)))
+    {
+        close(clientSocket);
+        return (NULL);
+    }
+
+    fileDescriptor = -1;
+    receivedSize = 0;
+    while(receivedSize < sizeof(segmentSize))
+    {
+        vector.iov_base = ((uint8*) &segmentSize) + receivedSize;
+        vector.iov_len = sizeof(segmentSize) - receivedSize;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        size = recvmsg(clientSocket, &message, MSG_CMSG_CLOEXEC);
+        if(size <= 0)
+        {
+            break;
+        }
+        for(controlMessage_Ptr = CMSG_FIRSTHDR(&message);
+            NULL != controlMessage_Ptr;
+            controlMessage_Ptr = CMSG_NXTHDR(&message, controlMessage_Ptr))
+        {
+            if((SOL_SOCKET == controlMessage_Ptr->cmsg_level)
+               && (SCM_RIGHTS == controlMessage_Ptr->cmsg_type)
+               && (-1 == fileDescriptor))
+            {
+                memcpy(&receivedDescriptor, CMSG_DATA(controlMessage_Ptr), sizeof(receivedDescriptor));
+                fileDescriptor = receivedDescriptor;
+            }
+        }
+        receivedSize += (uint32) size;
+    }
+    close(clientSocket);
+    if(fileDescriptor < 0)
+    {
+        return (NULL);
+    }
+
+    header_Ptr = NULL;
+    if(sizeof(segmentSize) == receivedSize)
+    {
+        header_Ptr = flouka_sharedMemoryAttachDescriptor(fileDescriptor COMMA() FILE_AND_LINE_FOR_CALL());
+    }
+    close(fileDescriptor);
+
+    return (header_Ptr);
+}
+
+void flouka_sharedMemoryDetach(const flouka_sharedMemoryHeader_s* header_Ptr COMMA()
+                               FILE_AND_LINE_FOR_TYPE())
+{
+    ASSERT((NULL != header_Ptr),
+                    "FLOUKA:  Invalid shared memory pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+
+    munmap((void*) header_Ptr, header_Ptr->segmentSize);
+}
+
+uint32 flouka_sharedMemoryReadCounters(const flouka_sharedMemoryHeader_s* header_Ptr,
+                                       uint32* counterValuesList_Ptr,
+                                       uint32 allocatedCountersCount COMMA() FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 changeSequence;
+    const uint8* segment_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the header_Ptr (not NULL).
+     * 2. Validate the counterValuesList_Ptr (not NULL).
+     * 3. Validate the allocated counters count (not less than the counters of the segment).
+     */
+    ASSERT((NULL != header_Ptr),
+                    "FLOUKA:  Invalid shared memory pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != counterValuesList_Ptr),
+                    "FLOUKA:  NULL was passed as the counters list pointer",
+                    fileName,
+                    lineNumber);
+    ASSERT((allocatedCountersCount >= header_Ptr->totalCountersCount),
+                    "FLOUKA: Counters list allocated is smaller than expected",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. If the segment is live, copy the counters area once and return zero, the updates do not
+     *    advance the change sequence, so the copy cannot be checked (every counter is exact, but
+     *    the counters are not consistent with each other).
+     * 2. Otherwise, copy the counters area, and retry if a publish started or ended meanwhile.
+     * 3. Return the change sequence of the copy.
+     */
+    segment_Ptr = (const uint8*) header_Ptr;
+    if(0 != header_Ptr->isLive)
+    {
+        memcpy(counterValuesList_Ptr,
+               segment_Ptr + header_Ptr->countersOffset,
+               header_Ptr->totalCountersCount * sizeof(*counterValuesList_Ptr));
+        return (0);
+    }
+
+    do
+    {
+        changeSequence = SharedMemory_beginRead(header_Ptr);
+        memcpy(counterValuesList_Ptr,
+               segment_Ptr + header_Ptr->countersOffset,
+               header_Ptr->totalCountersCount * sizeof(*counterValuesList_Ptr));
+    } while(FALSE == SharedMemory_endRead(header_Ptr, changeSequence));
+
+    return (changeSequence);
+}
+
+uint32 flouka_sharedMemoryReadInformation(const flouka_sharedMemoryHeader_s* header_Ptr,
+                                          uint8* informationBuffer_Ptr,
+                                          uint32 allocatedInfoBufferSize COMMA()
+                                          FILE_AND_LINE_FOR_TYPE())
+{
+    uint32 changeSequence;
+    uint32 informationSize;
+    const uint8* segment_Ptr;
+
+    /*
+     * Assertions done in this function:
+     * =================================
+     * 1. Validate the header_Ptr (not NULL).
+     * 2. Validate the informationBuffer_Ptr (not NULL).
+     */
+    ASSERT((NULL != header_Ptr),
+                    "FLOUKA:  Invalid shared memory pointer passed (NULL pointer passed)",
+                    fileName,
+                    lineNumber);
+    ASSERT((NULL != informationBuffer_Ptr),
+                    "FLOUKA:  NULL was passed as the information buffer pointer",
+                    fileName,
+                    lineNumber);
+
+    /*
+     * Steps done in this function:
+     * ============================
+     * 1. Copy the information (only if it fits in the given buffer), and retry if a publish
+     *    started or ended meanwhile.
+     * 2. Return the size of the information, zero if it is not published or it does not fit.
+     */
+    segment_Ptr = (const uint8*) header_Ptr;
+    do
+    {
+        changeSequence = SharedMemory_beginRead(header_Ptr);
+        informationSize = header_Ptr->informationSize;
+        if(informationSize > allocatedInfoBufferSize)
+        {
+            informationSize = 0;
+        }
+        memcpy(informationBuffer_Ptr, segment_Ptr + header_Ptr->informationOffset, informationSize);
+    } while(FALSE == SharedMemory_endRead(header_Ptr, changeSequence));
+
+    ASSERT((0 != informationSize) || (0 == header_Ptr->informationSize),
+                    "FLOUKA: Information buffer allocated is smaller than expected",
+                    fileName,
+                    lineNumber);
+
+    return (informationSize);
+}
@@ -0,0 +1,204 @@
+/***************************************************************************************************
+ *
+ * flouka - a library for embedded statistics collection.
+ *
+ * Copyright  2009  Mohamed Galal El-Din, Karim Emad Morsy.
+ *
+ ***************************************************************************************************
+ *
+ * This file is part of flouka library.
+ *
+ * flouka is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * Lesser General Public License as published by the Free Software Foundation, either version 3 of
+ * the License, or any later version.
+ *
+ * flouka is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along with flouka. If
+ * not, see <http://www.gnu.org/licenses/>.
+ *
+ ***************************************************************************************************
+ *
+ * For more information, questions, or inquiries please contact:
+ *
+ * Mohamed Galal El-Din:    mohamed.g.ebrahim@gmail.com
+ * Karim Emad Morsy:        karim.e.morsy@gmail.com
+ *
+ **************************************************************************************************/
+
+#ifndef FLOUKA_SHM_H_
+#define FLOUKA_SHM_H_
+
+/***************************************************************************************************
+ *
+ * The statistics collector object can export its counters and its serialized information to a
+ * named POSIX shared memory segment (see sharedMemoryName_Ptr of flouka_options_s), so that a
+ * collector process on the same host reads them without any copy or system call.
+ *
+ * The segment may also be anonymous (see isSharedMemoryAnonymous of flouka_options_s), nothing is
+ * then created on the file system, and the collector process gets the descriptor of the segment
+ * from the local socket of the statistics server (see flouka_sharedMemoryConnect).
+ *
+ * Segment layout (all the fields are in the host byte order and word size, like the statistics
+ * buffer, and every area starts at a cache line boundary):
+ *
+ *   flouka_sharedMemoryHeader_s      Described below.
+ *   uint32[totalCountersCount]       The counters, at countersOffset.
+ *   uint8[informationCapacity]       The serialized information (the same as the buffer filled by
+ *                                    flouka_getInformation), at informationOffset.
+ *
+ * When the counters are neither sharded, placed by hints, nor persisted, the counters area is the
+ * list of counters itself, and the readers see every update as soon as it is done (an update deferred by
+ * the thread that did it is seen when it is flushed). Otherwise the counters area is refreshed by
+ * flouka_publishSharedMemory.
+ *
+ * changeSequence is odd while flouka_publishSharedMemory is changing the segment, and it is
+ * advanced by two on every publish, a reader that reads the same even value before and after
+ * copying the counters or the information has a consistent copy, and retries otherwise.
+ *
+ * The updates of a live segment (isLive) do not advance changeSequence, so a copy of its counters
+ * has no consistency across the counters (every counter is exact, but an update of two counters
+ * may be seen in one of them only), only the information is guarded by changeSequence.
+ *
+ **************************************************************************************************/
+
+#include <flouka.h>
+
+/*Value of the magic field, it is written last when the segment is created*/
+#define FLOUKA_SHARED_MEMORY_MAGIC        (0x464C4B41LU)
+
+/*Value of the version field, it is changed whenever the layout of the segment is changed*/
+#define FLOUKA_SHARED_MEMORY_VERSION      (1)
+
+/***************************************************************************************************
+ * Structure Name:
+ * flouka_sharedMemoryHeader_s
+ *
+ * Structure Description:
+ * This structure is found at the start of the shared memory segment, it must only be read by the
+ * readers of the segment.
+ **************************************************************************************************/
+typedef struct flouka_sharedMemoryHeader
+{
+    /*Holds FLOUKA_SHARED_MEMORY_MAGIC once the segment is ready to be read*/
+    uint32 magic;
+    /*Holds FLOUKA_SHARED_MEMORY_VERSION*/
+    uint32 version;
+    /*Holds the size of this header in bytes*/
+    uint32 headerSize;
+    /*Holds the size of the whole segment in bytes*/
+    uint32 segmentSize;
+    /*Odd while the segment is being changed, advanced by two on every publish*/
+    uint32 changeSequence;
+    /*Holds the schema generation (see flouka_getSchemaGeneration) of the information area*/
+    uint32 schemaGeneration;
+    /*Holds the number of counters in the counters area*/
+    uint32 totalCountersCount;
+    /*Holds the offset of the counters area from the start of the segment*/
+    uint32 countersOffset;
+    /*Non-zero if the counters area is the list of counters itself (updated in place)*/
+    uint32 isLive;
+    /*Holds the offset of the information area from the start of the segment*/
+    uint32 informationOffset;
+    /*Holds the size of the information area in bytes*/
+    uint32 informationCapacity;
+    /*Holds the size of the information in bytes, zero until it is published (or if it does not
+      fit in the information area)*/
+    uint32 informationSize;
+} flouka_sharedMemoryHeader_s;
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryAttach
+ *
+ *  Arguments   : const char*   sharedMemoryName_Ptr
+ *
+ *  Description : This function maps the shared memory segment of the given name (read only), it
+ *                is called by the reader process.
+ *
+ *  Returns     : const flouka_sharedMemoryHeader_s* (NULL if the segment does not exist, is not
+ *                ready yet, or has a different version)
+ **************************************************************************************************/
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryAttach(const char* sharedMemoryName_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryAttachDescriptor
+ *
+ *  Arguments   : int32         fileDescriptor
+ *
+ *  Description : This function maps the shared memory segment of the given descriptor (read only),
+ *                the descriptor is not closed, and it may be closed once the segment is mapped.
+ *
+ *  Returns     : const flouka_sharedMemoryHeader_s* (NULL if the segment is not ready yet, or has
+ *                a different version)
+ **************************************************************************************************/
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryAttachDescriptor(int32 fileDescriptor COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryConnect
+ *
+ *  Arguments   : const char*   localSocketName_Ptr
+ *
+ *  Description : This function gets the shared memory segment from the local socket of the
+ *                statistics server (see flouka_serverListenLocal) and maps it (read only), it is
+ *                called by the reader process, the counters are then read without any system call.
+ *
+ *  Returns     : const flouka_sharedMemoryHeader_s* (NULL if the server cannot be reached, or the
+ *                segment is not exported, not ready yet, or has a different version)
+ **************************************************************************************************/
+const flouka_sharedMemoryHeader_s* flouka_sharedMemoryConnect(const char* localSocketName_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryDetach
+ *
+ *  Arguments   : const flouka_sharedMemoryHeader_s*    header_Ptr
+ *
+ *  Description : This function unmaps a segment mapped by flouka_sharedMemoryAttach.
+ *
+ *  Returns     : void
+ **************************************************************************************************/
+void flouka_sharedMemoryDetach(const flouka_sharedMemoryHeader_s* header_Ptr COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryReadCounters
+ *
+ *  Arguments   : const flouka_sharedMemoryHeader_s*    header_Ptr,
+ *                uint32*                               counterValuesList_Ptr,
+ *                uint32                                allocatedCountersCount
+ *
+ *  Description : This function copies the counters of the segment to the given list, the copy is
+ *                retried until it is not mixed with a publish.
+ *
+ *                If the segment is live, the counters are copied once while the updates go on, so
+ *                the copy is not consistent across the counters (see the segment layout above).
+ *
+ *  Returns     : uint32 (the change sequence of the copied counters, zero if the segment is live)
+ **************************************************************************************************/
+uint32 flouka_sharedMemoryReadCounters(const flouka_sharedMemoryHeader_s* header_Ptr,
+                                       uint32* counterValuesList_Ptr,
+                                       uint32 allocatedCountersCount COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+/***************************************************************************************************
+ *  Name        : flouka_sharedMemoryReadInformation
+ *
+ *  Arguments   : const flouka_sharedMemoryHeader_s*    header_Ptr,
+ *                uint8*                                informationBuffer_Ptr,
+ *                uint32                                allocatedInfoBufferSize
+ *
+ *  Description : This function copies the serialized information of the segment to the given
+ *                buffer, the copy is retried until it is not mixed with a publish.
+ *
+ *  Returns     : uint32 (the size of the information in bytes, zero if it is not published yet)
+ **************************************************************************************************/
+uint32 flouka_sharedMemoryReadInformation(const flouka_sharedMemoryHeader_s* header_Ptr,
+                                          uint8* informationBuffer_Ptr,
+                                          uint32 allocatedInfoBufferSize COMMA()
+                                                     FILE_AND_LINE_FOR_TYPE());
+
+#endif /* FLOUKA_SHM_H_ */
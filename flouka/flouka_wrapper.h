@@ -30,8 +30,35 @@
 #ifndef FLOUKA_WRAPPER_H_
 #define FLOUKA_WRAPPER_H_
 
+#include <flouka_delta.h>
+#include <flouka_metrics.h>
+#include <flouka_server.h>
+
 extern flouka_s* g_flouka_Ptr;
 
+/*
+ * The release build of the application may define FLOUKA_INLINE_FAST_PATH to update the counters
+ * without a function call (see flouka_inline.h).
+ */
+#if defined(FLOUKA_INLINE_FAST_PATH) && !defined(DEBUG)
+#include <flouka_inline.h>
+#define FLOUKA_INCREMENT_COUNTER_FUNCTION       flouka_inlineIncrementCounter
+#define FLOUKA_DECREMENT_COUNTER_FUNCTION       flouka_inlineDecrementCounter
+#define FLOUKA_INCREASE_COUNTER_FUNCTION        flouka_inlineIncreaseCounter
+#define FLOUKA_DECREASE_COUNTER_FUNCTION        flouka_inlineDecreaseCounter
+#define FLOUKA_SET_COUNTER_FUNCTION             flouka_inlineSetCounter
+#define FLOUKA_RESET_COUNTER_FUNCTION           flouka_inlineResetCounter
+#define FLOUKA_GET_COUNTER_FUNCTION             flouka_inlineGetCounter
+#else
+#define FLOUKA_INCREMENT_COUNTER_FUNCTION       flouka_incrementCounter
+#define FLOUKA_DECREMENT_COUNTER_FUNCTION       flouka_decrementCounter
+#define FLOUKA_INCREASE_COUNTER_FUNCTION        flouka_increaseCounter
+#define FLOUKA_DECREASE_COUNTER_FUNCTION        flouka_decreaseCounter
+#define FLOUKA_SET_COUNTER_FUNCTION             flouka_setCounter
+#define FLOUKA_RESET_COUNTER_FUNCTION           flouka_resetCounter
+#define FLOUKA_GET_COUNTER_FUNCTION             flouka_getCounter
+#endif /*FLOUKA_INLINE_FAST_PATH*/
+
 /**************************************************************************************************/
 #define FLOUKA_INIT(maxGroupsCount,                                                                \
                     maxSubGroupsCount,                                                             \
@@ -58,12 +85,48 @@ extern flouka_s* g_flouka_Ptr;
            __LINE__);                                                                              \
 }
 /**************************************************************************************************/
+#define FLOUKA_INIT_WITH_OPTIONS(maxGroupsCount,                                                   \
+                                 maxSubGroupsCount,                                                \
+                                 maxCountersCount,                                                 \
+                                 allocationFunction_Ptr,                                           \
+                                 deallocationFunction_Ptr,                                         \
+                                 lockFunction_Ptr,                                                 \
+                                 unlockFunction_Ptr,                                               \
+                                 options_Ptr)                                                      \
+{                                                                                                  \
+    flouka_status_e status;                                                                        \
+    status = flouka_initWithOptions(&(g_flouka_Ptr),                                               \
+                                    (maxGroupsCount),                                              \
+                                    (maxSubGroupsCount),                                           \
+                                    (maxCountersCount),                                            \
+                                    (allocationFunction_Ptr),                                      \
+                                    (deallocationFunction_Ptr),                                    \
+                                    (lockFunction_Ptr),                                            \
+                                    (unlockFunction_Ptr),                                          \
+                                    (options_Ptr) COMMA()                                          \
+                                    FILE_AND_LINE_FOR_REF());                                      \
+                                                                                                   \
+    ASSERT((FLOUKA_STATUS_SUCCESS == status),                                                      \
+           "FLOUKA: Failed to create the object object",                             \
+           __FILE__,                                                                               \
+           __LINE__);                                                                              \
+}
+/**************************************************************************************************/
 #define FLOUKA_DESTROY()                                                                           \
 {                                                                                                  \
     flouka_destroy((g_flouka_Ptr) COMMA()                                                          \
                     FILE_AND_LINE_FOR_REF());                                                      \
 }
 /**************************************************************************************************/
+#define FLOUKA_GROW(totalGroupsCount,                                                              \
+                    totalSubGroupsCount,                                                           \
+                    totalCountersCount)                                                            \
+    flouka_grow((g_flouka_Ptr),                                                                    \
+                (totalGroupsCount),                                                                \
+                (totalSubGroupsCount),                                                             \
+                (totalCountersCount) COMMA()                                                       \
+                FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
 #define FLOUKA_ASSIGN_GROUP(groupID,                                                               \
                             groupName_Ptr,                                                         \
                             groupDescription_Ptr)                                                  \
@@ -103,6 +166,135 @@ extern flouka_s* g_flouka_Ptr;
                          FILE_AND_LINE_FOR_REF());                                                 \
 }
 /**************************************************************************************************/
+#define FLOUKA_ASSIGN_COUNTER_WITH_PLACEMENT(counterID,                                            \
+                                             groupID,                                              \
+                                             unit_Ptr,                                             \
+                                             counterName_Ptr,                                      \
+                                             counterDescription_Ptr,                               \
+                                             placement,                                            \
+                                             ownerIndex)                                           \
+{                                                                                                  \
+    flouka_assignCounterWithPlacement((g_flouka_Ptr),                                              \
+                                      (counterID),                                                 \
+                                      (groupID),                                                   \
+                                      (unit_Ptr),                                                  \
+                                      (counterName_Ptr),                                           \
+                                      (counterDescription_Ptr),                                    \
+                                      (placement),                                                 \
+                                      (ownerIndex) COMMA()                                         \
+                                      FILE_AND_LINE_FOR_REF());                                    \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_SCHEMA(schema_Ptr)                                                           \
+{                                                                                                  \
+    flouka_assignSchema((g_flouka_Ptr),                                                            \
+                        (schema_Ptr) COMMA()                                                       \
+                        FILE_AND_LINE_FOR_REF());                                                  \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_GROUPS(groupList_Ptr,                                                        \
+                             groupsCount)                                                          \
+{                                                                                                  \
+    flouka_assignGroups((g_flouka_Ptr),                                                            \
+                        (groupList_Ptr),                                                           \
+                        (groupsCount) COMMA()                                                      \
+                        FILE_AND_LINE_FOR_REF());                                                  \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_SUB_GROUPS(subGroupList_Ptr,                                                 \
+                                 subGroupsCount)                                                   \
+{                                                                                                  \
+    flouka_assignSubGroups((g_flouka_Ptr),                                                         \
+                           (subGroupList_Ptr),                                                     \
+                           (subGroupsCount) COMMA()                                                \
+                           FILE_AND_LINE_FOR_REF());                                               \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_COUNTERS(counterList_Ptr,                                                    \
+                               countersCount)                                                      \
+{                                                                                                  \
+    flouka_assignCounters((g_flouka_Ptr),                                                          \
+                          (counterList_Ptr),                                                       \
+                          (countersCount) COMMA()                                                  \
+                          FILE_AND_LINE_FOR_REF());                                                \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_SPARSE_COUNTER(sparseID,                                                     \
+                                     groupID,                                                      \
+                                     unit_Ptr,                                                     \
+                                     counterName_Ptr,                                              \
+                                     counterDescription_Ptr,                                       \
+                                     counterID_Ptr)                                                \
+    flouka_assignSparseCounter((g_flouka_Ptr),                                                     \
+                               (sparseID),                                                         \
+                               (groupID),                                                          \
+                               (unit_Ptr),                                                         \
+                               (counterName_Ptr),                                                  \
+                               (counterDescription_Ptr),                                           \
+                               (counterID_Ptr) COMMA()                                             \
+                               FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_FREEZE_SPARSE_COUNTERS()                                                            \
+    flouka_freezeSparseCounters((g_flouka_Ptr) COMMA()                                             \
+                                FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_SPARSE_COUNTER_ID(sparseID)                                                         \
+    flouka_getSparseCounterID((g_flouka_Ptr),                                                      \
+                              (sparseID) COMMA()                                                   \
+                              FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_FAMILY(familyID,                                                             \
+                             groupID,                                                              \
+                             firstCounterID,                                                       \
+                             membersCount,                                                         \
+                             instancesCount,                                                       \
+                             familyName_Ptr,                                                       \
+                             familyDescription_Ptr)                                                \
+{                                                                                                  \
+    flouka_assignFamily((g_flouka_Ptr),                                                            \
+                        (familyID),                                                                \
+                        (groupID),                                                                 \
+                        (firstCounterID),                                                          \
+                        (membersCount),                                                            \
+                        (instancesCount),                                                          \
+                        (familyName_Ptr),                                                          \
+                        (familyDescription_Ptr) COMMA()                                            \
+                        FILE_AND_LINE_FOR_REF());                                                  \
+}
+/**************************************************************************************************/
+#define FLOUKA_ASSIGN_FAMILY_MEMBER(familyID,                                                      \
+                                    memberIndex,                                                   \
+                                    unit_Ptr,                                                      \
+                                    counterName_Ptr,                                               \
+                                    counterDescription_Ptr)                                        \
+{                                                                                                  \
+    flouka_assignFamilyMember((g_flouka_Ptr),                                                      \
+                              (familyID),                                                          \
+                              (memberIndex),                                                       \
+                              (unit_Ptr),                                                          \
+                              (counterName_Ptr),                                                   \
+                              (counterDescription_Ptr) COMMA()                                     \
+                              FILE_AND_LINE_FOR_REF());                                            \
+}
+/**************************************************************************************************/
+#define FLOUKA_ADD_FAMILY_INSTANCE(familyID,                                                       \
+                                   label_Ptr,                                                      \
+                                   firstCounterID_Ptr)                                             \
+    flouka_addFamilyInstance((g_flouka_Ptr),                                                       \
+                             (familyID),                                                           \
+                             (label_Ptr),                                                          \
+                             (firstCounterID_Ptr) COMMA()                                          \
+                             FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_REMOVE_FAMILY_INSTANCE(familyID,                                                    \
+                                      firstCounterID)                                              \
+{                                                                                                  \
+    flouka_removeFamilyInstance((g_flouka_Ptr),                                                    \
+                                (familyID),                                                        \
+                                (firstCounterID) COMMA()                                           \
+                                FILE_AND_LINE_FOR_REF());                                          \
+}
+/**************************************************************************************************/
 #define FLOUKA_GET_INFORMATIOM_SIZE()                                                              \
         (LENGTH_HEADER_SIZE +                                                                      \
          flouka_getInformationSize((g_flouka_Ptr) COMMA()                                          \
@@ -117,6 +309,46 @@ extern flouka_s* g_flouka_Ptr;
                           FILE_AND_LINE_FOR_REF());                                                \
 }
 /**************************************************************************************************/
+#define FLOUKA_GET_INFORMATION_BUFFER(informationBufferPointer_Ptr,                                \
+                                      informationBufferSize_Ptr)                                   \
+{                                                                                                  \
+    flouka_getInformationBuffer((g_flouka_Ptr),                                                    \
+                                (informationBufferPointer_Ptr),                                    \
+                                (informationBufferSize_Ptr) COMMA()                                \
+                                FILE_AND_LINE_FOR_REF());                                          \
+}
+/**************************************************************************************************/
+#define FLOUKA_GET_INDEXED_INFORMATION(indexBufferPointer_Ptr,                                     \
+                                       indexBufferSize_Ptr)                                        \
+{                                                                                                  \
+    flouka_getIndexedInformation((g_flouka_Ptr),                                                   \
+                                 (indexBufferPointer_Ptr),                                         \
+                                 (indexBufferSize_Ptr) COMMA()                                     \
+                                 FILE_AND_LINE_FOR_REF());                                         \
+}
+/**************************************************************************************************/
+#define FLOUKA_GET_GROUP_COUNTERS(groupID,                                                         \
+                                  counterIDListPointer_Ptr,                                        \
+                                  countersCount_Ptr)                                               \
+    flouka_getGroupCounters((g_flouka_Ptr),                                                        \
+                            (groupID),                                                             \
+                            (counterIDListPointer_Ptr),                                            \
+                            (countersCount_Ptr) COMMA()                                            \
+                            FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_GET_SUB_GROUP_COUNTERS(subgroupID,                                                  \
+                                      counterIDListPointer_Ptr,                                    \
+                                      countersCount_Ptr)                                           \
+    flouka_getSubGroupCounters((g_flouka_Ptr),                                                     \
+                               (subgroupID),                                                       \
+                               (counterIDListPointer_Ptr),                                         \
+                               (countersCount_Ptr) COMMA()                                         \
+                               FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_GET_SCHEMA_GENERATION()                                                             \
+    flouka_getSchemaGeneration((g_flouka_Ptr) COMMA()                                              \
+                               FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
 #define FLOUKA_GET_STATISTICS(statisticsBufferPointer_Ptr,                                         \
                               statisticsBufferSize_Ptr)                                            \
 {                                                                                                  \
@@ -126,60 +358,249 @@ extern flouka_s* g_flouka_Ptr;
                          FILE_AND_LINE_FOR_REF());                                                 \
 }
 /**************************************************************************************************/
+#define FLOUKA_GET_SNAPSHOT(statisticsBufferPointer_Ptr,                                           \
+                            statisticsBufferSize_Ptr,                                              \
+                            snapshotInfo_Ptr)                                                      \
+{                                                                                                  \
+    flouka_getSnapshot((g_flouka_Ptr),                                                             \
+                       (statisticsBufferPointer_Ptr),                                              \
+                       (statisticsBufferSize_Ptr),                                                 \
+                       (snapshotInfo_Ptr) COMMA()                                                  \
+                       FILE_AND_LINE_FOR_REF());                                                   \
+}
+/**************************************************************************************************/
+#define FLOUKA_COPY_SNAPSHOT(statisticsBuffer_Ptr,                                                 \
+                             allocatedStatisticsBufferSize,                                        \
+                             snapshotInfo_Ptr)                                                     \
+{                                                                                                  \
+    flouka_copySnapshot((g_flouka_Ptr),                                                            \
+                        (statisticsBuffer_Ptr),                                                    \
+                        (allocatedStatisticsBufferSize),                                           \
+                        (snapshotInfo_Ptr) COMMA()                                                 \
+                        FILE_AND_LINE_FOR_REF());                                                  \
+}
+/**************************************************************************************************/
 #define FLOUKA_INCREMENT_COUNTER(counterID)                                                        \
 {                                                                                                  \
-    flouka_incrementCounter((g_flouka_Ptr),                                                        \
-                            (counterID) COMMA()                                                    \
-                            FILE_AND_LINE_FOR_REF());                                              \
+    FLOUKA_INCREMENT_COUNTER_FUNCTION((g_flouka_Ptr),                                              \
+                                      (counterID) COMMA()                                          \
+                                      FILE_AND_LINE_FOR_REF());                                    \
 }
 /**************************************************************************************************/
 #define FLOUKA_DECREMENT_COUNTER(counterID)                                                        \
 {                                                                                                  \
-    flouka_decrementCounter((g_flouka_Ptr),                                                        \
-                            (counterID) COMMA()                                                    \
-                            FILE_AND_LINE_FOR_REF());                                              \
+    FLOUKA_DECREMENT_COUNTER_FUNCTION((g_flouka_Ptr),                                              \
+                                      (counterID) COMMA()                                          \
+                                      FILE_AND_LINE_FOR_REF());                                    \
 }
 /**************************************************************************************************/
 #define FLOUKA_INCREASE_COUNTER(counterID,                                                         \
                               delta)                                                               \
 {                                                                                                  \
-    flouka_increaseCounter((g_flouka_Ptr),                                                         \
-                         (counterID),                                                              \
-                         (delta) COMMA()                                                           \
-                         FILE_AND_LINE_FOR_REF());                                                 \
+    FLOUKA_INCREASE_COUNTER_FUNCTION((g_flouka_Ptr),                                               \
+                                   (counterID),                                                    \
+                                   (delta) COMMA()                                                 \
+                                   FILE_AND_LINE_FOR_REF());                                       \
 }
 /**************************************************************************************************/
 #define FLOUKA_DECREASE_COUNTER(counterID,                                                         \
                               delta)                                                               \
 {                                                                                                  \
-    flouka_decreaseCounter((g_flouka_Ptr),                                                         \
-                         (counterID),                                                              \
-                         (delta) COMMA()                                                           \
-                         FILE_AND_LINE_FOR_REF());                                                 \
+    FLOUKA_DECREASE_COUNTER_FUNCTION((g_flouka_Ptr),                                               \
+                                   (counterID),                                                    \
+                                   (delta) COMMA()                                                 \
+                                   FILE_AND_LINE_FOR_REF());                                       \
 }
 /**************************************************************************************************/
 #define FLOUKA_SET_COUNTER(counterID,                                                              \
                            value)                                                                  \
 {                                                                                                  \
-    flouka_setCounter((g_flouka_Ptr),                                                              \
-                      (counterID),                                                                 \
-                      (value) COMMA()                                                              \
-                      FILE_AND_LINE_FOR_REF());                                                    \
+    FLOUKA_SET_COUNTER_FUNCTION((g_flouka_Ptr),                                                    \
+                                (counterID),                                                       \
+                                (value) COMMA()                                                    \
+                                FILE_AND_LINE_FOR_REF());                                          \
 }
 /**************************************************************************************************/
 #define FLOUKA_RESET_COUNTER(counterID,                                                            \
                              value)                                                                \
 {                                                                                                  \
-    flouka_resetCounter((g_flouka_Ptr),                                                            \
-                        (counterID),                                                               \
-                        (value) COMMA()                                                            \
-                        FILE_AND_LINE_FOR_REF());                                                  \
+    FLOUKA_RESET_COUNTER_FUNCTION((g_flouka_Ptr),                                                  \
+                                  (counterID),                                                     \
+                                  (value) COMMA()                                                  \
+                                  FILE_AND_LINE_FOR_REF());                                        \
 }
 /**************************************************************************************************/
 #define FLOUKA_GET_COUNTER(counterID)                                                              \
-    flouka_getCounter((g_flouka_Ptr),                                                              \
-                      (counterID) COMMA()                                                          \
-                      FILE_AND_LINE_FOR_REF());
+    FLOUKA_GET_COUNTER_FUNCTION((g_flouka_Ptr),                                                    \
+                                (counterID) COMMA()                                                \
+                                FILE_AND_LINE_FOR_REF());
+/**************************************************************************************************/
+#define FLOUKA_READ_AND_RESET_COUNTER(counterID)                                                   \
+    flouka_readAndResetCounter((g_flouka_Ptr),                                                     \
+                               (counterID) COMMA()                                                 \
+                               FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_APPLY_DELTAS(counterIDList_Ptr,                                                     \
+                            deltaList_Ptr,                                                         \
+                            deltasCount)                                                           \
+{                                                                                                  \
+    flouka_applyDeltas((g_flouka_Ptr),                                                             \
+                       (counterIDList_Ptr),                                                        \
+                       (deltaList_Ptr),                                                            \
+                       (deltasCount) COMMA()                                                       \
+                       FILE_AND_LINE_FOR_REF());                                                   \
+}
+/**************************************************************************************************/
+#define FLOUKA_APPLY_DENSE_DELTAS(firstCounterID,                                                  \
+                                  deltaList_Ptr,                                                   \
+                                  deltasCount)                                                     \
+{                                                                                                  \
+    flouka_applyDenseDeltas((g_flouka_Ptr),                                                        \
+                            (firstCounterID),                                                      \
+                            (deltaList_Ptr),                                                       \
+                            (deltasCount) COMMA()                                                  \
+                            FILE_AND_LINE_FOR_REF());                                              \
+}
+/**************************************************************************************************/
+#define FLOUKA_FLUSH()                                                                             \
+{                                                                                                  \
+    flouka_flush((g_flouka_Ptr) COMMA()                                                            \
+                 FILE_AND_LINE_FOR_REF());                                                         \
+}
+/**************************************************************************************************/
+#define FLOUKA_PUBLISH_SHARED_MEMORY()                                                             \
+{                                                                                                  \
+    flouka_publishSharedMemory((g_flouka_Ptr) COMMA()                                              \
+                               FILE_AND_LINE_FOR_REF());                                           \
+}
+/**************************************************************************************************/
+#define FLOUKA_GET_SHARED_MEMORY_DESCRIPTOR()                                                      \
+    flouka_getSharedMemoryDescriptor((g_flouka_Ptr) COMMA()                                        \
+                                     FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_SYNC_PERSISTENT_COUNTERS()                                                          \
+    flouka_syncPersistentCounters((g_flouka_Ptr) COMMA()                                           \
+                                  FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_GET_NODES_COUNT()                                                                   \
+    flouka_getNodesCount((g_flouka_Ptr) COMMA()                                                    \
+                         FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_GET_NODE_UPDATES(nodeIndex)                                                         \
+    flouka_getNodeUpdates((g_flouka_Ptr),                                                          \
+                          (nodeIndex) COMMA()                                                      \
+                          FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_DELTA_ENCODER_INIT(deltaEncoder_Pointer_Ptr,                                        \
+                                  allocationFunction_Ptr,                                          \
+                                  deallocationFunction_Ptr)                                        \
+{                                                                                                  \
+    flouka_status_e status;                                                                        \
+    status = flouka_deltaEncoderInit((deltaEncoder_Pointer_Ptr),                                   \
+                                     (g_flouka_Ptr),                                               \
+                                     (allocationFunction_Ptr),                                     \
+                                     (deallocationFunction_Ptr) COMMA()                            \
+                                     FILE_AND_LINE_FOR_REF());                                     \
+                                                                                                   \
+    ASSERT((FLOUKA_STATUS_SUCCESS == status),                                                      \
+           "FLOUKA: Failed to create the delta encoder object",                                    \
+           __FILE__,                                                                               \
+           __LINE__);                                                                              \
+}
+/**************************************************************************************************/
+#define FLOUKA_DELTA_ENCODER_DESTROY(deltaEncoder_Ptr)                                             \
+{                                                                                                  \
+    flouka_deltaEncoderDestroy((deltaEncoder_Ptr) COMMA()                                          \
+                               FILE_AND_LINE_FOR_REF());                                           \
+}
+/**************************************************************************************************/
+#define FLOUKA_DELTA_ENCODER_GET_MAXIMUM_SIZE(deltaEncoder_Ptr)                                    \
+    flouka_deltaEncoderGetMaximumSize((deltaEncoder_Ptr) COMMA()                                   \
+                                      FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_DELTA_ENCODER_RESYNCHRONIZE(deltaEncoder_Ptr)                                       \
+{                                                                                                  \
+    flouka_deltaEncoderResynchronize((deltaEncoder_Ptr) COMMA()                                    \
+                                     FILE_AND_LINE_FOR_REF());                                     \
+}
+/**************************************************************************************************/
+#define FLOUKA_DELTA_ENCODER_ENCODE(deltaEncoder_Ptr,                                              \
+                                    messageBuffer_Ptr,                                             \
+                                    allocatedMessageBufferSize)                                    \
+    flouka_deltaEncoderEncode((deltaEncoder_Ptr),                                                  \
+                              (messageBuffer_Ptr),                                                 \
+                              (allocatedMessageBufferSize) COMMA()                                 \
+                              FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_METRICS_EXPORTER_INIT(metricsExporter_Pointer_Ptr,                                  \
+                                     allocationFunction_Ptr,                                       \
+                                     deallocationFunction_Ptr)                                     \
+{                                                                                                  \
+    flouka_status_e status;                                                                        \
+    status = flouka_metricsExporterInit((metricsExporter_Pointer_Ptr),                             \
+                                        (g_flouka_Ptr),                                            \
+                                        (allocationFunction_Ptr),                                  \
+                                        (deallocationFunction_Ptr) COMMA()                         \
+                                        FILE_AND_LINE_FOR_REF());                                  \
+                                                                                                   \
+    ASSERT((FLOUKA_STATUS_SUCCESS == status),                                                      \
+           "FLOUKA: Failed to create the metrics exporter object",                                 \
+           __FILE__,                                                                               \
+           __LINE__);                                                                              \
+}
+/**************************************************************************************************/
+#define FLOUKA_METRICS_EXPORTER_DESTROY(metricsExporter_Ptr)                                       \
+{                                                                                                  \
+    flouka_metricsExporterDestroy((metricsExporter_Ptr) COMMA()                                    \
+                                  FILE_AND_LINE_FOR_REF());                                        \
+}
+/**************************************************************************************************/
+#define FLOUKA_METRICS_EXPORTER_RENDER(metricsExporter_Ptr,                                        \
+                                       textBufferPointer_Ptr,                                      \
+                                       textBufferSize_Ptr)                                         \
+{                                                                                                  \
+    flouka_metricsExporterRender((metricsExporter_Ptr),                                            \
+                                 (textBufferPointer_Ptr),                                          \
+                                 (textBufferSize_Ptr) COMMA()                                      \
+                                 FILE_AND_LINE_FOR_REF());                                         \
+}
+/**************************************************************************************************/
+#define FLOUKA_SERVER_INIT(server_Pointer_Ptr,                                                     \
+                           listenPort,                                                             \
+                           maximumClientsCount,                                                    \
+                           allocationFunction_Ptr,                                                 \
+                           deallocationFunction_Ptr)                                               \
+    flouka_serverInit((server_Pointer_Ptr),                                                        \
+                      (g_flouka_Ptr),                                                              \
+                      (listenPort),                                                                \
+                      (maximumClientsCount),                                                       \
+                      (allocationFunction_Ptr),                                                    \
+                      (deallocationFunction_Ptr) COMMA()                                           \
+                      FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_SERVER_LISTEN_LOCAL(server_Ptr,                                                     \
+                                   localSocketName_Ptr)                                            \
+    flouka_serverListenLocal((server_Ptr),                                                         \
+                             (localSocketName_Ptr) COMMA()                                         \
+                             FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_SERVER_LISTEN_HTTP(server_Ptr,                                                      \
+                                  httpPort)                                                        \
+    flouka_serverListenHttp((server_Ptr),                                                          \
+                            (httpPort) COMMA()                                                     \
+                            FILE_AND_LINE_FOR_REF())
+/**************************************************************************************************/
+#define FLOUKA_SERVER_DESTROY(server_Ptr)                                                          \
+{                                                                                                  \
+    flouka_serverDestroy((server_Ptr) COMMA()                                                      \
+                         FILE_AND_LINE_FOR_REF());                                                 \
+}
+/**************************************************************************************************/
+#define FLOUKA_SERVER_POLL(server_Ptr,                                                             \
+                           timeoutMilliseconds)                                                    \
+    flouka_serverPoll((server_Ptr),                                                                \
+                      (timeoutMilliseconds) COMMA()                                                \
+                      FILE_AND_LINE_FOR_REF())
 /**************************************************************************************************/
 
 #endif /* FLOUKA_WRAPPER_H_ */
@@ -31,11 +31,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
+#include <pthread.h>
 #include "flouka.h"
+#include "flouka_delta.h"
 #include "flouka_wrapper.h"
 
 
@@ -61,20 +59,92 @@ typedef enum CounterID
     COUNTER_ID_TRANSMISSION_BYTES_COUNT2 = 2,
     COUNTER_ID_TRANSMISSION_FAILURE2     = 3,
     COUNTER_ID_RECEPTION_BYTES_COUNT1    = 4,
-    COUNTER_ID_COUNT                     = 5
+    COUNTER_ID_RX_CONNECTIONS_FIRST      = 5,
+    COUNTER_ID_COUNT                     = 13
 
 }CounterID_e;
 
+typedef enum FamilyID
+{
+    FAMILY_ID_RX_CONNECTIONS = 0,
+    FAMILY_ID_COUNT          = 1
+}FamilyID_e;
+
+typedef enum RxConnectionMember
+{
+    RX_CONNECTION_MEMBER_BYTES_COUNT = 0,
+    RX_CONNECTION_MEMBER_FAILURE     = 1,
+    RX_CONNECTION_MEMBER_COUNT       = 2
+}RxConnectionMember_e;
+
+/*Maximum number of reception connections open at the same time*/
+#define RX_CONNECTIONS_COUNT 4
+
+/*Number of counters of the objects created by the checks, and the maximum they grow to*/
+#define TEST_COUNTERS_COUNT         8
+#define TEST_MAXIMUM_COUNTERS_COUNT 4096
+
+/*Number of threads updating the counters at the same time, and the updates done by each one*/
+#define TEST_THREADS_COUNT          6
+#define TEST_UPDATES_COUNT          100000
+
+/*Number of times the object is grown (and the delta message encoded) while it is updated*/
+#define TEST_GROW_STEPS_COUNT       6
+#define TEST_GROW_COUNTERS_COUNT    600
+
 void unlock();
 void lock();
 void* alloc(size_t size);
 
+uint32 test_check(bool isPassed, const char* checkName_Ptr);
+flouka_s* test_createObject(const flouka_options_s* options_Ptr);
+void* test_updateCounters(void* flouka_Ptr);
+uint32 test_concurrentUpdates(const char* modeName_Ptr, const flouka_options_s* options_Ptr);
+uint8 test_decodeMessage(const uint8* message_Ptr, uint32* valuesList_Ptr, uint32* countersCount_Ptr);
+uint32 test_deltaRoundTrip();
+uint32 test_growWhileServing();
 void test_flouka();
 
 flouka_s* g_flouka_Ptr = NULL;
 
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 int main()
 {
+    flouka_options_s options;
+    uint32 failuresCount = 0;
+
+    /*
+     * Check the counters of private objects first: every update done by several threads at the
+     * same time must be counted in every mode, the delta messages must decode to the counters,
+     * and growing must not disturb the updates nor the encoding of the messages.
+     */
+    flouka_getDefaultOptions(&options);
+    options.shardsCount = 4;
+    failuresCount += test_concurrentUpdates("sharded", &options);
+
+    flouka_getDefaultOptions(&options);
+    options.isAtomic = TRUE;
+    failuresCount += test_concurrentUpdates("atomic", &options);
+
+    flouka_getDefaultOptions(&options);
+    options.deferredSlotsCount = 4;
+    failuresCount += test_concurrentUpdates("deferred", &options);
+
+    flouka_getDefaultOptions(&options);
+    options.shardsCount = 2;
+    options.isSnapshotConsistent = TRUE;
+    failuresCount += test_concurrentUpdates("consistent snapshots", &options);
+
+    failuresCount += test_deltaRoundTrip();
+    failuresCount += test_growWhileServing();
+    if(0 != failuresCount)
+    {
+        printf("%u check(s) failed\n",
+               (unsigned int) failuresCount);
+        return 1;
+    }
+
     /*
      * Create the statistics counter.
      */
@@ -149,6 +219,30 @@ int main()
                           "# Bytes received",
                           "This counter represents the number of bytes received");
 
+    /*
+     * Assign the family(s), the members are described once, and every connection opened at run
+     * time is an instance of the family, labeled by the connection name.
+     */
+    FLOUKA_ASSIGN_FAMILY((uint32) FAMILY_ID_RX_CONNECTIONS,
+                         (uint32) GROUP_ID_RECEPTION,
+                         (uint32) COUNTER_ID_RX_CONNECTIONS_FIRST,
+                         (uint32) RX_CONNECTION_MEMBER_COUNT,
+                         (uint32) RX_CONNECTIONS_COUNT,
+                         "Reception connections",
+                         "This family collects the counters of every open reception connection");
+
+    FLOUKA_ASSIGN_FAMILY_MEMBER((uint32) FAMILY_ID_RX_CONNECTIONS,
+                                (uint32) RX_CONNECTION_MEMBER_BYTES_COUNT,
+                                "Byte(s)",
+                                "# Connection bytes received",
+                                "This counter represents the number of bytes received by the connection");
+
+    FLOUKA_ASSIGN_FAMILY_MEMBER((uint32) FAMILY_ID_RX_CONNECTIONS,
+                                (uint32) RX_CONNECTION_MEMBER_FAILURE,
+                                "RX Failure(s)",
+                                "# Connection reception failure",
+                                "This counter represents the number of reception failures of the connection");
+
 
 
     test_flouka();
@@ -159,23 +253,15 @@ int main()
 void lock()
 {
     /*
-     * The test assumes counters/groups assignment occur from the same thread, and that's why this
-     * function has no implementation. But if this is not the case, then this function shall call
-     * the appropriate locking function for example:
-     *
-     * pthread_mutex_lock()
+     * The checks grow the objects and read the counters while other threads update them, so the
+     * lock of the objects is a real mutex.
      */
+    pthread_mutex_lock(&g_mutex);
 }
 
 void unlock()
 {
-    /*
-     * The test assumes counters/groups assignment occur from the same thread, and that's why this
-     * function has no implementation. But if this is not the case, then this function shall call
-     * the appropriate locking function for example:
-     *
-     * pthread_mutex_unlock()
-     */
+    pthread_mutex_unlock(&g_mutex);
 }
 
 void* alloc(size_t size)
@@ -186,149 +272,450 @@ void* alloc(size_t size)
     return memset(malloc(size), 0, size);
 }
 
-void test_flouka()
+uint32 test_check(bool isPassed, const char* checkName_Ptr)
 {
-    int32_t             listenSocket;
-    int32_t             connectSocket;
-    socklen_t           clientAddressLength;
-    struct  sockaddr_in clientAddress;
-    struct  sockaddr_in serverAddress;
-    uint8             request;
-    uint8*            informationBuffer_Ptr;
-    uint32            informationBufferSize;
-    uint8*            statisticsBuffer_Ptr;
-    uint32            statisticsBufferSize;
-    int32_t             status;
-    uint16            listenPort;
+    /*
+     * Print the result of the check, and return the number of failures (0 or 1).
+     */
+    printf("%s: %s\n",
+           (TRUE == isPassed) ? "PASSED" : "FAILED",
+           checkName_Ptr);
 
-    listenPort = 4444;
+    return ((TRUE == isPassed) ? 0 : 1);
+}
 
-    listenSocket = socket(AF_INET,
-                          SOCK_STREAM,
-                          0);
+flouka_s* test_createObject(const flouka_options_s* options_Ptr)
+{
+    flouka_s* flouka_Ptr = NULL;
+    uint32 i;
 
-    serverAddress.sin_family        = AF_INET;
-    serverAddress.sin_addr.s_addr   = htonl(INADDR_ANY);
-    serverAddress.sin_port          = htons(listenPort);
+    /*
+     * Create an object of one group, one sub group and TEST_COUNTERS_COUNT counters.
+     */
+    if(FLOUKA_STATUS_SUCCESS != flouka_initWithOptions(&flouka_Ptr,
+                                                       1,
+                                                       1,
+                                                       TEST_COUNTERS_COUNT,
+                                                       alloc,
+                                                       free,
+                                                       lock,
+                                                       unlock,
+                                                       options_Ptr COMMA()
+                                                       FILE_AND_LINE_FOR_REF()))
+    {
+        return (NULL);
+    }
 
-    bind(listenSocket,
-         (struct sockaddr *) &serverAddress,
-         sizeof(serverAddress));
+    flouka_assignGroup(flouka_Ptr, 0, "Test", "Counters of the checks" COMMA() FILE_AND_LINE_FOR_REF());
+    flouka_assignSubGroup(flouka_Ptr, 0, 0, "Test", "Counters of the checks" COMMA() FILE_AND_LINE_FOR_REF());
+    for(i = 0; i < TEST_COUNTERS_COUNT; i++)
+    {
+        flouka_assignCounter(flouka_Ptr,
+                             i,
+                             0,
+                             "Update(s)",
+                             "# Updates",
+                             "This counter represents the number of updates" COMMA()
+                             FILE_AND_LINE_FOR_REF());
+    }
 
-    listen(listenSocket,
-           1);
+    return (flouka_Ptr);
+}
 
-    clientAddressLength = sizeof(clientAddress);
+void* test_updateCounters(void* flouka_Ptr)
+{
+    static const uint32 counterIDList[2] = {2, 3};
+    static const uint32 deltaList[2] = {1, 3};
+    static const uint32 denseDeltaList[2] = {1, 1};
+    uint32 i;
 
-    printf("Waiting for client to connect on port (%d)...\n",
-           listenPort);
+    /*
+     * Every update adds (per iteration) 1, 2, 1, 3, 1, 1, 2 and 0 to the counters 0 to 7, one by
+     * one, by a batch of counter IDs, and by a range of counters.
+     */
+    for(i = 0; i < TEST_UPDATES_COUNT; i++)
+    {
+        flouka_incrementCounter((flouka_s*) flouka_Ptr, 0 COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_increaseCounter((flouka_s*) flouka_Ptr, 1, 2 COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_applyDeltas((flouka_s*) flouka_Ptr, counterIDList, deltaList, 2 COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_applyDenseDeltas((flouka_s*) flouka_Ptr, 4, denseDeltaList, 2 COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_increaseCounter((flouka_s*) flouka_Ptr, 6, 3 COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_decrementCounter((flouka_s*) flouka_Ptr, 6 COMMA() FILE_AND_LINE_FOR_REF());
+        if(0 == (i % 1000))
+        {
+            flouka_flush((flouka_s*) flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+        }
+    }
 
-    connectSocket = accept(listenSocket,
-                           (struct sockaddr *) &clientAddress,
-                           &clientAddressLength);
+    return (NULL);
+}
 
-    printf("Client connected.\n");
+uint32 test_concurrentUpdates(const char* modeName_Ptr, const flouka_options_s* options_Ptr)
+{
+    static const uint32 expectedList[TEST_COUNTERS_COUNT] = {1, 2, 1, 3, 1, 1, 2, 0};
+    flouka_s* flouka_Ptr;
+    pthread_t threadList[TEST_THREADS_COUNT];
+    uint32 threadsCount;
+    uint8* statisticsBuffer_Ptr;
+    uint32 statisticsBufferSize;
+    bool isPassed;
+    uint32 i;
 
+    /*
+     * Update the counters from several threads (more threads than shards), while the statistics
+     * and the snapshots are taken, then check that no update is lost.
+     */
+    flouka_Ptr = test_createObject(options_Ptr);
+    if(NULL == flouka_Ptr)
+    {
+        return (test_check(FALSE, modeName_Ptr));
+    }
 
-    status = recv(connectSocket,
-                  &request,
-                  sizeof(request),
-                  0);
+    for(threadsCount = 0; threadsCount < TEST_THREADS_COUNT; threadsCount++)
+    {
+        if(0 != pthread_create(&threadList[threadsCount], NULL, test_updateCounters, flouka_Ptr))
+        {
+            break;
+        }
+    }
+    for(i = 0; i < 100; i++)
+    {
+        flouka_getStatistics(flouka_Ptr, &statisticsBuffer_Ptr, &statisticsBufferSize COMMA() FILE_AND_LINE_FOR_REF());
+        flouka_getSnapshot(flouka_Ptr, &statisticsBuffer_Ptr, &statisticsBufferSize, NULL COMMA() FILE_AND_LINE_FOR_REF());
+    }
+    for(i = 0; i < threadsCount; i++)
+    {
+        pthread_join(threadList[i], NULL);
+    }
 
-    if(status < 0)
+    isPassed = (TEST_THREADS_COUNT == threadsCount);
+    flouka_getStatistics(flouka_Ptr, &statisticsBuffer_Ptr, &statisticsBufferSize COMMA() FILE_AND_LINE_FOR_REF());
+    for(i = 0; i < TEST_COUNTERS_COUNT; i++)
     {
-        printf("Client disconnected, server is going to shutdown\n");
-        return;
+        if((expectedList[i] * TEST_THREADS_COUNT * TEST_UPDATES_COUNT
+            != flouka_getCounter(flouka_Ptr, i COMMA() FILE_AND_LINE_FOR_REF()))
+           || (expectedList[i] * TEST_THREADS_COUNT * TEST_UPDATES_COUNT != ((uint32*) statisticsBuffer_Ptr)[i]))
+        {
+            isPassed = FALSE;
+        }
     }
-    switch(request)
+
+    flouka_destroy(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    return (test_check(isPassed, modeName_Ptr));
+}
+
+uint8 test_decodeMessage(const uint8* message_Ptr, uint32* valuesList_Ptr, uint32* countersCount_Ptr)
+{
+    uint32 messageSize;
+    uint8 messageType;
+    const uint8* bitmap_Ptr;
+    const uint8* varint_Ptr;
+    uint32 zigzag;
+    uint32 shift;
+    uint32 i;
+
+    /*
+     * Decode the message the way a client does (see flouka_delta.h), a full message gives the
+     * number of counters, a delta message adds the differences to the values of the client.
+     */
+    memcpy(&messageSize, message_Ptr, sizeof(messageSize));
+    messageType = message_Ptr[2 * sizeof(uint32)];
+    message_Ptr += (2 * sizeof(uint32)) + sizeof(uint8);
+    if(FLOUKA_DELTA_MESSAGE_TYPE_FULL == messageType)
     {
-        case 0:
-            printf("Termination requested\n");
-            return;
-        case 1:
-            printf("Information requested\n");
-            informationBufferSize = FLOUKA_GET_INFORMATIOM_SIZE();
-            informationBuffer_Ptr = (uint8*) malloc(informationBufferSize);
+        *countersCount_Ptr = (messageSize - (2 * sizeof(uint32)) - sizeof(uint8)) / sizeof(uint32);
+        memcpy(valuesList_Ptr, message_Ptr, *countersCount_Ptr * sizeof(uint32));
+        return (messageType);
+    }
 
+    bitmap_Ptr = message_Ptr;
+    varint_Ptr = bitmap_Ptr + ((*countersCount_Ptr + 7) / 8);
+    for(i = 0; i < *countersCount_Ptr; i++)
+    {
+        if(0 != (bitmap_Ptr[i / 8] & (1 << (i % 8))))
+        {
+            zigzag = 0;
+            shift = 0;
+            do
+            {
+                zigzag |= (uint32) (*varint_Ptr & 0x7F) << shift;
+                shift += 7;
+            } while(0 != (*varint_Ptr++ & 0x80));
+            valuesList_Ptr[i] += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        }
+    }
 
-            FLOUKA_GET_INFORMATION(informationBuffer_Ptr,
-                                   informationBufferSize);
+    return (messageType);
+}
 
-            send(connectSocket,
-                 informationBuffer_Ptr,
-                 informationBufferSize,
-                 0);
+uint32 test_deltaRoundTrip()
+{
+    static const uint8 expectedTypeList[4] = {FLOUKA_DELTA_MESSAGE_TYPE_FULL,
+                                              FLOUKA_DELTA_MESSAGE_TYPE_DELTA,
+                                              FLOUKA_DELTA_MESSAGE_TYPE_DELTA,
+                                              FLOUKA_DELTA_MESSAGE_TYPE_DELTA};
+    flouka_options_s options;
+    flouka_s* flouka_Ptr;
+    flouka_deltaEncoder_s* deltaEncoder_Ptr = NULL;
+    uint8* message_Ptr;
+    uint32 messageBufferSize;
+    uint32 valuesList[TEST_COUNTERS_COUNT];
+    uint32 countersCount = 0;
+    uint8 messageType;
+    bool isPassed = TRUE;
+    uint32 round;
+    uint32 i;
 
-            printf("(%lu) bytes of statistics setup information sent.\n",
-                   (unsigned long)informationBufferSize);
+    /*
+     * Encode a message after every round of updates (none, small and big differences, decreases,
+     * and all the counters changed), and check that the client decodes the counters, the last
+     * message is a full one where the varints of the differences are longer than the counters
+     * (when the counters are 32 bits), either type must decode.
+     */
+    flouka_getDefaultOptions(&options);
+    flouka_Ptr = test_createObject(&options);
+    if(NULL == flouka_Ptr)
+    {
+        return (test_check(FALSE, "delta round trip"));
+    }
+    if(FLOUKA_STATUS_SUCCESS != flouka_deltaEncoderInit(&deltaEncoder_Ptr,
+                                                        flouka_Ptr,
+                                                        alloc,
+                                                        free COMMA()
+                                                        FILE_AND_LINE_FOR_REF()))
+    {
+        flouka_destroy(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+        return (test_check(FALSE, "delta round trip"));
+    }
+    messageBufferSize = flouka_deltaEncoderGetMaximumSize(deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    message_Ptr = (uint8*) alloc(messageBufferSize);
 
-            free(informationBuffer_Ptr);
-            break;
-        case 2:
-            ASSERT(FALSE,
-                   "TEST FLOUKA: Client is expected to request the information first",
-                   __FILE__,
-                   __LINE__);
-            break;
-        default:
-            ASSERT(FALSE,
-                   "TEST FLOUKA: Invalid request received!!!",
-                   __FILE__,
-                   __LINE__);
+    for(round = 0; round < 5; round++)
+    {
+        if(2 == round)
+        {
+            flouka_incrementCounter(flouka_Ptr, 1 COMMA() FILE_AND_LINE_FOR_REF());
+            flouka_increaseCounter(flouka_Ptr, 5, 1000000 COMMA() FILE_AND_LINE_FOR_REF());
+        }
+        if(3 == round)
+        {
+            flouka_decreaseCounter(flouka_Ptr, 5, 999999 COMMA() FILE_AND_LINE_FOR_REF());
+            flouka_setCounter(flouka_Ptr, 7, 0x7FFFFFF0 COMMA() FILE_AND_LINE_FOR_REF());
+        }
+        if(4 == round)
+        {
+            for(i = 0; i < TEST_COUNTERS_COUNT; i++)
+            {
+                flouka_increaseCounter(flouka_Ptr, i, 0x10000000 COMMA() FILE_AND_LINE_FOR_REF());
+            }
+        }
 
+        if(0 == flouka_deltaEncoderEncode(deltaEncoder_Ptr, message_Ptr, messageBufferSize COMMA() FILE_AND_LINE_FOR_REF()))
+        {
+            isPassed = FALSE;
             break;
+        }
+        messageType = test_decodeMessage(message_Ptr, valuesList, &countersCount);
+        if((round < 4) && (expectedTypeList[round] != messageType))
+        {
+            isPassed = FALSE;
+        }
+        for(i = 0; i < TEST_COUNTERS_COUNT; i++)
+        {
+            if(valuesList[i] != flouka_getCounter(flouka_Ptr, i COMMA() FILE_AND_LINE_FOR_REF()))
+            {
+                isPassed = FALSE;
+            }
+        }
     }
 
+    free(message_Ptr);
+    flouka_deltaEncoderDestroy(deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    flouka_destroy(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    return (test_check(isPassed && (TEST_COUNTERS_COUNT == countersCount), "delta round trip"));
+}
 
-    FLOUKA_GET_STATISTICS(&statisticsBuffer_Ptr,
-                          &statisticsBufferSize);
+uint32 test_growWhileServing()
+{
+    flouka_options_s options;
+    flouka_s* flouka_Ptr;
+    flouka_deltaEncoder_s* deltaEncoder_Ptr = NULL;
+    pthread_t thread;
+    uint8* message_Ptr = NULL;
+    uint32 messageBufferSize = 0;
+    uint32* valuesList_Ptr;
+    uint8* snapshot_Ptr;
+    uint32 countersCount = 0;
+    uint32 totalCountersCount;
+    bool isPassed;
+    uint32 step;
+    uint32 i;
 
-    while(0 != request)
+    /*
+     * Grow the object while its counters are updated by another thread, the new counters are
+     * assigned and updated, and a snapshot and a delta message are taken after every step, the
+     * client must follow the growth, and no update of the old counters may be lost.
+     */
+    flouka_getDefaultOptions(&options);
+    options.maximumCountersCount = TEST_MAXIMUM_COUNTERS_COUNT;
+    flouka_Ptr = test_createObject(&options);
+    if(NULL == flouka_Ptr)
     {
-        status = recv(connectSocket,
-                      &request,
-                      sizeof(request),
-                      0);
+        return (test_check(FALSE, "grow while serving"));
+    }
+    if(FLOUKA_STATUS_SUCCESS != flouka_deltaEncoderInit(&deltaEncoder_Ptr,
+                                                        flouka_Ptr,
+                                                        alloc,
+                                                        free COMMA()
+                                                        FILE_AND_LINE_FOR_REF()))
+    {
+        flouka_destroy(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+        return (test_check(FALSE, "grow while serving"));
+    }
+    valuesList_Ptr = (uint32*) alloc(TEST_MAXIMUM_COUNTERS_COUNT * sizeof(*valuesList_Ptr));
+    snapshot_Ptr = (uint8*) alloc(TEST_MAXIMUM_COUNTERS_COUNT * sizeof(uint32));
 
-        if(status < 0)
+    isPassed = (0 == pthread_create(&thread, NULL, test_updateCounters, flouka_Ptr));
+    totalCountersCount = TEST_COUNTERS_COUNT;
+    for(step = 0; (step < TEST_GROW_STEPS_COUNT) && (TRUE == isPassed); step++)
+    {
+        if(FLOUKA_STATUS_SUCCESS != flouka_grow(flouka_Ptr,
+                                                1,
+                                                1,
+                                                totalCountersCount + TEST_GROW_COUNTERS_COUNT COMMA()
+                                                FILE_AND_LINE_FOR_REF()))
         {
-            printf("Client disconnected, server is going to shutdown\n");
-            return;
+            isPassed = FALSE;
+            break;
         }
+        for(i = totalCountersCount; i < (totalCountersCount + TEST_GROW_COUNTERS_COUNT); i++)
+        {
+            flouka_assignCounter(flouka_Ptr,
+                                 i,
+                                 0,
+                                 "Update(s)",
+                                 "# Updates",
+                                 "This counter represents the number of updates" COMMA()
+                                 FILE_AND_LINE_FOR_REF());
+            flouka_increaseCounter(flouka_Ptr, i, i + step COMMA() FILE_AND_LINE_FOR_REF());
+        }
+        totalCountersCount += TEST_GROW_COUNTERS_COUNT;
+
+        flouka_copySnapshot(flouka_Ptr,
+                            snapshot_Ptr,
+                            flouka_getStatisticsSize(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF()),
+                            NULL COMMA()
+                            FILE_AND_LINE_FOR_REF());
+        free(message_Ptr);
+        messageBufferSize = flouka_deltaEncoderGetMaximumSize(deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+        message_Ptr = (uint8*) alloc(messageBufferSize);
+        if((0 == flouka_deltaEncoderEncode(deltaEncoder_Ptr, message_Ptr, messageBufferSize COMMA() FILE_AND_LINE_FOR_REF()))
+           || (FLOUKA_DELTA_MESSAGE_TYPE_FULL != test_decodeMessage(message_Ptr, valuesList_Ptr, &countersCount))
+           || (totalCountersCount != countersCount))
+        {
+            isPassed = FALSE;
+        }
+        for(i = TEST_COUNTERS_COUNT; i < totalCountersCount; i++)
+        {
+            if((((uint32*) snapshot_Ptr)[i] != valuesList_Ptr[i])
+               || (valuesList_Ptr[i] != (i + (i - TEST_COUNTERS_COUNT) / TEST_GROW_COUNTERS_COUNT)))
+            {
+                isPassed = FALSE;
+            }
+        }
+    }
+    if(TRUE == isPassed)
+    {
+        pthread_join(thread, NULL);
+    }
 
-        switch(request)
+    if((TRUE == isPassed)
+       && (0 != flouka_deltaEncoderEncode(deltaEncoder_Ptr, message_Ptr, messageBufferSize COMMA() FILE_AND_LINE_FOR_REF())))
+    {
+        test_decodeMessage(message_Ptr, valuesList_Ptr, &countersCount);
+        for(i = 0; i < totalCountersCount; i++)
         {
-            case 0:
-                printf("Termination requested\n");
-                return;
-            case 1:
-                printf("Information requested\n");
-                ASSERT(FALSE,
-                       "TEST FLOUKA: Client is expected to request the statistics",
-                       __FILE__,
-                       __LINE__);
-                break;
-            case 2:
-                printf("Statistics requested\n");
-                send(connectSocket,
-                     statisticsBuffer_Ptr,
-                     statisticsBufferSize,
-                     0);
-
-                /*
-                 * Increment/update the counters.
-                 */
-                FLOUKA_INCREMENT_COUNTER(COUNTER_ID_TRANSMISSION_FAILURE1);
-                FLOUKA_INCREASE_COUNTER(COUNTER_ID_TRANSMISSION_BYTES_COUNT1,
-                                      1000);
-
-                break;
-            default:
-                ASSERT(FALSE,
-                       "TEST FLOUKA: Invalid request received!!!",
-                       __FILE__,
-                       __LINE__);
-                break;
+            if(valuesList_Ptr[i] != flouka_getCounter(flouka_Ptr, i COMMA() FILE_AND_LINE_FOR_REF()))
+            {
+                isPassed = FALSE;
+            }
         }
+        isPassed = isPassed && (TEST_UPDATES_COUNT == valuesList_Ptr[0]);
+    }
+    else
+    {
+        isPassed = FALSE;
+    }
+
+    free(snapshot_Ptr);
+    free(valuesList_Ptr);
+    free(message_Ptr);
+    flouka_deltaEncoderDestroy(deltaEncoder_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    flouka_destroy(flouka_Ptr COMMA() FILE_AND_LINE_FOR_REF());
+    return (test_check(isPassed, "grow while serving"));
+}
+
+void test_flouka()
+{
+    flouka_server_s*  server_Ptr = NULL;
+    flouka_status_e   status;
+    uint16            listenPort;
+    uint32            rxConnectionFirstCounterID = 0;
+
+    listenPort = 4444;
+
+    /*
+     * The server answers all the clients (information, statistics, delta statistics, ...) from
+     * this thread, see flouka_request_e for the requests.
+     */
+    status = FLOUKA_SERVER_INIT(&server_Ptr,
+                                listenPort,
+                                100,
+                                alloc,
+                                free);
+    if(FLOUKA_STATUS_SUCCESS != status)
+    {
+        printf("Failed to listen on port (%d)\n",
+               listenPort);
+        return;
     }
+
+    /*
+     * The collectors on the same host may use the local socket instead of TCP.
+     */
+    if(FLOUKA_STATUS_SUCCESS != FLOUKA_SERVER_LISTEN_LOCAL(server_Ptr, "test_flouka"))
+    {
+        printf("Failed to listen on the local socket (test_flouka)\n");
+    }
+    if(FLOUKA_STATUS_SUCCESS != FLOUKA_SERVER_LISTEN_HTTP(server_Ptr, 4445))
+    {
+        printf("Failed to listen on the HTTP port (4445)\n");
+    }
+
+    /*
+     * Open a reception connection, its counters are reset and released with it.
+     */
+    if(FLOUKA_STATUS_SUCCESS != FLOUKA_ADD_FAMILY_INSTANCE((uint32) FAMILY_ID_RX_CONNECTIONS,
+                                                          "Connection 1",
+                                                          &rxConnectionFirstCounterID))
+    {
+        printf("Failed to open the reception connection (Connection 1)\n");
+    }
+
+    printf("Waiting for clients to connect on port (%d)...\n",
+           listenPort);
+
+    while(FLOUKA_STATUS_SUCCESS == FLOUKA_SERVER_POLL(server_Ptr, 1000))
+    {
+        /*
+         * Increment/update the counters.
+         */
+        FLOUKA_INCREMENT_COUNTER(COUNTER_ID_TRANSMISSION_FAILURE1);
+        FLOUKA_INCREASE_COUNTER(COUNTER_ID_TRANSMISSION_BYTES_COUNT1,
+                              1000);
+        FLOUKA_INCREASE_COUNTER(rxConnectionFirstCounterID + RX_CONNECTION_MEMBER_BYTES_COUNT,
+                              500);
+    }
+
+    FLOUKA_SERVER_DESTROY(server_Ptr);
 }